@@ -0,0 +1,77 @@
+#include "BufferPool.h"
+
+namespace TVMDecoder {
+
+void BufferPool::Preallocate(size_t count, size_t values) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    for (size_t i = 0; i < count; ++i) {
+        freeBuffers.emplace_back();
+        freeBuffers.back().reserve(GetSizeClass(values));
+        freeBuffers.back().resize(values);  // Touch the pages now rather than on the first decode
+    }
+}
+
+std::vector<double> BufferPool::Acquire(size_t values) {
+    std::vector<double> buffer;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        // Best fit, so small subsequences do not take the buffers sized for the largest
+        size_t best = freeBuffers.size();
+        for (size_t i = 0; i < freeBuffers.size(); ++i) {
+            if (freeBuffers[i].capacity() >= values &&
+                (best == freeBuffers.size() || freeBuffers[i].capacity() < freeBuffers[best].capacity())) {
+                best = i;
+            }
+        }
+        if (best != freeBuffers.size()) {
+            buffer.swap(freeBuffers[best]);
+            freeBuffers.erase(freeBuffers.begin() + best);
+            ++reuseCount;
+        }
+        else {
+            ++allocationCount;
+        }
+    }
+    if (buffer.capacity() < values) {
+        buffer.reserve(GetSizeClass(values));
+    }
+    buffer.resize(values);
+    return buffer;
+}
+
+void BufferPool::Release(std::vector<double>& buffer) {
+    if (buffer.capacity() == 0) return;
+    std::lock_guard<std::mutex> lock(poolMutex);
+    freeBuffers.emplace_back();
+    freeBuffers.back().swap(buffer);
+}
+
+size_t BufferPool::GetSizeClass(size_t values) {
+    size_t step = 1;
+    while (step * 16 <= values) step <<= 1;
+    return (values + step - 1) / step * step;
+}
+
+size_t BufferPool::GetFreeCount() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return freeBuffers.size();
+}
+
+size_t BufferPool::GetFreeBytes() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    size_t bytes = 0;
+    for (const auto& buffer : freeBuffers) bytes += buffer.capacity() * sizeof(double);
+    return bytes;
+}
+
+size_t BufferPool::GetAllocationCount() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return allocationCount;
+}
+
+size_t BufferPool::GetReuseCount() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return reuseCount;
+}
+
+} // namespace TVMDecoder
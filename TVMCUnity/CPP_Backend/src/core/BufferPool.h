@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace TVMDecoder {
+
+/**
+ * @brief BufferPool: A thread safe pool of decoded frame buffers. Decoders take their buffer from the pool when
+ *        they decode and hand it back when they are cleared, so the same few allocations are reused as playback
+ *        moves through the sequence instead of one allocation per subsequence. Buffers are allocated in size
+ *        classes, so a buffer also fits the next subsequence when it is slightly larger.
+ */
+class BufferPool {
+public:
+    /**
+     * @brief Preallocate: Fill the pool with buffers up front (e.g. sized from a sequence manifest).
+     * @param count: The number of buffers to allocate.
+     * @param values: The number of doubles in each buffer.
+     */
+    void Preallocate(size_t count, size_t values);
+
+    /**
+     * @brief Acquire: Take a buffer of the given size, reusing the smallest pooled buffer large enough. A new
+     *        buffer gets the capacity of the size's class.
+     * @param values: The number of doubles needed.
+     * @return A buffer with size() == values (contents unspecified).
+     */
+    std::vector<double> Acquire(size_t values);
+
+    /**
+     * @brief Release: Return a buffer to the pool.
+     * @param buffer: The buffer to return, left empty.
+     */
+    void Release(std::vector<double>& buffer);
+
+    /**
+     * @brief GetSizeClass: The capacity a buffer of the given size is allocated with, rounded up to one of 8
+     *        classes per power of two (at most 12.5% more than asked for).
+     */
+    static size_t GetSizeClass(size_t values);
+
+    // Getter functions
+    size_t GetFreeCount();
+    size_t GetFreeBytes();
+    size_t GetAllocationCount();  // Acquires no pooled buffer fit
+    size_t GetReuseCount();       // Acquires served from the pool
+
+private:
+    std::mutex poolMutex;
+    std::vector<std::vector<double>> freeBuffers;
+    size_t allocationCount = 0;
+    size_t reuseCount = 0;
+};
+
+} // namespace TVMDecoder
@@ -0,0 +1,58 @@
+#include "DecodedCache.h"
+#include "ByteSource.h"
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <sstream>
+
+namespace TVMDecoder {
+
+std::shared_ptr<Decoder> DecodedCache::FindOrInsert(const std::string& key, const std::shared_ptr<Decoder>& candidate) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    ++stats.lookups;
+    std::weak_ptr<Decoder>& entry = entries[key];
+    if (auto shared = entry.lock()) {
+        ++stats.hits;
+        return shared;
+    }
+    if (!candidate) {
+        entries.erase(key);
+        return nullptr;
+    }
+    entry = candidate;
+    if (entries.size() >= pruneAt) {
+        PruneLocked();
+    }
+    return candidate;
+}
+
+std::string DecodedCache::GetKey(const std::string& sequence, int subSequence) {
+    std::string path = sequence;
+    if (!TVMIO::IsUrl(sequence)) {
+        std::error_code error;
+        const std::filesystem::path canonical = std::filesystem::weakly_canonical(sequence, error);
+        if (!error) {
+            path = canonical.string();
+        }
+    }
+    std::ostringstream key;
+    key << path << '|' << subSequence << '|' << Decoder::kSolveIterations << '|' << Decoder::kSolveTolerance;
+    return key.str();
+}
+
+void DecodedCache::PruneLocked() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        it = it->second.expired() ? entries.erase(it) : std::next(it);
+    }
+    pruneAt = std::max<size_t>(64, entries.size() * 2);
+}
+
+DecodedCacheStats DecodedCache::GetStats() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    PruneLocked();
+    DecodedCacheStats current = stats;
+    current.entries = static_cast<int64_t>(entries.size());
+    return current;
+}
+
+} // namespace TVMDecoder
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "TVMDecoder.h"
+
+namespace TVMDecoder {
+
+/**
+ * @brief DecodedCacheStats: Counters of a DecodedCache.
+ */
+struct DecodedCacheStats {
+    int64_t lookups = 0;
+    int64_t hits = 0;     // Lookups served by a decoder another window holds, decoded or on its way
+    int64_t entries = 0;  // Distinct subsequences held by any window right now
+};
+
+/**
+ * @brief DecodedCache: The subsequences held by the playback instances of a context, so instances playing the same
+ *        sequence (at any offset) share one decoder per subsequence instead of each loading, solving and storing
+ *        its own. Entries are keyed by the sequence, the subsequence and the decode settings, and only refer to
+ *        their decoder: it lives as long as any window holds it, and its entry goes away with it. A decoder is
+ *        shared from its load on, its stages run once for whichever instance claims it first (Decoder::TryClaim)
+ *        and it is read only once decoded. Thread safe.
+ */
+class DecodedCache {
+public:
+    /**
+     * @brief FindOrInsert: Get the decoder of a subsequence from the window that holds it, or share a new one.
+     * @param key: The sequence, subsequence and decode settings (see GetKey).
+     * @param candidate: The decoder to share when no window holds the subsequence, nullptr to only look it up.
+     * @return The shared decoder, candidate when it was inserted, nullptr when nothing is shared and no candidate
+     *         was given.
+     */
+    std::shared_ptr<Decoder> FindOrInsert(const std::string& key, const std::shared_ptr<Decoder>& candidate);
+
+    /**
+     * @brief GetKey: The key of a subsequence (1-indexed) of a sequence, with the settings it is decoded with.
+     * @param sequence: The sequence's path or URL, made absolute so every spelling of a local path matches.
+     */
+    static std::string GetKey(const std::string& sequence, int subSequence);
+
+    DecodedCacheStats GetStats();
+
+private:
+    // Drop the entries whose decoder went away, the caller holds cacheMutex
+    void PruneLocked();
+
+    std::mutex cacheMutex;
+    std::unordered_map<std::string, std::weak_ptr<Decoder>> entries;
+    size_t pruneAt = 64;  // Prune when the map grows to this size
+    DecodedCacheStats stats;
+};
+
+} // namespace TVMDecoder
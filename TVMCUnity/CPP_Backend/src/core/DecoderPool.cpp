@@ -0,0 +1,96 @@
+#include "DecoderPool.h"
+
+namespace TVMDecoder {
+
+DecoderPool::DecoderPool(size_t maxFree, std::shared_ptr<BufferPool> buffers, std::shared_ptr<SolveCache> solveCache,
+                         std::shared_ptr<TopologyStore> topologies)
+    : maxFree(maxFree), bufferPool(std::move(buffers)), solveCache(std::move(solveCache)),
+      topologyStore(std::move(topologies)) {
+}
+
+DecoderPool::~DecoderPool() {
+    for (auto& slot : returned) {
+        delete slot.exchange(nullptr, std::memory_order_acquire);
+    }
+}
+
+std::shared_ptr<Decoder> DecoderPool::Acquire(const std::string& name) {
+    Collect();
+    std::unique_ptr<Decoder> decoder;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (!freeDecoders.empty()) {
+            decoder = std::move(freeDecoders.back());
+            freeDecoders.pop_back();
+            ++recycledCount;
+        }
+        else {
+            ++createdCount;
+        }
+    }
+    if (decoder) {
+        // Reset here rather than when it came back, on the worker that needs it
+        decoder->Reset(name);
+    }
+    else {
+        decoder = std::make_unique<Decoder>(name, bufferPool, solveCache, topologyStore);
+    }
+
+    // The pool may be gone by the time the decoder is dropped, it is freed then
+    std::weak_ptr<DecoderPool> pool = weak_from_this();
+    return std::shared_ptr<Decoder>(decoder.release(), [pool](Decoder* dropped) {
+        if (auto owner = pool.lock()) {
+            owner->Return(dropped);
+        }
+        else {
+            delete dropped;
+        }
+    });
+}
+
+void DecoderPool::Collect() {
+    for (auto& slot : returned) {
+        if (Decoder* decoder = slot.exchange(nullptr, std::memory_order_acquire)) {
+            Recycle(decoder);
+        }
+    }
+}
+
+void DecoderPool::Return(Decoder* decoder) {
+    for (auto& slot : returned) {
+        Decoder* empty = nullptr;
+        if (slot.load(std::memory_order_relaxed) == nullptr &&
+            slot.compare_exchange_strong(empty, decoder, std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+    Recycle(decoder);
+}
+
+void DecoderPool::Recycle(Decoder* decoder) {
+    std::unique_ptr<Decoder> returned(decoder);
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (freeDecoders.size() < maxFree) {
+            freeDecoders.push_back(std::move(returned));
+        }
+    }
+    // A decoder the pool has no room for is freed outside of the lock
+}
+
+size_t DecoderPool::GetFreeCount() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return freeDecoders.size();
+}
+
+size_t DecoderPool::GetCreatedCount() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return createdCount;
+}
+
+size_t DecoderPool::GetRecycledCount() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return recycledCount;
+}
+
+} // namespace TVMDecoder
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "BufferPool.h"
+#include "TVMDecoder.h"
+
+namespace TVMDecoder {
+
+/**
+ * @brief DecoderPool: A thread safe pool of decoders. A decoder handed out by Acquire comes back to the pool when
+ *        its last reference goes away instead of being freed, and the next Acquire resets and reuses it, so its
+ *        mesh, matrices and frame buffer are reused by the next subsequence instead of being freed and allocated
+ *        again at every subsequence boundary. Dropping the last reference never locks or frees: the decoder is
+ *        parked in a wait free slot and Collect takes it back later, so the render thread can drop decoders too.
+ */
+class DecoderPool : public std::enable_shared_from_this<DecoderPool> {
+public:
+    /**
+     * @brief DecoderPool: Constructor, create it with std::make_shared.
+     * @param maxFree: The most idle decoders kept, the ones returned beyond that are freed.
+     * @param buffers: The pool the decoders take their frame buffers from.
+     * @param solveCache: The solve cache the decoders use, if any.
+     * @param topologies: The store the decoders share their triangle lists through, if any.
+     */
+    DecoderPool(size_t maxFree, std::shared_ptr<BufferPool> buffers, std::shared_ptr<SolveCache> solveCache = nullptr,
+                std::shared_ptr<TopologyStore> topologies = nullptr);
+    ~DecoderPool();
+
+    DecoderPool(const DecoderPool&) = delete;
+    DecoderPool& operator=(const DecoderPool&) = delete;
+
+    /**
+     * @brief Acquire: Take an empty decoder, reusing an idle one when there is one.
+     * @param name: The name of the decoder.
+     * @return The decoder, it returns to the pool when the last copy of the pointer is dropped.
+     */
+    std::shared_ptr<Decoder> Acquire(const std::string& name);
+
+    /**
+     * @brief Collect: Take back the decoders dropped since the last call, freeing the ones beyond maxFree. Called
+     *        by Acquire, and by the owner's upkeep so dropped decoders do not wait for the next Acquire. Not from
+     *        the render thread.
+     */
+    void Collect();
+
+    // Getter functions
+    size_t GetFreeCount();
+    size_t GetCreatedCount();   // Decoders allocated
+    size_t GetRecycledCount();  // Acquires served by an idle decoder
+
+private:
+    // Park a decoder whose last reference went away for Collect, wait free. Recycled right away when every slot
+    // is taken
+    void Return(Decoder* decoder);
+
+    // Take back a dropped decoder
+    void Recycle(Decoder* decoder);
+
+    static constexpr size_t kReturnSlots = 32;  // Far more than the decoders of a window
+
+    std::atomic<Decoder*> returned[kReturnSlots] = {};
+    std::mutex poolMutex;
+    std::vector<std::unique_ptr<Decoder>> freeDecoders;
+    size_t maxFree;
+    size_t createdCount = 0;
+    size_t recycledCount = 0;
+    std::shared_ptr<BufferPool> bufferPool;
+    std::shared_ptr<SolveCache> solveCache;
+    std::shared_ptr<TopologyStore> topologyStore;
+};
+
+} // namespace TVMDecoder
@@ -0,0 +1,158 @@
+#include "DecoderRing.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace TVMDecoder {
+
+const char* GetSlotStateName(SlotState state) {
+    switch (state) {
+        case SlotState::Empty:    return "Empty";
+        case SlotState::Loading:  return "Loading";
+        case SlotState::Loaded:   return "Loaded";
+        case SlotState::Decoding: return "Decoding";
+        case SlotState::Ready:    return "Ready";
+    }
+    return "Unknown";
+}
+
+DecoderRing::DecoderRing(int capacity, int subSequenceCount, bool wraps)
+    : slots(std::clamp(capacity, 1, std::max(subSequenceCount, 1))),
+      moved(slots.size()),
+      subSequenceCount(subSequenceCount),
+      wraps(wraps) {
+}
+
+int DecoderRing::MoveWindow(int start, int step) {
+    if (slots.empty() || subSequenceCount <= 0) return 0;
+    const int capacity = GetCapacity();
+    // A window moving along its direction by less than its size keeps the slots of the subsequences it still holds
+    const int shift = this->step == step ? std::min(GetDistance(start), capacity) : 0;
+    windowStart = start;
+    this->step = step == 0 ? 1 : step;
+    head = (head + shift) % capacity;
+
+    int evicted = 0;
+    for (DecoderSlot& slot : slots) {
+        if (slot.state == SlotState::Empty) continue;
+        const int distance = GetDistance(slot.subSequence);
+        if (distance < capacity) {
+            moved[(head + distance) % capacity] = std::move(slot);
+        }
+        else {
+            ++evicted;
+        }
+        Release(slot);
+    }
+    slots.swap(moved);
+    return evicted;
+}
+
+int DecoderRing::SetCapacity(int capacity) {
+    capacity = std::clamp(capacity, 1, std::max(subSequenceCount, 1));
+    if (capacity == GetCapacity()) return 0;
+    std::vector<DecoderSlot> resized(static_cast<size_t>(capacity));
+    int evicted = 0;
+    for (DecoderSlot& slot : slots) {
+        if (slot.state == SlotState::Empty) continue;
+        const int distance = GetDistance(slot.subSequence);
+        if (distance < capacity) {
+            resized[distance] = std::move(slot);
+        }
+        else {
+            ++evicted;
+        }
+        Release(slot);
+    }
+    slots.swap(resized);
+    moved.assign(slots.size(), DecoderSlot());
+    head = 0;
+    return evicted;
+}
+
+void DecoderRing::SetSubSequenceCount(int subSequenceCount) {
+    // Without wrapping a subsequence's distance does not depend on the count, the slots stay where they are
+    if (wraps || subSequenceCount <= this->subSequenceCount) return;
+    this->subSequenceCount = subSequenceCount;
+}
+
+DecoderSlot* DecoderRing::GetSlot(int subSequence) {
+    if (slots.empty() || subSequence < 1 || subSequence > subSequenceCount) return nullptr;
+    const int distance = GetDistance(subSequence);
+    return distance < GetCapacity() ? &slots[(head + distance) % GetCapacity()] : nullptr;
+}
+
+DecoderSlot* DecoderRing::Find(int subSequence) {
+    DecoderSlot* slot = GetSlot(subSequence);
+    return slot && slot->state != SlotState::Empty && slot->subSequence == subSequence ? slot : nullptr;
+}
+
+const DecoderSlot* DecoderRing::Find(int subSequence) const {
+    return const_cast<DecoderRing*>(this)->Find(subSequence);
+}
+
+bool DecoderRing::SetState(DecoderSlot& slot, SlotState state) {
+    bool allowed = slot.state == state;
+    switch (slot.state) {
+        case SlotState::Empty:    allowed |= state == SlotState::Loading; break;
+        case SlotState::Loading:  allowed |= state == SlotState::Loaded || state == SlotState::Empty; break;
+        case SlotState::Loaded:   allowed |= state == SlotState::Decoding; break;
+        case SlotState::Decoding: allowed |= state == SlotState::Ready || state == SlotState::Loaded; break;
+        case SlotState::Ready:    break;
+    }
+    if (allowed) {
+        slot.state = state;
+    }
+    return allowed;
+}
+
+void DecoderRing::Release(DecoderSlot& slot) {
+    slot.subSequence = 0;
+    slot.state = SlotState::Empty;
+    slot.decoder.reset();
+    slot.bytes = 0;
+}
+
+void DecoderRing::ReleaseDecoders() {
+    for (DecoderSlot& slot : slots) {
+        slot.decoder.reset();
+    }
+}
+
+int DecoderRing::GetOccupiedCount() const {
+    return static_cast<int>(std::count_if(slots.begin(), slots.end(),
+                                          [](const DecoderSlot& slot) { return slot.state != SlotState::Empty; }));
+}
+
+int DecoderRing::GetDistance(int start, int step, int subSequence, int subSequenceCount, bool wraps) {
+    if (subSequenceCount <= 0) return 0;
+    const int stride = std::max(std::abs(step), 1);
+    const int offset = step < 0 ? start - subSequence : subSequence - start;
+    if (!wraps && offset < 0) return subSequenceCount;
+    const int distance = (offset % subSequenceCount + subSequenceCount) % subSequenceCount;
+    return distance % stride == 0 ? distance / stride : subSequenceCount;
+}
+
+int DecoderRing::GetSubSequenceAt(int start, int step, int distance, int subSequenceCount, bool wraps) {
+    if (subSequenceCount <= 0 || distance < 0) return 0;
+    const int64_t offset = static_cast<int64_t>(distance) * std::max(std::abs(step), 1);
+    if (offset >= subSequenceCount) return 0;
+    const int64_t signedOffset = step < 0 ? -offset : offset;
+    if (!wraps && (start + signedOffset < 1 || start + signedOffset > subSequenceCount)) return 0;
+    return static_cast<int>(((start - 1 + signedOffset) % subSequenceCount + subSequenceCount) % subSequenceCount) + 1;
+}
+
+int DecoderRing::GetSubSequence(int distance) const {
+    return distance < GetCapacity() ? GetSubSequenceAt(windowStart, step, distance, subSequenceCount, wraps) : 0;
+}
+
+int DecoderRing::GetWindowLength() const {
+    const int stride = std::max(std::abs(step), 1);
+    if (!wraps) {
+        // Up to the end of the sequence in the direction of the window
+        const int remaining = step < 0 ? windowStart - 1 : subSequenceCount - windowStart;
+        return std::clamp(remaining / stride + 1, 0, GetCapacity());
+    }
+    return std::min(GetCapacity(), (subSequenceCount + stride - 1) / stride);
+}
+
+} // namespace TVMDecoder
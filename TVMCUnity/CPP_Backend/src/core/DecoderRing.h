@@ -0,0 +1,167 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "TVMDecoder.h"
+
+namespace TVMDecoder {
+
+/**
+ * @brief SlotState: Where the subsequence in a DecoderRing slot is. A slot goes Empty -> Loading -> Loaded ->
+ *        Decoding -> Ready, a failed load goes back to Empty and a failed first decode stage back to Loaded.
+ *        Decoding lasts from the first decode stage until the last one, including the time between them.
+ *        Any slot goes back to Empty when its subsequence leaves the window.
+ */
+enum class SlotState {
+    Empty = 0,
+    Loading,
+    Loaded,
+    Decoding,
+    Ready
+};
+
+/**
+ * @brief GetSlotStateName: The state name used in logs.
+ */
+const char* GetSlotStateName(SlotState state);
+
+/**
+ * @brief DecoderSlot: A slot of a DecoderRing.
+ */
+struct DecoderSlot {
+    int subSequence = 0;  // 1-indexed, 0 while the slot is empty
+    SlotState state = SlotState::Empty;
+    std::shared_ptr<Decoder> decoder;
+    uint64_t bytes = 0;   // The decoder's resident bytes, measured after its load and each decode stage
+};
+
+/**
+ * @brief DecoderRing: The decoders of the playback window, a fixed number of slots indexed by how far a
+ *        subsequence is into the window, so finding a subsequence's decoder is O(1) and needs no allocation.
+ *        The window runs from its start in the direction of playback, every step subsequences (a step of -1 plays
+ *        backwards, a step of 3 skips two subsequences out of three) and wraps around the sequence, but a window
+ *        that skips stops before it would wrap past its start. The window of a sequence that does not wrap (a live
+ *        one, which grows at its end) stops at the first and last subsequence instead. Moving the window evicts the
+ *        subsequences that left it. Not thread safe, the owner serializes access.
+ */
+class DecoderRing {
+public:
+    DecoderRing() = default;
+
+    /**
+     * @brief DecoderRing: Allocate the slots, the window starts at subsequence 1.
+     * @param capacity: The number of slots (the window size), clamped to [1, subSequenceCount].
+     * @param subSequenceCount: The number of subsequences in the sequence, the window wraps around it.
+     * @param wraps: False to stop the window at the ends of the sequence.
+     */
+    DecoderRing(int capacity, int subSequenceCount, bool wraps = true);
+
+    /**
+     * @brief MoveWindow: Make a subsequence the start of the window, emptying the slots of subsequences that
+     *        left it.
+     * @param start: The first subsequence of the window (1-indexed).
+     * @param step: The distance between the window's subsequences in playback order, negative when playing
+     *        backwards.
+     * @return The number of slots emptied.
+     */
+    int MoveWindow(int start, int step = 1);
+
+    /**
+     * @brief SetCapacity: Grow or shrink the window, keeping the slots of the subsequences still in it. Allocates.
+     * @param capacity: The number of slots, clamped to [1, subSequenceCount].
+     * @return The number of slots emptied.
+     */
+    int SetCapacity(int capacity);
+
+    /**
+     * @brief SetSubSequenceCount: Grow a sequence that does not wrap, the subsequences in the window keep their
+     *        slots. Does not change the capacity.
+     * @param subSequenceCount: The new number of subsequences, not fewer than before.
+     */
+    void SetSubSequenceCount(int subSequenceCount);
+
+    /**
+     * @brief GetDistance: How many steps a subsequence is into a window, wrapping around the sequence unless
+     *        wraps is false.
+     * @return The distance, or subSequenceCount when the window's steps never reach the subsequence.
+     */
+    static int GetDistance(int start, int step, int subSequence, int subSequenceCount, bool wraps = true);
+
+    /**
+     * @brief GetSubSequenceAt: The subsequence a number of steps into a window, the inverse of GetDistance.
+     * @return The subsequence (1-indexed), or 0 when a skipping window would wrap past its start to get there, or
+     *         a window that does not wrap would leave the sequence.
+     */
+    static int GetSubSequenceAt(int start, int step, int distance, int subSequenceCount, bool wraps = true);
+
+    // The subsequence a number of steps into this window, 0 past its end
+    int GetSubSequence(int distance) const;
+
+    // The number of slots the window can use, fewer than the capacity when it skips through a short sequence or
+    // reaches the end of one that does not wrap
+    int GetWindowLength() const;
+
+    /**
+     * @brief GetSlot: The slot a subsequence uses, whether it is occupied or not.
+     * @param subSequence: The subsequence (1-indexed).
+     * @return The slot, or nullptr when the subsequence is outside of the window.
+     */
+    DecoderSlot* GetSlot(int subSequence);
+
+    /**
+     * @brief Find: The slot holding a subsequence.
+     * @param subSequence: The subsequence (1-indexed).
+     * @return The slot, or nullptr when the subsequence is not in the ring.
+     */
+    DecoderSlot* Find(int subSequence);
+    const DecoderSlot* Find(int subSequence) const;
+
+    /**
+     * @brief SetState: Move a slot along its state machine.
+     * @param slot: The slot.
+     * @param state: The new state.
+     * @return False, leaving the slot unchanged, when the state machine has no such transition.
+     */
+    static bool SetState(DecoderSlot& slot, SlotState state);
+
+    /**
+     * @brief Release: Empty a slot.
+     */
+    static void Release(DecoderSlot& slot);
+
+    /**
+     * @brief ReleaseDecoders: Drop the decoder references of every slot, keeping the slots. For a copy of the ring
+     *        that is no longer read, so it does not keep the decoders evicted since alive.
+     */
+    void ReleaseDecoders();
+
+    // Getter functions
+    int GetCapacity() const { return static_cast<int>(slots.size()); }
+    int GetWindowStart() const { return windowStart; }
+    int GetStep() const { return step; }
+    int GetSubSequenceCount() const { return subSequenceCount; }
+    bool Wraps() const { return wraps; }
+    int GetOccupiedCount() const;
+    const std::vector<DecoderSlot>& GetSlots() const { return slots; }
+    std::vector<DecoderSlot>& GetSlots() { return slots; }
+
+private:
+    int GetDistance(int subSequence) const { return GetDistance(windowStart, step, subSequence, subSequenceCount, wraps); }
+
+    std::vector<DecoderSlot> slots;
+    std::vector<DecoderSlot> moved;  // Scratch space of MoveWindow, always empty in between
+    int head = 0;                    // The slot of the window's first subsequence
+    int windowStart = 1;
+    int step = 1;
+    int subSequenceCount = 0;
+    bool wraps = true;
+};
+
+/**
+ * @brief ReleaseRingDecoders: TripleBuffer release of DecoderRing copies.
+ */
+struct ReleaseRingDecoders {
+    void operator()(DecoderRing& ring) const { ring.ReleaseDecoders(); }
+};
+
+} // namespace TVMDecoder
@@ -0,0 +1,238 @@
+#include "JobScheduler.h"
+#include "TVMLogger.h"
+#include <algorithm>
+
+namespace TVMDecoder {
+
+const char* GetJobTypeName(JobType type) {
+    switch (type) {
+        case JobType::Load:        return "Load";
+        case JobType::Laplacian:   return "Laplacian";
+        case JobType::Solve:       return "Solve";
+        case JobType::Reconstruct: return "Reconstruct";
+        case JobType::Discover:    return "Discover";
+    }
+    return "Unknown";
+}
+
+JobScheduler::JobScheduler(int workerCount) {
+    if (workerCount <= 0) {
+        // Leave a core to the render thread, decodes are CPU bound and more workers only split the same cores
+        const int cores = static_cast<int>(std::thread::hardware_concurrency());
+        workerCount = std::clamp(cores - 1, 1, 4);
+    }
+    for (int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&JobScheduler::Run, this);
+    }
+}
+
+JobScheduler::~JobScheduler() {
+    Stop();
+}
+
+void JobScheduler::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+        stats.cancelled += static_cast<int64_t>(queue.size());
+        queue.clear();
+        queuedCount.fill(0);
+    }
+    queueChanged.notify_all();
+    jobFinished.notify_all();
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void JobScheduler::SetStageLimits(JobType type, int maxRunning, int maxQueued) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        limits[static_cast<int>(type)] = {std::max(0, maxRunning), std::max(0, maxQueued)};
+    }
+    queueChanged.notify_all();
+}
+
+int JobScheduler::AddOwner() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    owners.push_back(nextOwner);
+    return nextOwner++;
+}
+
+void JobScheduler::RemoveOwner(int owner) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        owners.erase(std::remove(owners.begin(), owners.end(), owner), owners.end());
+    }
+    CancelIf(owner, [](int) { return true; });
+    WaitIdle(owner);
+}
+
+int JobScheduler::GetOwnerCount() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return static_cast<int>(owners.size());
+}
+
+bool JobScheduler::Schedule(int owner, int subSequence, JobType type, int64_t deadline, std::function<void()> work) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopping || std::find(owners.begin(), owners.end(), owner) == owners.end()) return false;
+        for (Job& job : queue) {
+            if (job.owner == owner && job.subSequence == subSequence && job.type == type) {
+                job.deadline = std::min(job.deadline, deadline);
+                ++stats.merged;
+                return false;
+            }
+        }
+        for (const Job& job : running) {
+            if (job.owner == owner && job.subSequence == subSequence && job.type == type) {
+                ++stats.merged;
+                return false;
+            }
+        }
+        queue.push_back({owner, subSequence, type, deadline, nextOrder++, std::move(work)});
+        ++queuedCount[static_cast<int>(type)];
+    }
+    queueChanged.notify_one();
+    return true;
+}
+
+int JobScheduler::CancelIf(int owner, const std::function<bool(int subSequence)>& predicate) {
+    int cancelled = 0;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        // Partitioned rather than removed, remove_if leaves the dropped jobs moved from and their types unspecified
+        auto it = std::stable_partition(queue.begin(), queue.end(), [&](const Job& job) {
+            return job.owner != owner || !predicate(job.subSequence);
+        });
+        for (auto dropped = it; dropped != queue.end(); ++dropped) {
+            --queuedCount[static_cast<int>(dropped->type)];
+        }
+        cancelled = static_cast<int>(queue.end() - it);
+        queue.erase(it, queue.end());
+        stats.cancelled += cancelled;
+    }
+    if (cancelled > 0) {
+        // Fewer jobs waiting in front of a stage may let held back jobs start
+        queueChanged.notify_all();
+        jobFinished.notify_all();
+    }
+    return cancelled;
+}
+
+bool JobScheduler::IsPending(int owner, int subSequence, JobType type) const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return IsPendingLocked(owner, subSequence, type);
+}
+
+bool JobScheduler::IsPendingLocked(int owner, int subSequence, JobType type) const {
+    auto matches = [&](const Job& job) { return job.owner == owner && job.subSequence == subSequence && job.type == type; };
+    return std::any_of(queue.begin(), queue.end(), matches) || std::any_of(running.begin(), running.end(), matches);
+}
+
+int JobScheduler::GetRunningCountLocked(int owner) const {
+    return static_cast<int>(std::count_if(running.begin(), running.end(), [owner](const Job& job) { return job.owner == owner; }));
+}
+
+bool JobScheduler::CanStartLocked(const Job& job) const {
+    const int type = static_cast<int>(job.type);
+    if (limits[type].maxRunning > 0 && runningCount[type] >= limits[type].maxRunning) {
+        return false;
+    }
+    // Hold the job back while the queue it feeds is full, what it is running now ends up there too
+    const int next = type + 1;
+    if (next < kJobTypeCount && limits[next].maxQueued > 0 &&
+        queuedCount[next] + runningCount[type] >= limits[next].maxQueued) {
+        return false;
+    }
+    return true;
+}
+
+void JobScheduler::Wait(int owner, int subSequence, JobType type) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    jobFinished.wait(lock, [&] { return stopping || !IsPendingLocked(owner, subSequence, type); });
+}
+
+void JobScheduler::WaitIdle(int owner) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    auto owned = [owner](const Job& job) { return job.owner == owner; };
+    jobFinished.wait(lock, [&] {
+        return stopping || (std::none_of(queue.begin(), queue.end(), owned) && std::none_of(running.begin(), running.end(), owned));
+    });
+}
+
+JobStats JobScheduler::GetStats() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    JobStats current = stats;
+    current.queued = static_cast<int64_t>(queue.size());
+    current.running = static_cast<int64_t>(running.size());
+    const double elapsed = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+    for (int type = 0; type < kJobTypeCount; ++type) {
+        StageStats& stage = current.stages[type];
+        stage.queued = queuedCount[type];
+        stage.running = runningCount[type];
+        stage.occupancy = elapsed > 0.0 ? stage.busyMicroseconds / elapsed : 0.0;
+    }
+    return current;
+}
+
+void JobScheduler::Run() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            // The queue only holds the few subsequences of the playback windows, a scan is cheaper than a heap
+            // that would have to be rebuilt whenever a merge moves a deadline or a stage frees up
+            auto next = queue.end();
+            int nextRunning = 0;
+            queueChanged.wait(lock, [&] {
+                if (stopping) return true;
+                next = queue.end();
+                for (auto it = queue.begin(); it != queue.end(); ++it) {
+                    if (!CanStartLocked(*it)) continue;
+                    if (next != queue.end() && it->deadline > next->deadline) continue;
+                    // On equal deadlines the owner with the fewest running jobs goes first, then the oldest job
+                    const int itRunning = next != queue.end() && it->owner == next->owner ? nextRunning : GetRunningCountLocked(it->owner);
+                    if (next == queue.end() || it->deadline < next->deadline || itRunning < nextRunning ||
+                        (itRunning == nextRunning && it->order < next->order)) {
+                        next = it;
+                        nextRunning = itRunning;
+                    }
+                }
+                return next != queue.end();
+            });
+            if (stopping) return;
+            job = std::move(*next);
+            queue.erase(next);
+            --queuedCount[static_cast<int>(job.type)];
+            ++runningCount[static_cast<int>(job.type)];
+            running.push_back({job.owner, job.subSequence, job.type, job.deadline, job.order, nullptr});
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            job.work();
+        } catch (const std::exception& e) {
+            LOG_WARN("[JobScheduler] ", GetJobTypeName(job.type), " job for subsequence ", job.subSequence,
+                     " failed: ", e.what());
+        }
+        const int64_t busy =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            running.erase(std::find_if(running.begin(), running.end(), [&](const Job& other) { return other.order == job.order; }));
+            --runningCount[static_cast<int>(job.type)];
+            StageStats& stage = stats.stages[static_cast<int>(job.type)];
+            stage.busyMicroseconds += busy;
+            ++stage.completed;
+            ++stats.completed;
+        }
+        // A finished job frees its stage, held back jobs may be able to start now
+        queueChanged.notify_all();
+        jobFinished.notify_all();
+    }
+}
+
+} // namespace TVMDecoder
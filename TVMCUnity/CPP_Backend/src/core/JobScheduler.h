@@ -0,0 +1,187 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TVMDecoder {
+
+/**
+ * @brief JobType: The pipeline stage a job runs for its subsequence. A subsequence goes through the stages in
+ *        order (parse the files, build the Laplacian, solve, reconstruct the frames), while different
+ *        subsequences can be in different stages at once. Discover is not a stage, it looks for the subsequences a
+ *        live encoder completed and is queued for the whole sequence (subsequence 0).
+ */
+enum class JobType {
+    Load = 0,
+    Laplacian,
+    Solve,
+    Reconstruct,
+    Discover
+};
+
+constexpr int kJobTypeCount = 5;
+
+/**
+ * @brief GetJobTypeName: The stage name used in logs.
+ */
+const char* GetJobTypeName(JobType type);
+
+/**
+ * @brief StageStats: Counters of one pipeline stage.
+ */
+struct StageStats {
+    int64_t queued = 0;            // Waiting in front of the stage
+    int64_t running = 0;
+    int64_t completed = 0;
+    int64_t busyMicroseconds = 0;  // Summed over the workers
+    double occupancy = 0.0;        // Workers busy in the stage on average since the scheduler started
+};
+
+/**
+ * @brief JobStats: Counters of a JobScheduler.
+ */
+struct JobStats {
+    int64_t queued = 0;     // Waiting for a worker (the queue depth)
+    int64_t running = 0;    // On a worker right now
+    int64_t completed = 0;
+    int64_t merged = 0;     // Requests folded into a job that was already queued or running
+    int64_t cancelled = 0;  // Queued jobs dropped before they ran
+    std::array<StageStats, kJobTypeCount> stages;
+};
+
+/**
+ * @brief JobScheduler: A pool of worker threads that runs pipeline stage jobs in deadline order. There is at most
+ *        one job per owner, subsequence and job type, a request for a job that is already queued or running is
+ *        merged into it (a queued job takes the earlier deadline). Queued jobs can be cancelled, running jobs always
+ *        finish. Stages can be bounded, so a slow stage holds its predecessors back instead of piling up work in
+ *        front of it. Several owners (the playback instances sharing the workers) can queue jobs at once, their
+ *        deadlines are compared as they are and jobs with the same deadline go to the owner with the fewest jobs
+ *        running, so instances at the same point of their windows share the workers evenly.
+ */
+class JobScheduler {
+public:
+    /**
+     * @brief JobScheduler: Start the workers.
+     * @param workerCount: The number of worker threads, 0 or less picks one from the hardware.
+     */
+    explicit JobScheduler(int workerCount);
+
+    /**
+     * @brief ~JobScheduler: Stop the workers.
+     */
+    ~JobScheduler();
+
+    JobScheduler(const JobScheduler&) = delete;
+    JobScheduler& operator=(const JobScheduler&) = delete;
+
+    /**
+     * @brief SetStageLimits: Bound a stage of the pipeline.
+     * @param type: The stage.
+     * @param maxRunning: The most jobs of the stage that run at once, 0 for no limit.
+     * @param maxQueued: The size of the queue in front of the stage, 0 for no limit. Jobs of the previous stage are
+     *        held back while this many jobs wait for the stage (counting the ones the previous stage is running).
+     */
+    void SetStageLimits(JobType type, int maxRunning, int maxQueued);
+
+    /**
+     * @brief AddOwner: Register an owner of jobs.
+     * @return The owner to pass to the calls below.
+     */
+    int AddOwner();
+
+    /**
+     * @brief RemoveOwner: Drop the queued jobs of an owner and wait for its running ones to finish. Jobs it schedules
+     *        from then on are ignored, so its running jobs can still schedule follow-up work. Not from a worker.
+     */
+    void RemoveOwner(int owner);
+
+    /**
+     * @brief Schedule: Queue a job unless the same job is already queued or running.
+     * @param owner: The owner of the job.
+     * @param subSequence: The subsequence the job works on.
+     * @param type: The job type.
+     * @param deadline: Lower deadlines run first, jobs with the same deadline run in the order they were queued.
+     * @param work: The job, exceptions it throws are logged.
+     * @return True if a new job was queued, false if the request was merged into an existing one.
+     */
+    bool Schedule(int owner, int subSequence, JobType type, int64_t deadline, std::function<void()> work);
+
+    /**
+     * @brief CancelIf: Drop the queued jobs of every subsequence of an owner the predicate selects.
+     * @param owner: The owner of the jobs.
+     * @param predicate: Called with each queued job's subsequence.
+     * @return The number of jobs dropped.
+     */
+    int CancelIf(int owner, const std::function<bool(int subSequence)>& predicate);
+
+    /**
+     * @brief IsPending: Check if a job is queued or running.
+     */
+    bool IsPending(int owner, int subSequence, JobType type) const;
+
+    /**
+     * @brief Wait: Block until a job is neither queued nor running (it finished or was cancelled).
+     */
+    void Wait(int owner, int subSequence, JobType type);
+
+    /**
+     * @brief WaitIdle: Block until no job of an owner is queued or running.
+     */
+    void WaitIdle(int owner);
+
+    /**
+     * @brief Stop: Drop the queued jobs and wait for the running ones to finish. Jobs scheduled from then on are
+     *        ignored, so running jobs can still schedule follow-up work while the owner shuts down.
+     */
+    void Stop();
+
+    JobStats GetStats() const;
+    int GetWorkerCount() const { return static_cast<int>(workers.size()); }
+    int GetOwnerCount() const;
+
+private:
+    struct Job {
+        int owner;
+        int subSequence;
+        JobType type;
+        int64_t deadline;
+        uint64_t order;
+        std::function<void()> work;
+    };
+
+    struct StageLimits {
+        int maxRunning = 0;
+        int maxQueued = 0;
+    };
+
+    void Run();
+    bool IsPendingLocked(int owner, int subSequence, JobType type) const;
+
+    // The number of running jobs of an owner
+    int GetRunningCountLocked(int owner) const;
+
+    // Check the stage limits allow a queued job to start
+    bool CanStartLocked(const Job& job) const;
+
+    mutable std::mutex queueMutex;
+    std::condition_variable queueChanged;  // A job was queued or the scheduler is stopping
+    std::condition_variable jobFinished;   // A job finished or was cancelled
+    std::vector<Job> queue;
+    std::vector<Job> running;  // The running jobs, without their work
+    uint64_t nextOrder = 0;
+    std::vector<int> owners;  // Registered and not removed
+    int nextOwner = 0;
+    bool stopping = false;
+    JobStats stats;
+    std::array<StageLimits, kJobTypeCount> limits;
+    std::array<int, kJobTypeCount> queuedCount{}, runningCount{};
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+};
+
+} // namespace TVMDecoder
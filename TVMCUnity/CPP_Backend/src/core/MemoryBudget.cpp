@@ -0,0 +1,59 @@
+#include "MemoryBudget.h"
+#include <algorithm>
+
+namespace TVMDecoder {
+
+MemoryBudget::MemoryBudget(uint64_t totalBytes) : totalBytes(totalBytes) {
+}
+
+int MemoryBudget::AddOwner() {
+    std::lock_guard<std::mutex> lock(budgetMutex);
+    owners.push_back({nextOwner, 0});
+    return nextOwner++;
+}
+
+void MemoryBudget::RemoveOwner(int owner) {
+    std::lock_guard<std::mutex> lock(budgetMutex);
+    owners.erase(std::remove_if(owners.begin(), owners.end(), [owner](const Owner& other) { return other.id == owner; }),
+                 owners.end());
+}
+
+uint64_t MemoryBudget::GetAllowance(int owner) const {
+    std::lock_guard<std::mutex> lock(budgetMutex);
+    if (owners.empty()) return totalBytes;
+    // Others keep what they reserve up to their share, what they reserve beyond it is theirs only until they shrink
+    const uint64_t share = totalBytes / owners.size();
+    uint64_t others = 0;
+    for (const Owner& other : owners) {
+        if (other.id != owner) {
+            others += std::min(other.reserved, share);
+        }
+    }
+    return totalBytes - std::min(others, totalBytes);
+}
+
+void MemoryBudget::Reserve(int owner, uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(budgetMutex);
+    for (Owner& other : owners) {
+        if (other.id == owner) {
+            other.reserved = bytes;
+            return;
+        }
+    }
+}
+
+uint64_t MemoryBudget::GetReservedBytes() const {
+    std::lock_guard<std::mutex> lock(budgetMutex);
+    uint64_t reserved = 0;
+    for (const Owner& owner : owners) {
+        reserved += owner.reserved;
+    }
+    return reserved;
+}
+
+int MemoryBudget::GetOwnerCount() const {
+    std::lock_guard<std::mutex> lock(budgetMutex);
+    return static_cast<int>(owners.size());
+}
+
+} // namespace TVMDecoder
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace TVMDecoder {
+
+/**
+ * @brief MemoryBudget: A memory budget shared by the playback instances playing at once. Every owner reserves what
+ *        its window holds, and may use the budget less what the others reserve up to their fair share (the budget
+ *        split evenly between the owners). An owner alone gets the whole budget, and one that needs less than its
+ *        share leaves the rest to the others; when they all need more, each shrinks to its share the next time it
+ *        fits its window. Thread safe.
+ */
+class MemoryBudget {
+public:
+    /**
+     * @brief MemoryBudget: Constructor
+     * @param totalBytes: The most bytes the owners' windows may hold together.
+     */
+    explicit MemoryBudget(uint64_t totalBytes);
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    /**
+     * @brief AddOwner: Register an owner, it starts with nothing reserved.
+     * @return The owner to pass to the calls below.
+     */
+    int AddOwner();
+
+    /**
+     * @brief RemoveOwner: Release an owner's reservation, the others may grow into it.
+     */
+    void RemoveOwner(int owner);
+
+    /**
+     * @brief GetAllowance: The bytes an owner may hold right now, at least its fair share.
+     */
+    uint64_t GetAllowance(int owner) const;
+
+    /**
+     * @brief Reserve: Record the bytes an owner holds, or is about to.
+     */
+    void Reserve(int owner, uint64_t bytes);
+
+    uint64_t GetTotalBytes() const { return totalBytes; }
+    uint64_t GetReservedBytes() const;  // Summed over the owners
+    int GetOwnerCount() const;
+
+private:
+    struct Owner {
+        int id;
+        uint64_t reserved;
+    };
+
+    uint64_t totalBytes;
+    mutable std::mutex budgetMutex;
+    std::vector<Owner> owners;
+    int nextOwner = 0;
+};
+
+} // namespace TVMDecoder
@@ -0,0 +1,76 @@
+#include "PlaybackClock.h"
+
+namespace TVMDecoder {
+
+void PlaybackClock::Play() {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    RebaseLocked();
+    playing = true;
+}
+
+void PlaybackClock::Pause() {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    RebaseLocked();
+    playing = false;
+}
+
+bool PlaybackClock::IsPlaying() const {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    return playing;
+}
+
+void PlaybackClock::SetRate(double newRate) {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    RebaseLocked();
+    rate = newRate;
+}
+
+double PlaybackClock::GetRate() const {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    return rate;
+}
+
+void PlaybackClock::SetTime(double seconds) {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    anchorTime = seconds;
+    anchorWall = Clock::now();
+    held = false;
+}
+
+double PlaybackClock::GetTime() const {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    return GetTimeLocked(Clock::now());
+}
+
+void PlaybackClock::Hold(double seconds) {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    anchorTime = seconds;
+    held = true;
+}
+
+void PlaybackClock::Release() {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    if (!held) return;
+    anchorWall = Clock::now();
+    held = false;
+}
+
+bool PlaybackClock::IsHeld() const {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    return held;
+}
+
+double PlaybackClock::GetTimeLocked(Clock::time_point now) const {
+    if (!playing || held) {
+        return anchorTime;
+    }
+    return anchorTime + rate * std::chrono::duration<double>(now - anchorWall).count();
+}
+
+void PlaybackClock::RebaseLocked() {
+    const Clock::time_point now = Clock::now();
+    anchorTime = GetTimeLocked(now);
+    anchorWall = now;
+}
+
+} // namespace TVMDecoder
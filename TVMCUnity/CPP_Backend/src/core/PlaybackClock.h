@@ -0,0 +1,56 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+
+namespace TVMDecoder {
+
+/**
+ * @brief PlaybackClock: The position of playback in seconds of the sequence, advancing with the wall clock at a
+ *        rate while it plays. Besides the caller's play and pause it can be held at a position, e.g. while the next
+ *        subsequence is still decoding, without forgetting whether it plays. Thread safe.
+ */
+class PlaybackClock {
+public:
+    void Play();
+    void Pause();
+    bool IsPlaying() const;
+
+    /**
+     * @brief SetRate: The seconds of the sequence played per second, negative plays backwards and 0 stands still.
+     */
+    void SetRate(double rate);
+    double GetRate() const;
+
+    /**
+     * @brief SetTime: Move to a position, releasing a hold.
+     * @param seconds: The position in seconds of the sequence.
+     */
+    void SetTime(double seconds);
+    double GetTime() const;
+
+    /**
+     * @brief Hold: Stop at a position until SetTime or Release, whether it plays is kept.
+     * @param seconds: See SetTime.
+     */
+    void Hold(double seconds);
+    void Release();
+    bool IsHeld() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // The position at a point in time, the caller holds clockMutex
+    double GetTimeLocked(Clock::time_point now) const;
+
+    // Restart advancing from the current position, before the rate or the play state changes
+    void RebaseLocked();
+
+    mutable std::mutex clockMutex;
+    bool playing = false;
+    bool held = false;
+    double rate = 1.0;
+    double anchorTime = 0.0;       // The position at anchorWall
+    Clock::time_point anchorWall;
+};
+
+} // namespace TVMDecoder
@@ -0,0 +1,22 @@
+#include "PlaybackContext.h"
+
+namespace TVMDecoder {
+
+PlaybackContext::PlaybackContext(int jobWorkers, uint64_t memoryBudget, std::shared_ptr<SolveCache> solveCache,
+                                 bool optimizeIndexOrder)
+    : bufferPool(std::make_shared<BufferPool>()), solveCache(std::move(solveCache)),
+      decodedCache(std::make_shared<DecodedCache>()), topologyStore(std::make_shared<TopologyStore>(optimizeIndexOrder)) {
+    if (memoryBudget > 0) {
+        this->memoryBudget = std::make_shared<MemoryBudget>(memoryBudget);
+    }
+    jobs = std::make_shared<JobScheduler>(jobWorkers);
+    // Decode is a pipeline (parse, Laplacian, solve, reconstruct) so different subsequences overlap I/O and CPU.
+    // The solve is the heavy stage, it leaves a worker free for the others, and the queues between the stages
+    // are bounded so half decoded subsequences (each holding its L_star or S_hat) can't pile up behind it
+    const int workers = jobs->GetWorkerCount();
+    jobs->SetStageLimits(JobType::Laplacian, 0, kStageQueueSize);
+    jobs->SetStageLimits(JobType::Solve, workers > 1 ? workers - 1 : 0, kStageQueueSize);
+    jobs->SetStageLimits(JobType::Reconstruct, 0, kStageQueueSize);
+}
+
+} // namespace TVMDecoder
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include "BufferPool.h"
+#include "DecodedCache.h"
+#include "JobScheduler.h"
+#include "MemoryBudget.h"
+#include "SolveCache.h"
+#include "TopologyStore.h"
+
+namespace TVMDecoder {
+
+/**
+ * @brief PlaybackContext: What the playback instances playing at once share: one pool of load and decode workers
+ *        (scheduled across the instances by deadline), one memory budget, the frame buffer pool, the solve cache, the
+ *        decoded subsequences of the sequences more than one of them plays and the triangle lists their decoders
+ *        share. Every PlaybackManager holds the context it was created with, so it lives until the last of them
+ *        is destroyed.
+ */
+class PlaybackContext {
+public:
+    static constexpr int kStageQueueSize = 2;  // Subsequences waiting in front of each decode stage
+
+    /**
+     * @brief PlaybackContext: Start the workers.
+     * @param jobWorkers: The number of threads loading and decoding the windows, 0 picks one from the hardware.
+     * @param memoryBudget: The most bytes the windows' decoders may hold together, 0 sizes every window by its
+     *        memLoad and decodeLoad instead.
+     * @param solveCache: Solved S_hat matrices kept on disk across launches, nullptr solves every decode.
+     * @param optimizeIndexOrder: Reorder the triangle lists (and the vertices) for the GPU's vertex caches.
+     */
+    explicit PlaybackContext(int jobWorkers = 0, uint64_t memoryBudget = 0, std::shared_ptr<SolveCache> solveCache = nullptr,
+                             bool optimizeIndexOrder = false);
+
+    PlaybackContext(const PlaybackContext&) = delete;
+    PlaybackContext& operator=(const PlaybackContext&) = delete;
+
+    const std::shared_ptr<JobScheduler>& GetJobs() const { return jobs; }
+    const std::shared_ptr<MemoryBudget>& GetMemoryBudget() const { return memoryBudget; }  // nullptr without a budget
+    const std::shared_ptr<BufferPool>& GetBufferPool() const { return bufferPool; }
+    const std::shared_ptr<SolveCache>& GetSolveCache() const { return solveCache; }
+    const std::shared_ptr<DecodedCache>& GetDecodedCache() const { return decodedCache; }
+    const std::shared_ptr<TopologyStore>& GetTopologyStore() const { return topologyStore; }
+
+private:
+    std::shared_ptr<BufferPool> bufferPool;
+    std::shared_ptr<SolveCache> solveCache;
+    std::shared_ptr<MemoryBudget> memoryBudget;
+    std::shared_ptr<DecodedCache> decodedCache;
+    std::shared_ptr<TopologyStore> topologyStore;
+    std::shared_ptr<JobScheduler> jobs;
+};
+
+} // namespace TVMDecoder
@@ -1,184 +1,1437 @@
-// DecoderManager.cpp
+// PlaybackManager.cpp
 
 #include "PlaybackManager.h"
 #include "TVMLogger.h"
 #include "TVMDecoder.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <chrono>
 #include <filesystem>
+#include <iomanip>
+#include <limits>
 #include <mutex>
+#include <sstream>
 
-PlaybackManager::PlaybackManager(const std::string& path, int memLoad, int decodeLoad, bool enableLogging){
+namespace {
+
+// The lower case extension of a path or URL, sequences are told apart by it before they are opened
+std::string GetExtension(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extension;
+}
+
+} // namespace
+
+PlaybackManager::PlaybackManager(const std::string& path, int memLoad, int decodeLoad, bool enableLogging,
+                                 uint64_t readaheadBytes, int jobWorkers, uint64_t memoryBudget,
+                                 std::shared_ptr<TVMDecoder::SolveCache> solveCache)
+    : PlaybackManager(path, memLoad, decodeLoad, enableLogging,
+                      std::make_shared<TVMDecoder::PlaybackContext>(jobWorkers, memoryBudget, std::move(solveCache)),
+                      readaheadBytes){
+}
+
+PlaybackManager::PlaybackManager(const std::string& path, int memLoad, int decodeLoad, bool enableLogging,
+                                 std::shared_ptr<TVMDecoder::PlaybackContext> context, uint64_t readaheadBytes,
+                                 bool waitForWindow, const LiveOptions& liveOptions)
+    : initStart(std::chrono::steady_clock::now()), memoryBudget(context->GetMemoryBudget()), context(context),
+      jobs(context->GetJobs()){
     TVMLogger::EnableLogging(enableLogging);
     if (path.empty()) {
-        LOG_ERROR("[DecoderManager] ❌ Provided path is empty!");
+        LOG_ERROR("[PlaybackManager] ❌ Provided path is empty!");
     }
     sequenceDirectory = path;
     subSequenceCount = 0;
     currentSubSequence = 0;
+    subSequenceLength = 0;
+    preLoad = memLoad;
+    decodeWindow = decodeLoad;
+    bufferPool = context->GetBufferPool();
+    decoderPool = std::make_shared<TVMDecoder::DecoderPool>(kPooledDecoders, bufferPool, context->GetSolveCache(),
+                                                             context->GetTopologyStore());
+    decodedCache = context->GetDecodedCache();
+    jobOwner = jobs->AddOwner();
+    if (memoryBudget) {
+        budgetOwner = memoryBudget->AddOwner();
+    }
 
-    if (std::filesystem::exists(sequenceDirectory) && std::filesystem::is_directory(sequenceDirectory)) {
-        for (const auto& entry : std::filesystem::directory_iterator(sequenceDirectory)) {
-            if (entry.is_directory()) {
-                subSequenceCount++;
-            }
-        }
+    // Only a sequence folder can still be growing, it is told apart without touching it
+    const bool remote = TVMIO::IsUrl(sequenceDirectory);
+    const std::string extension = GetExtension(sequenceDirectory);
+    live = liveOptions.enabled &&
+           (remote ? extension != ".tvmc" && extension != ".zip" : std::filesystem::is_directory(sequenceDirectory));
+    if (liveOptions.enabled && !live) {
+        LOG_WARN("[PlaybackManager] Live playback needs a sequence folder, playing ", path, " as a finished sequence");
+    }
+    if (live) {
+        // Only complete folders count, and a manifest of a sequence that is still growing would be out of date
+        liveLatency = std::max(liveOptions.latencySeconds, 0.0);
+        livePollInterval = std::chrono::milliseconds(std::max(liveOptions.pollIntervalMs, 1));
+        looping = false;
+    }
+    if (readaheadBytes > 0 && !remote) {
+        // Streamed sequences have no cache to warm, their preload window is fetched concurrently instead
+        readahead = std::make_unique<TVMIO::Readahead>(readaheadBytes);
+    }
+    if (memoryBudget) {
+        LOG_INFO("[PlaybackManager] Memory budget ", memoryBudget->GetTotalBytes() / (1024 * 1024), " MB shared by ",
+                 memoryBudget->GetOwnerCount(), " instances, the window grows as decoded sizes are measured");
     }
-    activeDecoders.clear();
     LOG_INFO("✅Sequence directory set: " + path);
-    for (int i = 1; i <= memLoad && i <= subSequenceCount; i++){
-        LoadSubSequence(i);
-        if (i <= decodeLoad) DecodeSubSequence(i);
+    if (!waitForWindow) {
+        // Opening a remote sequence takes round trips (its index, the manifest, a folder count), so even that runs
+        // on a worker, ahead of every other job. The render thread picks the first subsequence up once it is
+        // published
+        jobs->Schedule(jobOwner, 0, TVMDecoder::JobType::Discover, GetJobDeadline(0, TVMDecoder::JobType::Discover),
+                       [this] { OpenSequence(); });
+        LOG_INFO("[PlaybackManager] Opening the sequence in the background");
+        return;
+    }
+    OpenSequence();
+    const int first = currentSubSequence;
+    if (subSequenceCount <= 0) return;
+    // Wait for the first window so playback can start as soon as we return
+    jobs->WaitIdle(jobOwner);
+    // A subsequence shared with another instance is decoded by whichever instance claims a stage first. While the
+    // other one holds it, wait for the claim and catch up like Tick does
+    auto findPending = [this, first]() -> std::shared_ptr<TVMDecoder::Decoder> {
+        std::lock_guard<std::mutex> lock(activeListMutex);
+        const TVMDecoder::DecoderSlot* slot = activeDecoders.Find(first);
+        return slot && slot->state != TVMDecoder::SlotState::Ready ? slot->decoder : nullptr;
+    };
+    for (auto pending = findPending(); pending && initState == static_cast<int>(PlaybackInitState::Loading);
+         pending = findPending()) {
+        pending->WaitForClaim();
+        ScheduleWindow();
+        jobs->WaitIdle(jobOwner);
     }
-    currentSubSequence = 1;
-    if (activeDecoders.size() <= 0){
-        LOG_ERROR("[DecoderManager] ❌ Encoded sequence is empty!");
+    currentDecoder = FindDecoder(first);
+    if (currentDecoder && !currentDecoder->IsDecoded()) {
+        currentDecoder.reset();
     }
-    else {
-        subSequenceLength = activeDecoders.front()->GetTotalFrames();
+    if (activeDecoders.GetOccupiedCount() <= 0){
+        LOG_ERROR("[PlaybackManager] ❌ Encoded sequence is empty!");
+        initState = static_cast<int>(PlaybackInitState::Failed);
+    }
+    else if (!manifest) {
+        auto first = getCurrentDecoder();
+        subSequenceLength = first ? first->GetTotalFrames() : 0;
+    }
+}
+
+void PlaybackManager::OpenSequence(){
+    // Remote sequences are told apart by extension, local ones by their magic bytes
+    const bool remote = TVMIO::IsUrl(sequenceDirectory);
+    const std::string extension = GetExtension(sequenceDirectory);
+    const bool isFile = !remote && std::filesystem::is_regular_file(sequenceDirectory);
+    int count = 0;
+
+    if (live) {
+        source = std::make_shared<TVMIO::DirectorySource>(sequenceDirectory);
+    }
+    else if (remote ? extension == ".tvmc" : isFile && TVMIO::SequenceContainer::IsContainer(sequenceDirectory)) {
+        // Packed container: mapped (or range read) once, subsequences are read straight out of it
+        try {
+            container = std::make_shared<TVMIO::SequenceContainer>(sequenceDirectory);
+            count = container->GetSubSequenceCount();
+        } catch (const std::exception& e) {
+            LOG_ERROR("[PlaybackManager] ❌ Failed to open container: ", e.what());
+        }
+    }
+    else if (remote ? extension == ".zip" : isFile && TVMIO::ZipArchive::IsZip(sequenceDirectory)) {
+        // Zipped sequence: only the central directory is read now, entries are inflated per subsequence
+        try {
+            auto archive = std::make_shared<TVMIO::ZipArchive>(sequenceDirectory);
+            count = archive->GetSubSequenceCount();
+            source = archive;
+        } catch (const std::exception& e) {
+            LOG_ERROR("[PlaybackManager] ❌ Failed to open zip: ", e.what());
+        }
+    }
+    else if (remote || std::filesystem::is_directory(sequenceDirectory)) {
+        source = std::make_shared<TVMIO::DirectorySource>(sequenceDirectory);
+    }
+    if (!live) {
+        LoadManifest();
+    }
+    if (manifest) {
+        // Everything the manifest knows is available before any data is touched
+        count = manifest->GetSubSequenceCount();
+        subSequenceLength = static_cast<int>(manifest->GetSubSequence(0).frameCount);
+        frameStarts.assign(1, 0);
+        for (int i = 0; i < count; ++i) {
+            frameStarts.push_back(frameStarts.back() + manifest->GetSubSequence(i).frameCount);
+        }
+        const size_t bufferValues = static_cast<size_t>(manifest->GetMaxFrameCount()) * manifest->GetMaxVertexCount() * 3;
+        bufferPool->Preallocate(static_cast<size_t>(std::max(preLoad.load(), 1)), bufferValues);
+        LOG_INFO("[PlaybackManager] ✅ Manifest: ", count, " subsequences, ", manifest->GetTotalFrames(),
+                 " frames, preallocated ", bufferPool->GetFreeBytes() / 1024, " KB of frame buffers");
+    }
+    else if (source && count == 0 && !live) {
+        try {
+            count = source->GetSubSequenceCount();
+        } catch (const std::exception& e) {
+            LOG_ERROR("[PlaybackManager] ❌ Failed to list subsequences: ", e.what());
+        }
+    }
+    {
+        // The per subsequence state is set before the count, readers that see a count find it (and the source)
+        std::lock_guard<std::mutex> lock(activeListMutex);
+        // One slot per subsequence of the pre-load window, plus one for the subsequence entering it next, which a
+        // manual LoadSubSequence fetches ahead of the window. A budgeted window can grow to the whole sequence
+        activeDecoders = TVMDecoder::DecoderRing(memoryBudget ? count : preLoad + 1, count, !live);
+        decodedSizes.assign(static_cast<size_t>(count), 0);
+        decodeWork.assign(decodedSizes.size(), 0);
+        for (int subSequence = 1; subSequence <= count; ++subSequence) {
+            decodedKeys.push_back(TVMDecoder::DecodedCache::GetKey(sequenceDirectory, subSequence));
+        }
+        currentSubSequence = 1;
+        subSequenceCount = count;
+        opened = true;
+        if (count > 0) {
+            windowMoved = false;
+            windowStart = 1;
+            MoveWindowLocked();
+        }
+        else if (!live) {
+            initState = static_cast<int>(PlaybackInitState::Failed);
+        }
+    }
+    if (live) {
+        // A live sequence starts empty, this is its first poll: it finds the newest complete subsequence and
+        // starts the window there
+        {
+            std::lock_guard<std::mutex> lock(liveMutex);
+            nextLivePoll = std::chrono::steady_clock::now() + livePollInterval;
+        }
+        DiscoverSubSequences();
+        count = subSequenceCount;
+        LOG_INFO("[PlaybackManager] ✅ Live sequence, ", count, " complete subsequences so far");
+        if (count == 0) {
+            // Loading until the encoder completes a subsequence, the next upkeep of the window queues the poll
+            LOG_INFO("[PlaybackManager] Waiting for the encoder to complete the first subsequence");
+        }
+    }
+    if (count > 0) {
+        // Load the first window on the workers (streamed requests are bounded by the HTTP options), each
+        // subsequence is decoded as soon as it has arrived
+        ScheduleWindow();
+    }
+    else if (!live) {
+        LOG_ERROR("[PlaybackManager] ❌ Encoded sequence is empty!");
+    }
+}
+
+void PlaybackManager::LoadManifest() {
+    try {
+        if (container) {
+            manifest = std::make_shared<TVMIO::SequenceManifest>(TVMIO::SequenceManifest::FromContainer(*container));
+        }
+        else if (source && source->Contains(TVMIO::SequenceManifest::kFileName)) {
+            TVMIO::ByteView text = source->Read(TVMIO::SequenceManifest::kFileName);
+            manifest = std::make_shared<TVMIO::SequenceManifest>(
+                TVMIO::SequenceManifest::Parse(text.data, text.size, sequenceDirectory + "/" + TVMIO::SequenceManifest::kFileName));
+        }
+    } catch (const std::exception& e) {
+        // A bad manifest is not fatal, fall back to discovering the sequence
+        LOG_WARN("[PlaybackManager] Ignoring manifest: ", e.what());
+        manifest.reset();
+    }
+    if (manifest && manifest->GetSubSequenceCount() == 0) {
+        manifest.reset();
     }
-    preLoad = memLoad;
 }
 
 PlaybackManager::~PlaybackManager(){
-    activeDecoders.clear();
+    // The clock worker moves the window, stop it before the jobs go
+    {
+        std::lock_guard<std::mutex> lock(clockMutex);
+        clockStopping = true;
+    }
+    clockWake.notify_one();
+    if (clockThread.joinable()) {
+        clockThread.join();
+    }
+    // Drop this instance's jobs first and wait for the running ones, they use the decoders and sources below. The
+    // workers keep running for the other instances of the context
+    jobs->RemoveOwner(jobOwner);
+    if (memoryBudget) {
+        memoryBudget->RemoveOwner(budgetOwner);
+    }
+    LOG_INFO("[PlaybackManager] Decoders created ", decoderPool->GetCreatedCount(), ", recycled ",
+             decoderPool->GetRecycledCount(), ". Frame buffers allocated ", bufferPool->GetAllocationCount(),
+             ", reused ", bufferPool->GetReuseCount());
 }
 
 bool PlaybackManager::AdvanceSubSequence(){
-    std::lock_guard<std::mutex> lock(activeListMutex);
-    if (activeDecoders.empty()) {
-        LOG_ERROR("[DecoderManager] ❌ AdvanceSubSequence called with no active decoders!");
+    // Render thread: only the published decoders are looked at, no lock is taken
+    const TVMDecoder::DecoderRing& ready = readyDecoders.Read();
+    if (!currentDecoder && ready.GetOccupiedCount() == 0) {
+        LOG_ERROR("[PlaybackManager] ❌ AdvanceSubSequence called with no active decoders!");
         return false;
     }
 
-    int nextSubSequence = currentSubSequence + 1;
-    if (nextSubSequence > subSequenceCount){
-        nextSubSequence = 1;
+    // Continue at the window when it was requested somewhere else, otherwise play the following subsequence in
+    // the direction of playback
+    const int current = currentSubSequence;
+    const int nextSubSequence = windowStart != current
+        ? windowStart.load() : TVMDecoder::DecoderRing::GetSubSequenceAt(current, windowStep, 1, subSequenceCount, !live);
+    if (nextSubSequence == 0) {
+        // The newest subsequence of a live sequence, the encoder has not completed the next one yet
+        return false;
     }
 
-    // Check if the next subsequence is loaded and decoded
-    bool nextFound = false;
-    for (int i = 0; i < activeDecoders.size(); i++){
-        if (activeDecoders[i]->GetName() == std::to_string(nextSubSequence)){
-            if (activeDecoders[i]->IsDecoded()){
-                nextFound = true;
-                break;
+    // Check if the next subsequence is decoded
+    const TVMDecoder::DecoderSlot* next = ready.Find(nextSubSequence);
+    if (!next || next->state != TVMDecoder::SlotState::Ready) {
+        LOG_INFO("[PlaybackManager] Next Sequence Not Ready");
+        if (!stalled) {
+            stalled = true;
+            ++stallCounts[GetRateBucket(playbackRate)];
+        }
+        return false;
+    }
+    stalled = false;
+    LOG_INFO("Advancing subSequence!");
+    currentDecoder = next->decoder;
+    currentSubSequence = nextSubSequence;
+
+    // Move the window along, the eviction and the loads it needs happen on the next Tick (or manual load/decode).
+    // Without the lock: the flag is set after the start, so a move that overwrote the start leaves it set
+    windowStart = nextSubSequence;
+    windowMoved = true;
+    return true;
+}
+
+bool PlaybackManager::ApplyWindowMove(){
+    // A new rate or decode speed changes the window's direction or stride, which re-homes the window like a move
+    const int step = GetPlaybackStep();
+    {
+        std::lock_guard<std::mutex> lock(activeListMutex);
+        if (step != windowStep) {
+            LOG_INFO("[PlaybackManager] Window step ", windowStep.load(), " -> ", step);
+            windowStep = step;
+            windowMoved = true;
+        }
+        if (!windowMoved.exchange(false)) return false;
+        MoveWindowLocked();
+    }
+    ScheduleWindow();
+    return true;
+}
+
+void PlaybackManager::RequestWindow(int subSequence){
+    if (subSequence < 1 || subSequence > subSequenceCount){
+        LOG_ERROR("[PlaybackManager] ❌ SubSequence Out Of Range");
+        return;
+    }
+    {
+        // The render thread and the clock worker can both move the window, the start, the step and the ring
+        // change together under the lock so the last move wins everywhere
+        std::lock_guard<std::mutex> lock(activeListMutex);
+        windowMoved = false;
+        windowStart = subSequence;
+        MoveWindowLocked();
+    }
+    ScheduleWindow();
+}
+
+void PlaybackManager::MoveWindowLocked(){
+    const int start = windowStart;
+
+    // Cancel the queued work of subsequences that left the window, running jobs finish and are dropped below. A
+    // queued Discover job (subsequence 0) is for the whole sequence and stays
+    const int window = GetPreloadWindow();
+    const int cancelled = jobs->CancelIf(jobOwner, [this, window](int queued) { return queued > 0 && GetWindowDistance(queued) >= window; });
+    if (cancelled > 0) {
+        LOG_INFO("[PlaybackManager] Cancelled ", cancelled, " jobs outside of the window");
+    }
+
+    // Clean up decoders, the render thread keeps its own reference to the one it is playing
+    const int evicted = activeDecoders.MoveWindow(start, windowStep);
+    if (evicted > 0) {
+        LOG_INFO("[PlaybackManager] Removed ", evicted, " decoders outside of the window");
+    }
+    ApplyMemoryBudget();
+    CountCacheLookups();
+    PublishReadyDecoders();
+}
+
+int PlaybackManager::Seek(int64_t globalFrame){
+    if (subSequenceCount <= 0) return -1;
+    int target = 1, targetFrame = 0;
+    LocateFrame(globalFrame, target, targetFrame);
+
+    // Scrubbing within one subsequence keeps the window, moving to another cancels what was queued for the old one
+    if (target != windowStart) {
+        RequestWindow(target);
+    }
+
+    // Land on the target when it is decoded, otherwise on the decoded frame nearest to it
+    const int64_t wanted = GetSubSequenceStartFrame(target) + targetFrame;
+    const TVMDecoder::DecoderRing& ready = readyDecoders.Read();
+    std::shared_ptr<TVMDecoder::Decoder> nearest = currentDecoder;
+    int nearestSubSequence = currentSubSequence;
+    auto distanceTo = [&](int subSequence, const TVMDecoder::Decoder& decoder) {
+        const int64_t start = GetSubSequenceStartFrame(subSequence);
+        const int64_t end = start + std::max(decoder.GetTotalFrames(), 1) - 1;
+        return wanted < start ? start - wanted : wanted > end ? wanted - end : 0;
+    };
+    int64_t nearestDistance = nearest ? distanceTo(nearestSubSequence, *nearest) : std::numeric_limits<int64_t>::max();
+    for (const TVMDecoder::DecoderSlot& slot : ready.GetSlots()) {
+        if (slot.state != TVMDecoder::SlotState::Ready) continue;
+        const int64_t distance = distanceTo(slot.subSequence, *slot.decoder);
+        if (distance < nearestDistance || (distance == nearestDistance && slot.subSequence == target)) {
+            nearest = slot.decoder;
+            nearestSubSequence = slot.subSequence;
+            nearestDistance = distance;
+        }
+    }
+    if (!nearest) return -1;
+    currentDecoder = nearest;
+    currentSubSequence = nearestSubSequence;
+    const int64_t frame = wanted - GetSubSequenceStartFrame(nearestSubSequence);
+    return static_cast<int>(std::clamp<int64_t>(frame, 0, std::max(nearest->GetTotalFrames(), 1) - 1));
+}
+
+void PlaybackManager::LocateFrame(int64_t globalFrame, int& subSequence, int& frame) const {
+    const int64_t total = GetTotalFrameCount();
+    globalFrame = std::clamp<int64_t>(globalFrame, 0, std::max<int64_t>(total - 1, 0));
+    if (opened && !frameStarts.empty()) {
+        subSequence = static_cast<int>(std::upper_bound(frameStarts.begin(), frameStarts.end(), globalFrame) - frameStarts.begin());
+        subSequence = std::clamp(subSequence, 1, subSequenceCount.load());
+    }
+    else {
+        subSequence = subSequenceLength > 0 ? static_cast<int>(std::min<int64_t>(globalFrame / subSequenceLength + 1, subSequenceCount)) : 1;
+    }
+    frame = static_cast<int>(globalFrame - GetSubSequenceStartFrame(subSequence));
+}
+
+int64_t PlaybackManager::GetSubSequenceStartFrame(int subSequence) const {
+    subSequence = std::clamp(subSequence, 1, std::max(subSequenceCount.load(), 1));
+    if (opened && !frameStarts.empty()) {
+        return frameStarts[subSequence - 1];
+    }
+    return static_cast<int64_t>(subSequence - 1) * subSequenceLength;
+}
+
+int PlaybackManager::Tick(){
+    // Take the latest window even when not advancing, so the render thread's copy lets go of evicted decoders
+    readyDecoders.Read();
+
+    // The clock worker keeps the window scheduled once it runs
+    if (clockActive || ApplyWindowMove()) {
+        const TVMDecoder::JobStats stats = jobs->GetStats();
+        return static_cast<int>(stats.queued + stats.running);
+    }
+    return ScheduleWindow();
+}
+
+void PlaybackManager::Play(){
+    clock.Play();
+    WakeClock();
+}
+
+void PlaybackManager::Pause(){
+    clock.Pause();
+    if (clockActive) {
+        WakeClock();
+    }
+}
+
+void PlaybackManager::SetPlaybackRate(float rate){
+    playbackRate = rate;
+    clock.SetRate(rate);
+    if (clockActive) {
+        WakeClock();
+    }
+}
+
+void PlaybackManager::SetLooping(bool loop){
+    // A live sequence has no end to wrap around yet
+    looping = loop && !live;
+    if (clockActive) {
+        WakeClock();
+    }
+}
+
+void PlaybackManager::SetLiveLatency(double seconds){
+    liveLatency = std::max(seconds, 0.0);
+    if (clockActive) {
+        WakeClock();
+    }
+}
+
+double PlaybackManager::GetLiveLatency() const {
+    if (!live) return 0.0;
+    return std::max(GetTotalFrameCount() / GetClockFrameRate() - clock.GetTime(), 0.0);
+}
+
+void PlaybackManager::SetPlaybackTime(double seconds){
+    clock.SetTime(seconds);
+    clockJumped = true;
+    if (clockActive) {
+        WakeClock();
+    }
+}
+
+void PlaybackManager::SetFrameRate(float frameRate){
+    // Keep the frame the clock is at
+    const double frame = clock.GetTime() * GetClockFrameRate();
+    frameRateOverride = std::max(frameRate, 0.0f);
+    SetPlaybackTime(frame / GetClockFrameRate());
+}
+
+double PlaybackManager::GetClockFrameRate() const {
+    if (frameRateOverride > 0.0f) return frameRateOverride;
+    return GetFrameRate() > 0.0f ? GetFrameRate() : kDefaultFrameRate;
+}
+
+bool PlaybackManager::GetFrameForTime(double seconds, int& subSequence, int& frame){
+    subSequence = 0;
+    frame = 0;
+    if (subSequenceCount <= 0) return false;
+    const int64_t globalFrame = GetFrameAtTime(seconds);
+    int target = 1, targetFrame = 0;
+    LocateFrame(globalFrame, target, targetFrame);
+
+    // Render thread: only the published decoders are looked at, no lock is taken
+    const TVMDecoder::DecoderSlot* slot = readyDecoders.Read().Find(target);
+    const bool found = slot && slot->state == TVMDecoder::SlotState::Ready;
+    if (found) {
+        currentDecoder = slot->decoder;
+        currentSubSequence = target;
+    }
+    if (!currentDecoder) return false;
+    // Not decoded yet, the current subsequence shows its frame nearest to the time
+    subSequence = currentSubSequence;
+    const int64_t last = std::max(currentDecoder->GetTotalFrames(), 1) - 1;
+    int64_t local = globalFrame - GetSubSequenceStartFrame(subSequence);
+    if (looping) {
+        // Held at the end of the sequence the time wraps to its start, which is nearer from the other side
+        const int64_t total = GetTotalFrameCount();
+        auto outside = [last](int64_t f) { return f < 0 ? -f : f > last ? f - last : 0; };
+        if (outside(local + total) < outside(local)) local += total;
+        else if (outside(local - total) < outside(local)) local -= total;
+    }
+    frame = static_cast<int>(std::clamp<int64_t>(local, 0, last));
+    return found;
+}
+
+int64_t PlaybackManager::GetFrameAtTime(double seconds) const {
+    const int64_t total = GetTotalFrameCount();
+    if (total <= 0) return 0;
+    const int64_t frame = static_cast<int64_t>(std::floor(seconds * GetClockFrameRate()));
+    return looping ? (frame % total + total) % total : std::clamp<int64_t>(frame, 0, total - 1);
+}
+
+int64_t PlaybackManager::GetSubSequenceEndFrame(int subSequence) const {
+    return subSequence < subSequenceCount ? GetSubSequenceStartFrame(subSequence + 1) : GetTotalFrameCount();
+}
+
+void PlaybackManager::WakeClock(){
+    std::lock_guard<std::mutex> lock(clockMutex);
+    clockChanged = true;
+    if (!clockThread.joinable() && (subSequenceCount > 0 || live) && !clockStopping) {
+        clockActive = true;
+        clockThread = std::thread([this] { RunClock(); });
+    }
+    clockWake.notify_one();
+}
+
+void PlaybackManager::RunClock(){
+    std::unique_lock<std::mutex> lock(clockMutex);
+    while (!clockStopping) {
+        clockChanged = false;
+        lock.unlock();
+        const auto sleep = UpdateClock();
+        lock.lock();
+        clockWake.wait_for(lock, sleep, [this] { return clockStopping || clockChanged; });
+    }
+}
+
+std::chrono::steady_clock::duration PlaybackManager::UpdateClock(){
+    using TVMDecoder::DecoderRing;
+    // The upkeep the render thread's Tick does without the clock
+    if (!ApplyWindowMove()) {
+        ScheduleWindow();
+    }
+    const int64_t total = GetTotalFrameCount();
+    if (total <= 0) return kClockInterval;
+    const double frameRate = GetClockFrameRate();
+    const double duration = total / frameRate;
+    auto isDecoded = [this](int subSequence) {
+        std::lock_guard<std::mutex> lock(activeListMutex);
+        const TVMDecoder::DecoderSlot* slot = activeDecoders.Find(subSequence);
+        return slot && slot->state == TVMDecoder::SlotState::Ready;
+    };
+
+    if (live && clock.GetRate() > 0.0 && clock.IsPlaying() && clockSubSequence != 0) {
+        // Fell behind the newest subsequence by more than the target and a subsequence, catch up to the target.
+        // Closer than a subsequence and the time to decode one the clock would only wait for the encoder again
+        const double subSequenceTime = subSequenceLength / frameRate;
+        const double produceTime = (GetAverageLoadMs() + GetAverageDecodeMs()) / 1000.0;
+        const double target = std::max(liveLatency.load(), subSequenceTime + produceTime);
+        const double behind = duration - clock.GetTime();
+        if (behind > target + subSequenceTime) {
+            LOG_INFO("[PlaybackManager] Live: ", behind, " s behind the newest subsequence, jumping to ", target, " s");
+            clock.SetTime(duration - target);
+            clockJumped = true;
+            clockAtTail = false;
+            ++liveSkips;
+        }
+    }
+
+    double time = clock.GetTime();
+    if (clockJumped.exchange(false) || clockSubSequence == 0) {
+        // Moved by the caller (or just started), play on from the subsequence at the new time once it is decoded
+        const double moved = looping ? time - std::floor(time / duration) * duration : std::clamp(time, 0.0, duration);
+        if (moved != time) {
+            time = moved;
+            clock.SetTime(time);
+        }
+        int frame = 0;
+        LocateFrame(GetFrameAtTime(time), clockSubSequence, frame);
+        if (clockSubSequence != windowStart) {
+            RequestWindow(clockSubSequence);
+        }
+        clockStalled = !isDecoded(clockSubSequence);
+        if (clockStalled) {
+            clock.Hold(time);
+        }
+    }
+
+    const double rate = clock.GetRate();
+    const int direction = rate < 0.0 ? -1 : rate > 0.0 ? 1 : 0;
+    double start = GetSubSequenceStartFrame(clockSubSequence) / frameRate;
+    double end = GetSubSequenceEndFrame(clockSubSequence) / frameRate;
+    if (direction > 0 ? time >= end : direction < 0 && time <= start) {
+        // The clock reached the end of its subsequence in the direction of playback, the window steps over the
+        // subsequences a fast rate skips
+        const int next = DecoderRing::GetSubSequenceAt(clockSubSequence, direction * std::abs(windowStep.load()), 1,
+                                                       subSequenceCount, !live);
+        if (next == 0 || (direction > 0 ? next <= clockSubSequence : next >= clockSubSequence)) {
+            if (live && direction > 0) {
+                // The newest subsequence of a live sequence, wait for the encoder to complete the next one
+                if (!clockAtTail) {
+                    LOG_INFO("[PlaybackManager] Clock waiting for the encoder after subsequence ", clockSubSequence);
+                    clockAtTail = true;
+                }
+                clock.Hold(end);
+                return kClockInterval;
             }
-            else{
-                LOG_INFO("[DecoderManager] Next Sequence Not Decoded");
-                return false;
+            if (!looping) {
+                clock.Pause();
+                clock.SetTime(direction > 0 ? end : start);
+                return kClockInterval;
             }
         }
+        if (!isDecoded(next)) {
+            if (!clockStalled) {
+                LOG_INFO("[PlaybackManager] Clock waiting for subsequence ", next);
+                clockStalled = true;
+                // Decoding a subsequence the encoder just completed is part of the live latency, not a stall
+                if (!clockAtTail) {
+                    ++stallCounts[GetRateBucket(static_cast<float>(rate))];
+                }
+            }
+            clock.Hold(direction > 0 ? end : start);
+            return kClockInterval;
+        }
+        // Carry the time played past the boundary into the next subsequence, a skipped or wrapped one is entered
+        // at its edge
+        const double overshoot = clock.IsHeld() ? 0.0 : std::max(direction > 0 ? time - end : start - time, 0.0);
+        start = GetSubSequenceStartFrame(next) / frameRate;
+        end = GetSubSequenceEndFrame(next) / frameRate;
+        time = direction > 0 ? std::min(start + overshoot, end) : std::max(std::nextafter(end, start) - overshoot, start);
+        clock.SetTime(time);
+        clockStalled = false;
+        clockAtTail = false;
+        clockSubSequence = next;
+        RequestWindow(next);
+    }
+    else if (clockStalled && isDecoded(clockSubSequence)) {
+        clockStalled = false;
+        clock.Release();
+    }
+
+    // Sleep until the next boundary, or the next upkeep of the window
+    if (direction == 0 || !clock.IsPlaying() || clock.IsHeld()) return kClockInterval;
+    const double untilBoundary = std::max(direction > 0 ? (end - time) / rate : (time - start) / -rate, 0.0);
+    const auto boundary = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(untilBoundary));
+    return std::min<std::chrono::steady_clock::duration>(boundary, kClockInterval);
+}
+
+void PlaybackManager::PublishReadyDecoders(){
+    // Called under activeListMutex, which also serializes the writers of the triple buffer. The slots are copied
+    // into a buffer of the same size, so this does not allocate
+    readyDecoders.GetWriteBuffer() = activeDecoders;
+    readyDecoders.Publish();
+    UpdateInitState();
+}
+
+void PlaybackManager::UpdateInitState(){
+    const int state = initState;
+    if (state == static_cast<int>(PlaybackInitState::Ready) || state == static_cast<int>(PlaybackInitState::Failed)) return;
+    if (state == static_cast<int>(PlaybackInitState::Loading)) {
+        const TVMDecoder::DecoderSlot* first = activeDecoders.Find(currentSubSequence);
+        if (!first || first->state != TVMDecoder::SlotState::Ready) return;
+        if (subSequenceLength == 0) {
+            subSequenceLength = first->decoder->GetTotalFrames();
+        }
+        firstFrameMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - initStart).count();
+        initState = static_cast<int>(PlaybackInitState::FirstFrame);
+        if (live) {
+            // The time playback starts at is only known with the subsequence length, move the clock there
+            clock.SetTime(GetSubSequenceStartFrame(currentSubSequence) / GetClockFrameRate());
+            clockJumped = true;
+        }
+        LOG_INFO("[PlaybackManager] ✅ First frame ready after ", GetTimeToFirstFrameMs(), " ms");
+    }
+    const int window = std::min(GetDecodeWindow(), activeDecoders.GetWindowLength());
+    for (int distance = 0; distance < window; ++distance) {
+        const TVMDecoder::DecoderSlot* slot = activeDecoders.Find(activeDecoders.GetSubSequence(distance));
+        if (!slot || slot->state != TVMDecoder::SlotState::Ready) return;
+    }
+    initState = static_cast<int>(PlaybackInitState::Ready);
+}
+
+double PlaybackManager::GetTimeToFirstFrameMs() const {
+    const int64_t microseconds = firstFrameMicroseconds;
+    return microseconds < 0 ? -1.0 : microseconds / 1000.0;
+}
+
+int PlaybackManager::ScheduleWindow(){
+    // Free the decoders dropped since the last upkeep, the render thread only parks the ones it drops
+    decoderPool->Collect();
+    ScheduleDiscovery();
+    if (subSequenceCount <= 0) return 0;
+    if (memoryBudget) {
+        // Decodes that finished since the last call measured new sizes, the window may fit more or fewer now
+        std::lock_guard<std::mutex> lock(activeListMutex);
+        ApplyMemoryBudget();
+        CountCacheLookups();
+    }
+    bool shrank = false;
+    {
+        // Other instances sharing decoders with this window may have loaded or decoded them since the last call
+        std::lock_guard<std::mutex> lock(activeListMutex);
+        bool ready = false;
+        for (TVMDecoder::DecoderSlot& slot : activeDecoders.GetSlots()) {
+            ready |= SyncSlot(slot);
+        }
+        if (ready) {
+            PublishReadyDecoders();
+        }
+        shrank = TuneWindows();
+    }
+    if (shrank) {
+        const int window = GetPreloadWindow();
+        jobs->CancelIf(jobOwner, [this, window](int queued) { return queued > 0 && GetWindowDistance(queued) >= window; });
+    }
+    const int start = windowStart;
+    const int step = windowStep;
+    const int window = GetPreloadWindow();
+    for (int distance = 0; distance < window; distance++){
+        const int subSequence = TVMDecoder::DecoderRing::GetSubSequenceAt(start, step, distance, subSequenceCount, !live);
+        if (subSequence == 0) break;
+        auto decoder = FindDecoder(subSequence);
+        if (!decoder) {
+            jobs->Schedule(jobOwner, subSequence, TVMDecoder::JobType::Load, GetJobDeadline(distance, TVMDecoder::JobType::Load),
+                           [this, subSequence] { RunLoad(subSequence); });
+        }
+        else {
+            ScheduleNextStage(subSequence);
+        }
+    }
+    const TVMDecoder::JobStats stats = jobs->GetStats();
+    return static_cast<int>(stats.queued + stats.running);
+}
+
+void PlaybackManager::ScheduleNextStage(int subSequence){
+    const int distance = GetWindowDistance(subSequence);
+    if (distance >= GetDecodeWindow()) return;
+    auto decoder = FindDecoder(subSequence);
+    TVMDecoder::JobType next;
+    if (decoder && GetNextStage(decoder->GetStage(), next)) {
+        jobs->Schedule(jobOwner, subSequence, next, GetJobDeadline(distance, next), [this, subSequence, next] { RunStage(subSequence, next); });
+    }
+}
+
+bool PlaybackManager::GetNextStage(TVMDecoder::DecodeStage stage, TVMDecoder::JobType& type){
+    switch (stage) {
+        case TVMDecoder::DecodeStage::Loaded:         type = TVMDecoder::JobType::Laplacian; return true;
+        case TVMDecoder::DecodeStage::LaplacianBuilt: type = TVMDecoder::JobType::Solve; return true;
+        case TVMDecoder::DecodeStage::Solved:         type = TVMDecoder::JobType::Reconstruct; return true;
+        default:                                      return false;
+    }
+}
+
+int PlaybackManager::GetPlaybackStep() const {
+    const float rate = playbackRate;
+    const int direction = rate < 0.0f ? -1 : rate > 0.0f ? 1 : (windowStep < 0 ? -1 : 1);
+    const double speed = std::abs(rate);
+    const int64_t decoded = decodeCount;
+    if (speed <= 1.0 || decoded == 0 || subSequenceLength <= 0 || subSequenceCount <= 1) {
+        return direction;
+    }
+    // Skip subsequences when one plays in less time than the workers take to produce one
+    const double frameRate = GetFrameRate() > 0.0f ? GetFrameRate() : kDefaultFrameRate;
+    const double playSeconds = subSequenceLength / (frameRate * speed);
+    // The instances sharing the workers each get their part of them
+    const double workers = std::max(static_cast<double>(jobs->GetWorkerCount()) / std::max(jobs->GetOwnerCount(), 1), 1.0);
+    const double produceSeconds = (GetAverageLoadMs() + GetAverageDecodeMs()) / 1000.0 / workers;
+    const int stride = static_cast<int>(std::ceil(produceSeconds / playSeconds));
+    // Past half the ring a stride would come around behind the playhead and play the other way
+    return direction * std::clamp(stride, 1, std::max((subSequenceCount - 1) / 2, 1));
+}
+
+int PlaybackManager::GetRateBucket(float rate){
+    const int bucket = static_cast<int>(std::lround(rate * 4.0f)) + kRateBuckets / 2;
+    return std::clamp(bucket, 0, kRateBuckets - 1);
+}
+
+int64_t PlaybackManager::GetTotalStallCount() const {
+    int64_t total = 0;
+    for (const auto& count : stallCounts) {
+        total += count;
+    }
+    return total;
+}
+
+int64_t PlaybackManager::GetJobDeadline(int distance, TVMDecoder::JobType type) const {
+    // Until the first frame is decoded the playhead's subsequence goes ahead of every job, the other instances'
+    // included, like an urgent request
+    if (distance == 0 && initState == static_cast<int>(PlaybackInitState::Loading)) {
+        return -1;
+    }
+    // A subsequence's stages run in order, and all of them before the next subsequence's
+    return static_cast<int64_t>(distance) * TVMDecoder::kJobTypeCount + static_cast<int>(type);
+}
+
+void PlaybackManager::ApplyMemoryBudget(){
+    if (!memoryBudget || subSequenceCount <= 0) return;
+    // The instances sharing the budget may have grown or shrunk since the last call
+    const uint64_t allowance = memoryBudget->GetAllowance(budgetOwner);
+    const int length = activeDecoders.GetWindowLength();
+    auto subSequenceAt = [&](int distance) { return activeDecoders.GetSubSequence(distance); };
+
+    // Take subsequences in playback order while their decoded size fits, a size that is not known yet stops the
+    // window from growing until the decodes in it have been measured
+    uint64_t reserved = 0;
+    int window = 0;
+    for (; window < length; ++window) {
+        const uint64_t bytes = EstimateDecodedBytes(subSequenceAt(window));
+        if (bytes == 0 || reserved + bytes > allowance) break;
+        reserved += bytes;
+    }
+    window = std::clamp(window, std::min(kMinBudgetWindow, length), length);
+    if (window != budgetWindow) {
+        LOG_INFO("[PlaybackManager] Memory budget fits ", window, " subsequences");
+        budgetWindow = window;
+    }
+
+    // Reserve the window's full decoded size, so a load entering it evicts before it allocates, then keep what is
+    // decoded past the window while the budget has room. The farthest subsequence in playback order goes first:
+    // behind the playhead that is the one played last, which a looping sequence needs again last (evicting the
+    // least recently used one would drop the next subsequence to play)
+    uint64_t resident = 0;
+    for (int distance = 0; distance < length; ++distance) {
+        const TVMDecoder::DecoderSlot* slot = activeDecoders.Find(subSequenceAt(distance));
+        const uint64_t bytes = slot ? slot->bytes : 0;
+        resident += distance < window ? std::max(bytes, EstimateDecodedBytes(subSequenceAt(distance))) : bytes;
+    }
+    int evicted = 0;
+    for (int distance = length - 1; distance >= window && resident > allowance; --distance) {
+        TVMDecoder::DecoderSlot* slot = activeDecoders.Find(subSequenceAt(distance));
+        if (!slot) continue;
+        resident -= slot->bytes;
+        TVMDecoder::DecoderRing::Release(*slot);
+        ++evicted;
+    }
+    if (evicted > 0) {
+        LOG_INFO("[PlaybackManager] Evicted ", evicted, " decoders over the memory budget");
+        PublishReadyDecoders();
+    }
+    memoryBudget->Reserve(budgetOwner, resident);
+}
+
+void PlaybackManager::SetAdaptiveWindow(double targetMargin, uint64_t maxBytes){
+    std::lock_guard<std::mutex> lock(activeListMutex);
+    adaptiveMargin = std::max(targetMargin, 0.0);
+    adaptiveMaxBytes = maxBytes;
+    if (adaptiveMargin > 0.0 && memoryBudget) {
+        LOG_WARN("[PlaybackManager] The adaptive window is ignored under a memory budget");
+    }
+}
+
+WindowTuning PlaybackManager::GetWindowTuning(){
+    WindowTuning tuning;
+    tuning.preloadWindow = GetPreloadWindow();
+    tuning.decodeWindow = GetDecodeWindow();
+    std::lock_guard<std::mutex> lock(activeListMutex);
+    tuning.adaptive = adaptiveMargin > 0.0 && !memoryBudget;
+    tuning.targetMargin = adaptiveMargin;
+    tuning.margin = tunedMargin;
+    tuning.loadMs = loadEstimateMs;
+    tuning.decodeMs = decodeEstimateMs;
+    const double speed = std::abs(playbackRate.load()) > 0.0f ? std::abs(playbackRate.load()) : 1.0;
+    tuning.subSequenceMs = subSequenceLength * 1000.0 * std::abs(windowStep.load()) / (GetClockFrameRate() * speed);
+    tuning.maxBytes = adaptiveMaxBytes;
+    tuning.limitedByMemory = tunedByMemory;
+    return tuning;
+}
+
+void PlaybackManager::AddSample(double& estimate, double sample){
+    estimate = estimate > 0.0 ? estimate + kEstimateWeight * (sample - estimate) : sample;
+}
+
+bool PlaybackManager::TuneWindows(){
+    if (adaptiveMargin <= 0.0 || memoryBudget || subSequenceCount <= 0 || loadEstimateMs <= 0.0 || decodeEstimateMs <= 0.0) {
+        return false;
+    }
+    // How long one step of the window plays, paused counts as normal speed
+    const double speed = std::abs(playbackRate.load()) > 0.0f ? std::abs(playbackRate.load()) : 1.0;
+    const double stepMs = subSequenceLength * 1000.0 * std::abs(windowStep.load()) / (GetClockFrameRate() * speed);
+    if (stepMs <= 0.0) return false;
+    const double produceMs = loadEstimateMs + decodeEstimateMs;
+
+    // The decoded subsequences past the playhead have to play for the margin times the time it takes to produce
+    // the one entering the window, and the loads ahead of the decodes cover the load time the same way. A window
+    // only shrinks once it has kShrinkHeadroom times the margin, so it does not flap between two sizes
+    auto decodeFor = [&](double margin) { return static_cast<int>(std::ceil(margin * produceMs / stepMs)) + 1; };
+    auto loadsFor = [&](double margin) { return static_cast<int>(std::ceil(margin * loadEstimateMs / stepMs)); };
+    const int minWindow = std::min(kMinBudgetWindow, subSequenceCount.load());
+    const int current = decodeWindow, currentPreload = preLoad;
+    int decode = decodeFor(adaptiveMargin);
+    if (decode < current) {
+        decode = std::max(decode, std::min(current, decodeFor(adaptiveMargin * kShrinkHeadroom)));
+    }
+    decode = std::clamp(decode, minWindow, subSequenceCount.load());
+    int preload = decode + loadsFor(adaptiveMargin);
+    if (preload < currentPreload) {
+        preload = std::max(preload, std::min(currentPreload, decode + loadsFor(adaptiveMargin * kShrinkHeadroom)));
+    }
+    preload = std::clamp(preload, decode, subSequenceCount.load());
+
+    // Under the ceiling the loads ahead go first, a decoded subsequence holds more than a loaded one
+    bool limited = false;
+    if (adaptiveMaxBytes > 0) {
+        const double decodedBytes = static_cast<double>(EstimateDecodedBytes(windowStart));
+        auto bytesFor = [&](int decoded, int loaded) { return decoded * decodedBytes + (loaded - decoded) * loadedEstimateBytes; };
+        while (preload > decode && bytesFor(decode, preload) > adaptiveMaxBytes) {
+            --preload;
+            limited = true;
+        }
+        while (decode > minWindow && bytesFor(decode, preload) > adaptiveMaxBytes) {
+            preload = --decode;
+            limited = true;
+        }
     }
+    tunedMargin = (decode - 1) * stepMs / produceMs;
+    tunedByMemory = limited;
+    if (decode == current && preload == currentPreload) return false;
 
-    if (!nextFound) {
-        LOG_INFO("[DecoderManager] Next Sequence Not Found");
+    LOG_INFO("[PlaybackManager] Adaptive window: pre-load ", preload, ", decode ", decode, " (margin ", tunedMargin,
+             ", load ", loadEstimateMs, " ms, decode ", decodeEstimateMs, " ms, a step plays ", stepMs, " ms",
+             limited ? ", limited by memory)" : ")");
+    decodeWindow = decode;
+    preLoad = preload;
+    if (activeDecoders.SetCapacity(preload + 1) > 0 || decode < current) {
+        PublishReadyDecoders();
+    }
+    return preload < currentPreload;
+}
+
+uint64_t PlaybackManager::EstimateDecodedBytes(int subSequence) const {
+    if (decodedSizes[subSequence - 1] > 0) {
+        return decodedSizes[subSequence - 1];
+    }
+    // Scale what the measured subsequences held per vertex and frame, the frame cache dominates the size
+    const TVMIO::SubSequenceInfo* info = GetSubSequenceInfo(subSequence);
+    const uint64_t values = info ? static_cast<uint64_t>(info->frameCount) * info->vertexCount : 0;
+    if (measuredValues > 0 && values > 0) {
+        return measuredBytes * values / measuredValues;
+    }
+    if (measuredValues > 0) {
+        const auto measured = std::count_if(decodedSizes.begin(), decodedSizes.end(), [](uint64_t bytes) { return bytes > 0; });
+        return measuredBytes / static_cast<uint64_t>(measured);
+    }
+    // Nothing decoded yet, the frame cache alone is a lower bound
+    return values * 3 * sizeof(double);
+}
+
+void PlaybackManager::CountCacheLookups(){
+    using TVMDecoder::DecoderRing;
+    const int start = activeDecoders.GetWindowStart();
+    const int step = activeDecoders.GetStep();
+    const int window = std::min(GetPreloadWindow(), activeDecoders.GetWindowLength());
+    // How far the playhead moved through the last counted window, past its end after a change of direction
+    const int shift = step == countedStep ? DecoderRing::GetDistance(countedStart, countedStep, start, subSequenceCount, !live) : subSequenceCount.load();
+    for (int distance = 0; distance < window; ++distance) {
+        const int subSequence = activeDecoders.GetSubSequence(distance);
+        const int before = DecoderRing::GetDistance(countedStart, countedStep, subSequence, subSequenceCount, !live);
+        // Still wanted for the same visit when it was in the window and the playhead has not passed it, a window
+        // spanning the whole sequence wants what was just played again for the next loop
+        if (before < countedWindow && before >= shift) continue;
+        // Wanted for a new visit, a hit if it is still decoded from the last one
+        const TVMDecoder::DecoderSlot* slot = activeDecoders.Find(subSequence);
+        ++cacheLookups;
+        if (slot && slot->state == TVMDecoder::SlotState::Ready) {
+            ++cacheHits;
+        }
+    }
+    countedStart = start;
+    countedStep = step;
+    countedWindow = window;
+}
+
+void PlaybackManager::RecordResidentBytes(TVMDecoder::DecoderSlot& slot, uint64_t bytes){
+    slot.bytes = bytes;
+    if (slot.state != TVMDecoder::SlotState::Ready) return;
+    uint64_t& measured = decodedSizes[slot.subSequence - 1];
+    if (measured == 0) {
+        measuredValues += static_cast<uint64_t>(slot.decoder->GetTotalFrames()) * slot.decoder->GetVertexCount();
+    }
+    measuredBytes += bytes - measured;
+    measured = bytes;
+}
+
+bool PlaybackManager::SyncSlot(TVMDecoder::DecoderSlot& slot){
+    if (!slot.decoder || slot.state == TVMDecoder::SlotState::Empty || slot.state == TVMDecoder::SlotState::Ready) {
         return false;
     }
-    LOG_INFO("Advancing subSequence!");
-    currentSubSequence = nextSubSequence;
-    // Clean up decoders
-    auto it = activeDecoders.begin();
-    while (it != activeDecoders.end()) {
-        bool shouldKeep = false;
-        int decoderNum = std::stoi((*it)->GetName());
-
-        // Check if within preLoad window
-        for(int y = 0; y < preLoad; y++){
-            int checkNum = currentSubSequence + y;
-            if (checkNum > subSequenceCount) checkNum -= subSequenceCount; // Handle wrap
-
-            if (decoderNum == checkNum){
-                shouldKeep = true;
-                break;
+    const TVMDecoder::DecodeStage stage = slot.decoder->GetStage();
+    if (slot.state == TVMDecoder::SlotState::Loading && stage == TVMDecoder::DecodeStage::Empty) {
+        // Nobody holds the claim of a decoder that is still empty when its load failed, fetch it again
+        if (slot.decoder->TryClaim()) {
+            slot.decoder->ReleaseClaim();
+            if (slot.decoder->GetStage() == TVMDecoder::DecodeStage::Empty) {
+                TVMDecoder::DecoderRing::Release(slot);
             }
         }
-        if(!shouldKeep){
-            LOG_INFO("[DecoderManager] Removing decoder %d", decoderNum);
-            it = activeDecoders.erase(it);
-        }
-        ++it;
+        return false;
     }
+    if (slot.state == TVMDecoder::SlotState::Loading && stage >= TVMDecoder::DecodeStage::Loaded) {
+        TVMDecoder::DecoderRing::SetState(slot, TVMDecoder::SlotState::Loaded);
+    }
+    if (stage != TVMDecoder::DecodeStage::Decoded) {
+        return false;
+    }
+    // Decoded decoders are never written again, measuring one needs no claim
+    TVMDecoder::DecoderRing::SetState(slot, TVMDecoder::SlotState::Decoding);
+    TVMDecoder::DecoderRing::SetState(slot, TVMDecoder::SlotState::Ready);
+    RecordResidentBytes(slot, slot.decoder->GetResidentBytes());
     return true;
 }
 
+CacheStats PlaybackManager::GetCacheStats(){
+    CacheStats stats;
+    stats.budgetBytes = memoryBudget ? memoryBudget->GetAllowance(budgetOwner) : 0;
+    stats.window = GetPreloadWindow();
+    std::lock_guard<std::mutex> lock(activeListMutex);
+    for (const TVMDecoder::DecoderSlot& slot : activeDecoders.GetSlots()) {
+        stats.residentBytes += slot.bytes;
+        if (slot.state == TVMDecoder::SlotState::Ready) {
+            stats.decodedBytes += slot.bytes;
+        }
+    }
+    stats.lookups = cacheLookups;
+    stats.hits = cacheHits;
+    return stats;
+}
+
+int PlaybackManager::GetWindowDistance(int subSequence) const {
+    return TVMDecoder::DecoderRing::GetDistance(windowStart, windowStep, subSequence, subSequenceCount, !live);
+}
+
+std::shared_ptr<TVMDecoder::Decoder> PlaybackManager::FindDecoder(int subSequence){
+    std::lock_guard<std::mutex> lock(activeListMutex);
+    const TVMDecoder::DecoderSlot* slot = activeDecoders.Find(subSequence);
+    return slot ? slot->decoder : nullptr;
+}
+
 void PlaybackManager::LoadSubSequence(int subSequence){
-    if (subSequence > subSequenceCount){
-        LOG_ERROR("[DecoderManager] ❌ SubSequence Out Of Range");
+    ApplyWindowMove();
+    // Deadlines of window jobs start at 0, this one goes ahead of all of them
+    jobs->Schedule(jobOwner, subSequence, TVMDecoder::JobType::Load, -1, [this, subSequence] { RunLoad(subSequence); });
+    jobs->Wait(jobOwner, subSequence, TVMDecoder::JobType::Load);
+}
+
+void PlaybackManager::DecodeSubSequence(int subSequence){
+    ApplyWindowMove();
+    // Walk the decoder through the stages it has left, each merges with the window's job for that stage
+    auto decoder = FindDecoder(subSequence);
+    if (!decoder || !decoder->IsLoaded()) {
+        LOG_ERROR("[PlaybackManager] Trying to decode unloaded sequence");
         return;
     }
-    for (int i = 0; i < activeDecoders.size(); i++){
-        if (activeDecoders[i]->GetName() == std::to_string(subSequence)){
+    TVMDecoder::JobType next;
+    while (GetNextStage(decoder->GetStage(), next)) {
+        const TVMDecoder::DecodeStage before = decoder->GetStage();
+        jobs->Schedule(jobOwner, subSequence, next, -1, [this, subSequence, next] { RunStage(subSequence, next); });
+        jobs->Wait(jobOwner, subSequence, next);
+        if (decoder->GetStage() == before) {
+            if (!decoder->TryClaim()) {
+                // Another instance sharing the decoder is running the stage, wait for it to finish
+                decoder->WaitForClaim();
+                continue;
+            }
+            decoder->ReleaseClaim();
+            // The stage failed, or its job was cancelled and the decoder evicted
+            return;
+        }
+    }
+}
+
+void PlaybackManager::RunLoad(int subSequence){
+    if (subSequence < 1 || subSequence > subSequenceCount){
+        LOG_ERROR("[PlaybackManager] ❌ SubSequence Out Of Range");
+        return;
+    }
+    // A recycled decoder keeps the allocations of the subsequence it held before. It is claimed until it is
+    // loaded, another instance that finds it in the decoded cache meanwhile waits for the load
+    auto newDecoder = decoderPool->Acquire(std::to_string(subSequence));
+    newDecoder->TryClaim();
+    bool shared = false;
+    {
+        // Claim the slot under the lock, loads run concurrently
+        std::lock_guard<std::mutex> lock(activeListMutex);
+        TVMDecoder::DecoderSlot* slot = activeDecoders.GetSlot(subSequence);
+        if (!slot) {
+            LOG_WARN("[PlaybackManager] Subsequence ", subSequence, " is outside of the window, call RequestWindow first");
+            return;
+        }
+        if (slot->state != TVMDecoder::SlotState::Empty) {
             LOG_INFO("Sequence allready loaded");
             return;
         }
+        // Share the decoder of another instance playing the same sequence when it holds this subsequence
+        auto cached = decodedCache->FindOrInsert(decodedKeys[subSequence - 1], newDecoder);
+        TVMDecoder::DecoderRing::SetState(*slot, TVMDecoder::SlotState::Loading);
+        slot->subSequence = subSequence;
+        slot->decoder = cached;
+        shared = cached != newDecoder;
+        if (shared) {
+            newDecoder->ReleaseClaim();
+            LOG_INFO("[PlaybackManager] Subsequence ", subSequence, " is shared with another instance");
+            if (SyncSlot(*slot)) {
+                PublishReadyDecoders();
+            }
+        }
     }
-    std::ostringstream oss;
-    oss << "subsequence_" << std::setw(3) << std::setfill('0') << subSequence;
-    std::filesystem::path subFolder = std::filesystem::path(sequenceDirectory)/(oss.str());
-    auto newDecoder = std::make_shared<TVMDecoder::Decoder>(std::to_string(subSequence));
+    if (shared) {
+        // Whichever instance gets to a stage first runs it, this one catches up on its next Tick
+        ScheduleNextStage(subSequence);
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    if (container) {
+        newDecoder->LoadSequence(*container, subSequence - 1);
+    }
+    else if (source) {
+        // Load seuqence
+        const std::string folder = GetSubSequenceFolder(subSequence);
+        LOG_INFO("[PlaybackManager] Loading subsequence ", subSequence, " from ", sequenceDirectory, "/", folder);
+        newDecoder->LoadSequence(*source, folder);
+    }
+    const int64_t loadTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    loadMicroseconds += loadTime;
+    ++loadCount;
+
+    // Warm the next subsequence in the direction of playback while this one plays, it is the next one the window
+    // will load
+    if (subSequenceCount > 0) {
+        ReadaheadSubSequence(TVMDecoder::DecoderRing::GetSubSequenceAt(subSequence, windowStep, 1, subSequenceCount, !live));
+    }
+
+    const uint64_t bytes = newDecoder->GetResidentBytes();
+    newDecoder->ReleaseClaim();
     {
         std::lock_guard<std::mutex> lock(activeListMutex);
-        activeDecoders.push_back(newDecoder);
+        TVMDecoder::DecoderSlot* slot = activeDecoders.Find(subSequence);
+        if (!slot || slot->decoder != newDecoder) {
+            // Evicted while it was loading
+            return;
+        }
+        if (!newDecoder->IsLoaded()) {
+            // Empty the slot so the next request for this subsequence fetches it again
+            LOG_WARN("[PlaybackManager] Subsequence ", subSequence, " failed to load, it will be fetched again when requested");
+            TVMDecoder::DecoderRing::Release(*slot);
+            return;
+        }
+        TVMDecoder::DecoderRing::SetState(*slot, TVMDecoder::SlotState::Loaded);
+        RecordResidentBytes(*slot, bytes);
+        AddSample(loadEstimateMs, loadTime / 1000.0);
+        AddSample(loadedEstimateBytes, static_cast<double>(bytes));
+        decodeWork[subSequence - 1] = 0;
     }
-    // Load seuqence
-    LOG_INFO("[DecoderManager] Loading subsequence %d from %s", subSequence, subFolder.string().c_str());
-    newDecoder->LoadSequence(subFolder);
+    // Start decoding straight away if the subsequence is still in the decode window
+    ScheduleNextStage(subSequence);
 }
 
-void PlaybackManager::DecodeSubSequence(int subSequence){
-    if (subSequence > subSequenceCount){
-        LOG_ERROR("[DecoderManager] ❌ SubSequence Out Of Range");
-    }
-    for (int i = 0; i < activeDecoders.size(); i++){
-        if (activeDecoders[i]->GetName() == std::to_string(subSequence)){
-            LOG_INFO("[DecoderManager] ➡ Starting decode for subsequence %d...", subSequence);
-            activeDecoders[i]->DecodeSequence();
-            LOG_INFO("[DecoderManager] ✅ Finished decode for subsequence %d", subSequence);
+void PlaybackManager::RunStage(int subSequence, TVMDecoder::JobType type){
+    // Find the decoder under the lock, decode outside of it so playback and other loads are not blocked
+    std::shared_ptr<TVMDecoder::Decoder> decoder;
+    {
+        std::lock_guard<std::mutex> lock(activeListMutex);
+        TVMDecoder::DecoderSlot* slot = activeDecoders.Find(subSequence);
+        TVMDecoder::JobType next;
+        const TVMDecoder::SlotState previous = slot ? slot->state : TVMDecoder::SlotState::Empty;
+        if (!slot || !slot->decoder || !GetNextStage(slot->decoder->GetStage(), next) || next != type ||
+            !TVMDecoder::DecoderRing::SetState(*slot, TVMDecoder::SlotState::Decoding)) {
+            // Evicted, still loading, or the stage already ran for a request that was made before it finished
+            return;
+        }
+        if (!slot->decoder->TryClaim()) {
+            // Another instance sharing the decoder runs a stage of it, the next Tick looks again
+            TVMDecoder::DecoderRing::SetState(*slot, previous);
+            return;
+        }
+        if (!GetNextStage(slot->decoder->GetStage(), next) || next != type) {
+            // Ran by another instance between the check and the claim
+            slot->decoder->ReleaseClaim();
+            TVMDecoder::DecoderRing::SetState(*slot, previous);
             return;
         }
+        decoder = slot->decoder;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    bool success = false;
+    switch (type) {
+        case TVMDecoder::JobType::Laplacian:
+            LOG_INFO("[PlaybackManager] ➡ Starting decode for subsequence ", subSequence, "...");
+            success = decoder->BuildLaplacian();
+            break;
+        case TVMDecoder::JobType::Solve:
+            success = decoder->Solve();
+            break;
+        case TVMDecoder::JobType::Reconstruct:
+            success = decoder->Reconstruct();
+            break;
+        default:
+            break;
+    }
+    const int64_t stageTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    decodeMicroseconds += stageTime;
+    const uint64_t bytes = decoder->GetResidentBytes();
+    decoder->ReleaseClaim();
+    {
+        std::lock_guard<std::mutex> lock(activeListMutex);
+        decodeWork[subSequence - 1] += stageTime;
+        if (success && type == TVMDecoder::JobType::Reconstruct) {
+            AddSample(decodeEstimateMs, decodeWork[subSequence - 1] / 1000.0);
+        }
+        TVMDecoder::DecoderSlot* slot = activeDecoders.Find(subSequence);
+        if (slot && slot->decoder == decoder) {
+            if (!success && decoder->GetStage() == TVMDecoder::DecodeStage::Loaded) {
+                TVMDecoder::DecoderRing::SetState(*slot, TVMDecoder::SlotState::Loaded);
+            }
+            else if (success && type == TVMDecoder::JobType::Reconstruct) {
+                // Hand the decoded subsequence to the render thread
+                TVMDecoder::DecoderRing::SetState(*slot, TVMDecoder::SlotState::Ready);
+                PublishReadyDecoders();
+            }
+            RecordResidentBytes(*slot, bytes);
+        }
+    }
+    if (!success) {
+        LOG_WARN("[PlaybackManager] ", TVMDecoder::GetJobTypeName(type), " failed for subsequence ", subSequence);
+        return;
+    }
+    if (type != TVMDecoder::JobType::Reconstruct) {
+        ScheduleNextStage(subSequence);
+        return;
+    }
+    ++decodeCount;
+    LOG_INFO("[PlaybackManager] ✅ Finished decode for subsequence ", subSequence);
+    const TVMIO::SubSequenceInfo* info = GetSubSequenceInfo(subSequence);
+    if (info && (decoder->GetVertexCount() != static_cast<int>(info->vertexCount) ||
+                 decoder->GetTotalFrames() != static_cast<int>(info->frameCount))) {
+        LOG_WARN("[PlaybackManager] Subsequence ", subSequence, " does not match the manifest (",
+                 decoder->GetVertexCount(), " vertices, ", decoder->GetTotalFrames(), " frames)");
+    }
+}
+
+bool PlaybackManager::IsSubSequenceComplete(int subSequence) const {
+    try {
+        return source->Contains(GetSubSequenceFolder(subSequence), TVMIO::SequenceSource::kCompleteFileName);
+    } catch (const std::exception& e) {
+        // An unreachable server looks like a folder that is not complete yet, the next poll tries again
+        LOG_WARN("[PlaybackManager] Can't check subsequence ", subSequence, ": ", e.what());
+        return false;
+    }
+}
+
+int PlaybackManager::FindLiveTail() const {
+    // The encoder completes folders in order, so the complete ones are a prefix: double the probe until one is
+    // missing, then bisect. A few checks even for a long sequence, which matters for remote folders
+    if (!IsSubSequenceComplete(1)) return 0;
+    int complete = 1, missing = 2;
+    while (IsSubSequenceComplete(missing)) {
+        complete = missing;
+        missing *= 2;
+    }
+    while (missing - complete > 1) {
+        const int middle = complete + (missing - complete) / 2;
+        (IsSubSequenceComplete(middle) ? complete : missing) = middle;
+    }
+    return complete;
+}
+
+void PlaybackManager::ScheduleDiscovery(){
+    // Until the first job opened the sequence, that job is the one looking for complete subsequences
+    if (!live || !opened) return;
+    {
+        // One caller queues the poll, the others go on with the subsequences already known
+        std::unique_lock<std::mutex> lock(liveMutex, std::try_to_lock);
+        const auto now = std::chrono::steady_clock::now();
+        if (!lock.owns_lock() || now < nextLivePoll) return;
+        nextLivePoll = now + livePollInterval;
+    }
+    // Merged while the previous poll is still running, so a slow server never has more than one check in flight.
+    // Due right after the playhead's own stages: the newest subsequence is what a live clock waits for
+    jobs->Schedule(jobOwner, 0, TVMDecoder::JobType::Discover, GetJobDeadline(0, TVMDecoder::JobType::Discover),
+                   [this] { DiscoverSubSequences(); });
+}
+
+void PlaybackManager::DiscoverSubSequences(){
+    // Until a complete subsequence is known, look for the newest one: playback starts there. Then only the folder
+    // after the newest complete one is checked, and the ones after it when the encoder got ahead
+    int count = subSequenceCount;
+    if (count == 0) {
+        count = FindLiveTail();
+    }
+    else {
+        while (IsSubSequenceComplete(count + 1)) {
+            ++count;
+        }
     }
-    LOG_ERROR("[DecoderManager] Trying to decode unloaded sequence");
+    if (count > subSequenceCount) {
+        GrowSequence(count);
+    }
+}
 
+void PlaybackManager::GrowSequence(int count){
+    std::lock_guard<std::mutex> lock(activeListMutex);
+    const int previous = subSequenceCount;
+    if (count <= previous) return;
+    // The per subsequence state grows before the count, readers that see the new count find it
+    decodedSizes.resize(static_cast<size_t>(count), 0);
+    decodeWork.resize(static_cast<size_t>(count), 0);
+    for (int subSequence = previous + 1; subSequence <= count; ++subSequence) {
+        decodedKeys.push_back(TVMDecoder::DecodedCache::GetKey(sequenceDirectory, subSequence));
+    }
+    activeDecoders.SetSubSequenceCount(count);
+    activeDecoders.SetCapacity(memoryBudget ? count : preLoad + 1);
+    subSequenceCount = count;
+    if (previous == 0) {
+        // The first subsequence the encoder completed, playback starts at the newest
+        windowStart = count;
+        currentSubSequence = count;
+        activeDecoders.MoveWindow(count, windowStep);
+    }
+    PublishReadyDecoders();
+    LOG_INFO("[PlaybackManager] Live: subsequence ", count, " completed, ", count - previous, " new");
+}
+
+std::string PlaybackManager::GetSubSequenceFolder(int subSequence) const {
+    const TVMIO::SubSequenceInfo* info = GetSubSequenceInfo(subSequence);
+    if (info && !info->path.empty()) {
+        return info->path;
+    }
+    std::ostringstream oss;
+    oss << "subsequence_" << std::setw(3) << std::setfill('0') << subSequence;
+    return oss.str();
+}
+
+void PlaybackManager::ReadaheadSubSequence(int subSequence) {
+    if (!readahead || subSequence < 1 || subSequence > subSequenceCount) return;
+    {
+        std::lock_guard<std::mutex> lock(activeListMutex);
+        if (activeDecoders.Find(subSequence)) return;
+    }
+    try {
+        const uint64_t queued = container
+            ? readahead->Enqueue({container->GetSubSequenceRange(subSequence - 1)})
+            : readahead->Enqueue(source ? source->GetFileRanges(GetSubSequenceFolder(subSequence)) : std::vector<TVMIO::ByteRange>{});
+        LOG_INFO("[PlaybackManager] Reading ahead subsequence ", subSequence, " (", queued / 1024, " KB)");
+    } catch (const std::exception& e) {
+        LOG_WARN("[PlaybackManager] Readahead skipped for subsequence ", subSequence, ": ", e.what());
+    }
+}
+
+TVMIO::ReadaheadStats PlaybackManager::GetReadaheadStats() const {
+    return readahead ? readahead->GetStats() : TVMIO::ReadaheadStats{};
+}
+
+double PlaybackManager::GetAverageLoadMs() const {
+    const int64_t count = loadCount;
+    return count > 0 ? loadMicroseconds / 1000.0 / count : 0.0;
+}
+
+double PlaybackManager::GetAverageDecodeMs() const {
+    const int64_t count = decodeCount;
+    return count > 0 ? decodeMicroseconds / 1000.0 / count : 0.0;
 }
 
 int PlaybackManager::getSubSequenceCount(){
     return subSequenceCount;
 }
 
+const TVMIO::SubSequenceInfo* PlaybackManager::GetSubSequenceInfo(int subSequence) const {
+    if (!opened || !manifest || subSequence < 1 || subSequence > manifest->GetSubSequenceCount()) {
+        return nullptr;
+    }
+    return &manifest->GetSubSequence(subSequence - 1);
+}
+
+int64_t PlaybackManager::GetTotalFrameCount() const {
+    if (opened && manifest) {
+        return manifest->GetTotalFrames();
+    }
+    return static_cast<int64_t>(subSequenceCount) * subSequenceLength;
+}
+
 std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d>>
 PlaybackManager::fetchFrame(int frame){
-    std::lock_guard<std::mutex> lock(activeListMutex);  // ADD THIS!
+    // Render thread: the current decoder is owned by this thread, no lock is taken
+    LOG_INFO("fetchFrame called with frame: ", frame, ", current subsequence: ", currentSubSequence.load());
 
-    TVMLogger::LogInfo("fetchFrame called with frame: " + std::to_string(frame) +
-                       ", current subsequence: " + std::to_string(currentSubSequence));
-
-    if (activeDecoders.empty()) {
+    if (!getCurrentDecoder()) {
         throw std::runtime_error("No active decoders");
     }
 
-    if (frame < 0 || frame >= activeDecoders.front()->GetTotalFrames()) {
+    if (frame < 0 || frame >= currentDecoder->GetTotalFrames()) {
         TVMLogger::LogError("Frame " + std::to_string(frame) + " out of range for decoder with " +
-                            std::to_string(activeDecoders.front()->GetTotalFrames()) + " frames");
+                            std::to_string(currentDecoder->GetTotalFrames()) + " frames");
     }
-
-    std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d>> frameData;
-    for (auto& decoder : activeDecoders) {
-        if (decoder->GetName() == std::to_string(currentSubSequence)) {
-            frameData = decoder->ApplyDisplacementToFrame(frame);
-            return frameData;
-        }
-    }
-    LOG_ERROR("[DecoderManager] ❌ Fetch Frame called for non active subsequence");
-    return frameData;
+    return currentDecoder->ApplyDisplacementToFrame(frame);
 }
 
 std::shared_ptr<TVMDecoder::Decoder>  PlaybackManager::getCurrentDecoder(){
-    std::lock_guard<std::mutex> lock(activeListMutex); // ✅ Add lock
-    for (auto& decoder : activeDecoders) {
-        if (decoder->GetName() == std::to_string(currentSubSequence)) {
-            return decoder;
+    if (!currentDecoder) {
+        // Initialized in the background, take the current subsequence once the workers published it
+        const TVMDecoder::DecoderSlot* slot = readyDecoders.Read().Find(currentSubSequence);
+        if (slot && slot->state == TVMDecoder::SlotState::Ready) {
+            currentDecoder = slot->decoder;
         }
     }
-    return nullptr;
+    return currentDecoder;
 }
 
+uint64_t PlaybackManager::GetTopologyId() {
+    auto decoder = getCurrentDecoder();
+    return decoder ? decoder->GetTopologyId() : 0;
+}
 
+bool PlaybackManager::TopologyChanged() {
+    // A list that is not interned (id 0) can't be told apart from another one, it always counts as changed
+    const uint64_t id = GetTopologyId();
+    return id == 0 || id != uploadedTopologyId;
+}
+
+void PlaybackManager::MarkTopologyUploaded() {
+    uploadedTopologyId = GetTopologyId();
+}
@@ -1,41 +1,249 @@
 // PlaybackManager.h
 
 #pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <string>
+#include <thread>
 #include <mutex> // Make sure this is included
+#include "BufferPool.h"
+#include "ByteSource.h"
+#include "DecoderPool.h"
+#include "DecoderRing.h"
+#include "JobScheduler.h"
+#include "MemoryBudget.h"
+#include "PlaybackClock.h"
+#include "PlaybackContext.h"
+#include "Readahead.h"
+#include "TripleBuffer.h"
 #include "TVMDecoder.h"
+#include "SequenceContainer.h"
+#include "SequenceManifest.h"
+#include "SolveCache.h"
+#include "ZipArchive.h"
+
+/**
+ * @brief CacheStats: How the playback window uses its memory budget.
+ */
+struct CacheStats {
+    uint64_t budgetBytes = 0;    // This instance's part of the shared budget, 0 when the window is sized by counts
+    uint64_t residentBytes = 0;  // Held by every decoder in the window
+    uint64_t decodedBytes = 0;   // The part held by decoded subsequences
+    int window = 0;              // Subsequences loaded and decoded ahead of the playhead, including it
+    int64_t lookups = 0;         // Subsequences that entered the window
+    int64_t hits = 0;            // The ones among them that were still decoded from an earlier visit
+};
+
+/**
+ * @brief PlaybackInitState: How far a PlaybackManager got decoding its first window.
+ */
+enum class PlaybackInitState : int {
+    Failed = -1,     // The sequence could not be opened or is empty
+    Loading = 0,     // Nothing decoded yet
+    FirstFrame = 1,  // The first subsequence is decoded and playback can start, the window fills in the background
+    Ready = 2,       // The decode window is decoded
+};
+
+/**
+ * @brief WindowTuning: What the adaptive window measured, and the window sizes it chose from that.
+ */
+struct WindowTuning {
+    bool adaptive = false;
+    int preloadWindow = 0;
+    int decodeWindow = 0;
+    double targetMargin = 0.0;     // Wanted decoded playback ahead of the playhead, per time to produce a subsequence
+    double margin = 0.0;           // Reached with decodeWindow, 0 until a load and a decode were measured
+    double loadMs = 0.0;           // Recent time to load a subsequence
+    double decodeMs = 0.0;         // Recent time to decode a subsequence, all stages
+    double subSequenceMs = 0.0;    // How long a window step plays at the playback rate
+    uint64_t maxBytes = 0;         // The memory ceiling, 0 for none
+    bool limitedByMemory = false;  // The ceiling kept the windows below what the margin asks for
+};
+
+/**
+ * @brief LiveOptions: Playing a sequence folder while the encoder still appends subsequences to it.
+ */
+struct LiveOptions {
+    bool enabled = false;
+    double latencySeconds = 2.0;  // How far behind the newest complete subsequence playback may fall
+    int pollIntervalMs = 100;     // How often the folder after the newest one is looked for
+};
 
 class PlaybackManager {
 public:
     /**
      * @brief PlaybackManager: Constructor
-     * @param path: Takes a string that is the path to the folder of the encoded sequence we are decoding
+     * @param path: The sequence folder, a .tvmc container or a .zip of the folder, local or http://
      * @param memLoad: The amount of subsequences that we will pre-load into memory from IO
      * @param decodeLoad: The amount of subseqences that we will pre-decode before playback (memLoad must be greater then decodeLoad)
      * @param enableLogging: A bool to enable logging messages
+     * @param readaheadBytes: The most bytes read ahead of the pre-load window at once, 0 disables readahead
+     * @param jobWorkers: The number of threads loading and decoding the window, 0 picks one from the hardware
+     * @param memoryBudget: The most bytes the window's decoders may hold, 0 sizes the window by memLoad and decodeLoad
+     * @param solveCache: Solved S_hat matrices kept on disk across launches, nullptr solves every decode
+     */
+    PlaybackManager(const std::string& path, int memLoad, int decodeLoad, bool enableLogging,
+                    uint64_t readaheadBytes = kDefaultReadaheadBytes, int jobWorkers = 0, uint64_t memoryBudget = 0,
+                    std::shared_ptr<TVMDecoder::SolveCache> solveCache = nullptr);
+
+    /**
+     * @brief PlaybackManager: Constructor for one of several instances sharing a context's workers, budget and caches
+     * @param context: The shared workers, budget and caches
+     * @param waitForWindow: Wait for the first window, otherwise return at once and open the sequence on a worker
+     * @param live: Follow a sequence folder that is still being encoded, from its newest complete subsequence
      */
-    PlaybackManager(const std::string& path, int memLoad, int decodeLoad, bool enableLogging);
+    PlaybackManager(const std::string& path, int memLoad, int decodeLoad, bool enableLogging,
+                    std::shared_ptr<TVMDecoder::PlaybackContext> context, uint64_t readaheadBytes = kDefaultReadaheadBytes,
+                    bool waitForWindow = true, const LiveOptions& live = LiveOptions());
+
+    static constexpr uint64_t kDefaultReadaheadBytes = 256ull << 20;
+    static constexpr int kPooledDecoders = 2;  // Idle decoders kept for the subsequences entering the window
+    static constexpr int kMinBudgetWindow = 2; // The playing subsequence and the next one, kept even over budget
+    static constexpr float kDefaultFrameRate = 30.0f;  // Assumed without a manifest, to time variable rate playback
+    static constexpr int kRateBuckets = 65;            // Stalls are counted per quarter rate from -8x to 8x
+    static constexpr auto kClockInterval = std::chrono::milliseconds(10);  // The clock worker's window upkeep
+    static constexpr double kDefaultWindowMargin = 2.0;
+    static constexpr double kShrinkHeadroom = 1.5;  // An adaptive window shrinks once it has this much more margin
+    static constexpr double kEstimateWeight = 0.25; // Of the latest measurement in the recent load and decode times
 
     /**
-     * @brief AdvanceSubSequence: Advance to the next subsequence in the encoded sequence
+     * @brief AdvanceSubSequence: Advance to the next decoded subsequence in the direction of playback (render thread)
      * @return success or failure
      */
     bool AdvanceSubSequence();
 
     /**
-     * @brief LoadSubSequence: Load the files for a given subsequence into stored memory
-     * @param subSequence: The subseqeunce we are loading (0-indexed)
+     * @brief RequestWindow: Move the pre-load and decode windows to start at a subsequence
+     * @param subSequence: The first subsequence of the window (1-indexed)
+     */
+    void RequestWindow(int subSequence);
+
+    /**
+     * @brief Seek: Jump to a frame of the whole sequence, playing the nearest decoded frame until it is ready
+     * @param globalFrame: The frame (0-indexed) of the whole sequence, clamped to its length
+     * @return The frame of the current decoder to show, -1 when nothing is decoded yet
+     */
+    int Seek(int64_t globalFrame);
+
+    /**
+     * @brief SetPlaybackRate: Set the playback speed, negative plays backwards and 0 pauses
+     */
+    void SetPlaybackRate(float rate);
+    float GetPlaybackRate() const { return playbackRate; }
+
+    /**
+     * @brief GetWindowStep: The distance between the window's subsequences, negative when playing backwards
+     */
+    int GetWindowStep() const { return windowStep; }
+
+    /**
+     * @brief GetStallCount: How often AdvanceSubSequence found the next subsequence not decoded at a rate
+     */
+    int64_t GetStallCount(float rate) const { return stallCounts[GetRateBucket(rate)]; }
+    int64_t GetTotalStallCount() const;
+
+    /**
+     * @brief SetAdaptiveWindow: Size the windows from the measured load and decode times instead of the counts
+     * @param targetMargin: Decoded playback wanted ahead, per time to produce a subsequence, 0 turns it off
+     * @param maxBytes: The most bytes the windows may hold, 0 for no limit
+     */
+    void SetAdaptiveWindow(double targetMargin, uint64_t maxBytes = 0);
+
+    /**
+     * @brief GetWindowTuning: The window sizes in use, and what the adaptive window chose them from
+     */
+    WindowTuning GetWindowTuning();
+
+    // The number of subsequences from the start of the window that are loaded, and decoded
+    int GetPreloadWindow() const { return memoryBudget ? budgetWindow.load() : preLoad.load(); }
+    int GetDecodeWindow() const { return memoryBudget ? budgetWindow.load() : decodeWindow.load(); }
+
+    /**
+     * @brief IsSeekPending: Check if the window was moved to a subsequence that is not playing yet
+     */
+    bool IsSeekPending() const { return windowStart != currentSubSequence; }
+
+    /**
+     * @brief Tick: Keep the current window scheduled, call once per frame
+     * @return The number of jobs queued or running
+     */
+    int Tick();
+
+    /**
+     * @brief Play: Start the playback clock, its worker moves and schedules the window from then on
+     */
+    void Play();
+    void Pause();
+    bool IsPlaying() const { return clock.IsPlaying(); }
+
+    /**
+     * @brief SetLooping: Wrap around at the end of the sequence (the default), or pause there
+     */
+    void SetLooping(bool loop);
+    bool IsLooping() const { return looping; }
+
+    /**
+     * @brief IsLive: Check if the sequence is followed while it is being encoded
+     */
+    bool IsLive() const { return live; }
+
+    /**
+     * @brief SetLiveLatency: How far behind the newest complete subsequence the clock may fall before it jumps
+     */
+    void SetLiveLatency(double seconds);
+    double GetLiveLatencyTarget() const { return liveLatency; }
+
+    /**
+     * @brief GetLiveLatency: How far the clock is behind the end of the newest complete subsequence, in seconds
+     */
+    double GetLiveLatency() const;
+
+    // The number of times the clock jumped ahead to the live latency target
+    int64_t GetLiveSkipCount() const { return liveSkips; }
+
+    /**
+     * @brief SetPlaybackTime: Move the playback clock, it holds until the subsequence there is decoded
+     * @param seconds: The position in the whole sequence, wrapped around when looping, clamped otherwise
+     */
+    void SetPlaybackTime(double seconds);
+    double GetPlaybackTime() const { return clock.GetTime(); }
+
+    /**
+     * @brief IsBuffering: Check if the clock is held because the subsequence it reached is not decoded yet
+     */
+    bool IsBuffering() const { return clock.IsHeld(); }
+
+    /**
+     * @brief SetFrameRate: The frames per second the clock plays, 0 uses the manifest's rate or kDefaultFrameRate
+     */
+    void SetFrameRate(float frameRate);
+    double GetClockFrameRate() const;
+
+    /**
+     * @brief GetFrameForTime: The decoded frame to show at a time of the playback clock (render thread)
+     * @param seconds: The position in the whole sequence, usually GetPlaybackTime()
+     * @param subSequence: Receives the subsequence (1-indexed) of the frame, 0 when nothing is decoded yet
+     * @param frame: Receives the frame (0-indexed) within it
+     * @return True if the frame is the one at the time, false if the nearest decoded frame is returned instead
+     */
+    bool GetFrameForTime(double seconds, int& subSequence, int& frame);
+
+    /**
+     * @brief LoadSubSequence: Load the files for a given subsequence into stored memory, waiting for the load
+     * @param subSequence: The subseqeunce we are loading (1-indexed)
      */
     void LoadSubSequence(int subSequence);
 
     /**
-     * @brief DecodeSubSequence Decode a given subsequence from memory
-     * @param subSequence: The subseqeunce we are decoding (0-indexed)
+     * @brief DecodeSubSequence Decode a given subsequence from memory, waiting for the decode
+     * @param subSequence: The subseqeunce we are decoding (1-indexed)
      */
     void DecodeSubSequence(int subSequence);
     /**
-     * @brief fetchFrame: Get the vertex values for a given frame from the active decoder.
+     * @brief fetchFrame: Get the vertex values for a given frame from the active decoder (render thread)
      * @param frame: The frame we are fetching (0-indexed)
      * @return A vector holder the frame values.
      */
@@ -43,16 +251,253 @@ public:
 
     //getter functions
     int getSubSequenceCount();
-    std::shared_ptr<TVMDecoder::Decoder> getCurrentDecoder();
+    std::shared_ptr<TVMDecoder::Decoder> getCurrentDecoder();  // Render thread only
+
+    /**
+     * @brief GetTopologyId: The id of the current decoder's triangle list, 0 without one (render thread)
+     */
+    uint64_t GetTopologyId();
+
+    /**
+     * @brief TopologyChanged: Check if the current triangle list differs from the last one uploaded (render thread)
+     */
+    bool TopologyChanged();
+
+    /**
+     * @brief MarkTopologyUploaded: Record the current triangle list as the one the render side holds
+     */
+    void MarkTopologyUploaded();
+
+    /**
+     * @brief GetInitState: How far decoding the first window got
+     */
+    PlaybackInitState GetInitState() const { return static_cast<PlaybackInitState>(initState.load()); }
+
+    /**
+     * @brief GetTimeToFirstFrameMs: The time from the constructor until the first frame was decoded, -1 before that
+     */
+    double GetTimeToFirstFrameMs() const;
+
+    /**
+     * @brief GetSubSequenceInfo: Get the manifest entry for a subsequence, nullptr without a manifest
+     * @param subSequence: The subsequence (1-indexed)
+     */
+    const TVMIO::SubSequenceInfo* GetSubSequenceInfo(int subSequence) const;
+
+    /**
+     * @brief GetTotalFrameCount: The number of frames in the whole sequence, estimated without a manifest
+     */
+    int64_t GetTotalFrameCount() const;
+
+    /**
+     * @brief GetSubSequenceStartFrame: The frame of the whole sequence a subsequence starts at
+     * @param subSequence: The subsequence (1-indexed)
+     */
+    int64_t GetSubSequenceStartFrame(int subSequence) const;
+
+    int GetCurrentSubSequence() const { return currentSubSequence; }
+
+    bool HasManifest() const { return opened && manifest != nullptr; }
+    float GetFrameRate() const { return HasManifest() ? manifest->GetFrameRate() : 0.0f; }
+    int GetMaxVertexCount() const { return HasManifest() ? static_cast<int>(manifest->GetMaxVertexCount()) : 0; }
+
+    /**
+     * @brief GetReadaheadStats: Counters of the readahead worker, all zero when readahead is disabled
+     */
+    TVMIO::ReadaheadStats GetReadaheadStats() const;
+
+    /**
+     * @brief GetAverageLoadMs / GetAverageDecodeMs: Mean wall time of a subsequence's load and decode
+     */
+    double GetAverageLoadMs() const;
+    double GetAverageDecodeMs() const;
+
+    /**
+     * @brief GetJobStats: Counters of the load and decode workers, shared with the other instances of the context
+     */
+    TVMDecoder::JobStats GetJobStats() const { return jobs->GetStats(); }
+
+    /**
+     * @brief GetCacheStats: The memory the window's decoders hold and how often the window found one still decoded
+     */
+    CacheStats GetCacheStats();
 
     //cleanup
     ~PlaybackManager();
 private:
+    // Open the sequence and count its subsequences, then request the first window (on the first job when async)
+    void OpenSequence();
+
+    // Load the manifest of the opened sequence, if it has one
+    void LoadManifest();
+
+    // The folder name of a subsequence (1-indexed) in a folder or zip layout
+    std::string GetSubSequenceFolder(int subSequence) const;
+
+    // Queue a subsequence's (1-indexed) bytes for readahead unless it is already loaded
+    void ReadaheadSubSequence(int subSequence);
+
+    // Apply the window move of the last AdvanceSubSequence, if it has not been applied yet
+    bool ApplyWindowMove();
+
+    // Home the ring, the queued jobs and the published copy on windowStart, under activeListMutex
+    void MoveWindowLocked();
+
+    // The window step the playback rate and the measured decode speed call for
+    int GetPlaybackStep() const;
+
+    static int GetRateBucket(float rate);
+
+    // Publish the decoded subsequences to the render thread, the caller holds activeListMutex
+    void PublishReadyDecoders();
+
+    // Move the init state on with what was just published. The caller holds activeListMutex
+    void UpdateInitState();
+
+    // The job bodies, run on a worker
+    void RunLoad(int subSequence);
+    void RunStage(int subSequence, TVMDecoder::JobType type);
+
+    // Queue the window's missing loads and decodes, returns the number of jobs queued or running
+    int ScheduleWindow();
+
+    // Queue the next decode stage of a subsequence if it is loaded, not decoded and inside the decode window
+    void ScheduleNextStage(int subSequence);
+
+    // Resize the adaptive windows under activeListMutex, true when the pre-load window shrank
+    bool TuneWindows();
+
+    // Fold a measurement into a recent estimate
+    static void AddSample(double& estimate, double sample);
+
+    // Fit the window to the memory budget, then evict what no longer fits. The caller holds activeListMutex
+    void ApplyMemoryBudget();
+
+    // The bytes a subsequence (1-indexed) is expected to hold once decoded, 0 while unknown
+    uint64_t EstimateDecodedBytes(int subSequence) const;
+
+    // Count the subsequences that entered the window since the last call. The caller holds activeListMutex
+    void CountCacheLookups();
+
+    // Record what a decoder holds in its slot once a job is done with it. The caller holds activeListMutex
+    void RecordResidentBytes(TVMDecoder::DecoderSlot& slot, uint64_t bytes);
+
+    // Catch a slot up with what another instance sharing its decoder did, true if it became Ready
+    bool SyncSlot(TVMDecoder::DecoderSlot& slot);
+
+    // The job that takes a decoder past its stage, false when it is not loaded or already decoded
+    static bool GetNextStage(TVMDecoder::DecodeStage stage, TVMDecoder::JobType& type);
+
+    // The deadline of a stage of the subsequence a distance into the window
+    int64_t GetJobDeadline(int distance, TVMDecoder::JobType type) const;
+
+    // The subsequence (1-indexed) holding a frame of the whole sequence, and the frame within it
+    void LocateFrame(int64_t globalFrame, int& subSequence, int& frame) const;
+
+    // The frame of the whole sequence at a time of the clock, wrapped or clamped to the sequence
+    int64_t GetFrameAtTime(double seconds) const;
+
+    // The frame of the whole sequence a subsequence (1-indexed) ends before
+    int64_t GetSubSequenceEndFrame(int subSequence) const;
+
+    // Wake the clock worker to apply a change now, starting it if it is not running
+    void WakeClock();
+
+    // The clock worker: moves the window with the clock, returns how long it may sleep
+    void RunClock();
+    std::chrono::steady_clock::duration UpdateClock();
+
+    // How far a subsequence (1-indexed) is past the start of the window, wrapping around the sequence
+    int GetWindowDistance(int subSequence) const;
+
+    // The decoder of a subsequence (1-indexed), nullptr if it is not active
+    std::shared_ptr<TVMDecoder::Decoder> FindDecoder(int subSequence);
+
+    // Live sequences: the completion checks block on a remote folder, so they only run on a worker (Discover job)
+    bool IsSubSequenceComplete(int subSequence) const;
+    int FindLiveTail() const;
+    void ScheduleDiscovery();
+    void DiscoverSubSequences();
+
+    // Add the subsequences the encoder completed, the window and the clock can reach them from then on
+    void GrowSequence(int count);
+
     std::string sequenceDirectory;
-    std::vector<std::shared_ptr<TVMDecoder::Decoder>> activeDecoders;
-    int currentSubSequence;
-    int subSequenceCount;
-    int preLoad;
-    int subSequenceLength;
+    std::shared_ptr<TVMIO::SequenceContainer> container;
+    std::shared_ptr<TVMIO::SequenceSource> source;  // Folder, zip or server layout, unset for containers
+    std::shared_ptr<TVMIO::SequenceManifest> manifest;
+    std::atomic<bool> opened{false};  // The members above and frameStarts are set, and fixed from then on
+    std::shared_ptr<TVMDecoder::BufferPool> bufferPool;
+    std::shared_ptr<TVMDecoder::DecoderPool> decoderPool;
+    std::shared_ptr<TVMDecoder::DecodedCache> decodedCache;  // The context's, shares decoders with other instances
+    std::vector<std::string> decodedKeys;                   // Every subsequence's key in decodedCache
+    std::unique_ptr<TVMIO::Readahead> readahead;
+    std::atomic<int64_t> loadCount{0}, loadMicroseconds{0}, decodeCount{0}, decodeMicroseconds{0};
+    TVMDecoder::DecoderRing activeDecoders;  // The window's decoders, guarded by activeListMutex
+
+    // The render thread's view: the decoder it plays and a copy of the window it can advance to
+    TVMDecoder::TripleBuffer<TVMDecoder::DecoderRing, TVMDecoder::ReleaseRingDecoders> readyDecoders;
+    std::shared_ptr<TVMDecoder::Decoder> currentDecoder;
+    uint64_t uploadedTopologyId = 0;  // 0 until the first upload, never a live list's id
+    std::atomic<int> currentSubSequence{0};
+    std::atomic<bool> windowMoved{false};  // windowStart was set without homing the ring (AdvanceSubSequence)
+    std::atomic<int> subSequenceCount{0};  // Only grows, for a live sequence
+    std::atomic<int> preLoad{0};
+    std::atomic<int> decodeWindow{0};
+    std::atomic<int> windowStart{1};  // Set with the ring under activeListMutex, or by AdvanceSubSequence
+    std::atomic<int> windowStep{1};   // Set under activeListMutex
+    std::atomic<float> playbackRate{1.0f};
+    std::array<std::atomic<int64_t>, kRateBuckets> stallCounts{};
+    bool stalled = false;  // Render thread only, the last advance failed
+    std::atomic<int> subSequenceLength{0};  // Known once the first subsequence is decoded without a manifest
+    std::chrono::steady_clock::time_point initStart;
+    std::atomic<int> initState{static_cast<int>(PlaybackInitState::Loading)};
+    std::atomic<int64_t> firstFrameMicroseconds{-1};
+    std::vector<int64_t> frameStarts;  // The first frame of every subsequence and the total, from the manifest
+
+    // Memory budget shared with the other instances, nullptr without one. The sizes and counters are guarded by
+    // activeListMutex
+    std::shared_ptr<TVMDecoder::MemoryBudget> memoryBudget;
+    int budgetOwner = -1;
+    std::atomic<int> budgetWindow{kMinBudgetWindow};
+    std::vector<uint64_t> decodedSizes;  // Measured per subsequence, 0 until it was decoded once
+    uint64_t measuredBytes = 0, measuredValues = 0;  // Summed over the measured subsequences, to estimate the rest
+    int countedStart = 1, countedStep = 1, countedWindow = 0;  // The window the cache lookups were last counted for
+
+    // Adaptive window sizing, guarded by activeListMutex
+    double adaptiveMargin = 0.0;
+    uint64_t adaptiveMaxBytes = 0;
+    double loadEstimateMs = 0.0, decodeEstimateMs = 0.0;
+    double loadedEstimateBytes = 0.0;  // Held by a loaded subsequence before it is decoded
+    std::vector<int64_t> decodeWork;   // Microseconds of decode stages per subsequence since its load
+    double tunedMargin = 0.0;
+    bool tunedByMemory = false;
+    int64_t cacheLookups = 0, cacheHits = 0;
     std::mutex activeListMutex; // The member mutex
+    std::shared_ptr<TVMDecoder::PlaybackContext> context;  // Shared with the other instances playing at once
+    std::shared_ptr<TVMDecoder::JobScheduler> jobs;  // The context's, the destructor waits for this instance's jobs
+    int jobOwner = -1;
+
+    // The playback clock and its worker. The worker alone moves the window once it runs, clockSubSequence and
+    // clockStalled are its own
+    TVMDecoder::PlaybackClock clock;
+    std::thread clockThread;
+    std::mutex clockMutex;
+    std::condition_variable clockWake;
+    bool clockStopping = false, clockChanged = false;  // Guarded by clockMutex
+    std::atomic<bool> clockActive{false};
+    std::atomic<bool> clockJumped{true};  // The clock was moved, the worker re-homes the window
+    std::atomic<bool> looping{true};
+    std::atomic<float> frameRateOverride{0.0f};
+    int clockSubSequence = 0;
+    bool clockStalled = false;
+    bool clockAtTail = false;  // Waiting for the encoder at the newest subsequence of a live sequence
+
+    // Live sequences, the next poll is guarded by liveMutex
+    bool live = false;
+    std::atomic<double> liveLatency{0.0};
+    std::chrono::milliseconds livePollInterval{0};
+    std::mutex liveMutex;
+    std::chrono::steady_clock::time_point nextLivePoll;
+    std::atomic<int64_t> liveSkips{0};
 };
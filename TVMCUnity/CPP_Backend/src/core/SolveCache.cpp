@@ -0,0 +1,201 @@
+#include "SolveCache.h"
+#include "MappedFile.h"
+#include "TVMLogger.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace TVMDecoder {
+
+namespace {
+
+constexpr char kCacheMagic[4] = {'T', 'V', 'S', 'C'};
+constexpr uint32_t kCacheFileVersion = 1;
+
+// Precedes the "TVMM" matrix in every cache file. 64 bytes, so the matrix keeps the alignment of the mapping
+struct CacheFileHeader {
+    char magic[4];          // "TVSC"
+    uint32_t version;       // kCacheFileVersion
+    uint64_t key;           // The key the file is named after
+    uint64_t payloadBytes;  // Byte size of the matrix that follows
+    uint32_t checksum;      // CRC32 of the matrix bytes
+    uint32_t reserved;      // Zero
+    uint8_t padding[32];    // Zero
+};
+static_assert(sizeof(CacheFileHeader) == 64, "CacheFileHeader must be 64 bytes");
+
+int64_t GetFileTime(const std::filesystem::file_time_type& time) {
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+bool ParseKey(const std::filesystem::path& path, uint64_t& key) {
+    const std::string stem = path.stem().string();
+    if (path.extension() != ".bin" || stem.size() != 16 ||
+        stem.find_first_not_of("0123456789abcdef") != std::string::npos) {
+        return false;
+    }
+    key = std::stoull(stem, nullptr, 16);
+    return true;
+}
+
+} // namespace
+
+SolveCache::SolveCache(const std::string& directory, uint64_t maxBytes)
+    : directory(directory), maxBytes(maxBytes) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (!std::filesystem::is_directory(directory, error)) {
+        throw std::runtime_error("Can't create the solve cache directory " + directory);
+    }
+    for (const auto& file : std::filesystem::directory_iterator(directory, error)) {
+        uint64_t key = 0;
+        if (!file.is_regular_file(error) || !ParseKey(file.path(), key)) continue;
+        Entry& entry = entries[key];
+        entry.bytes = file.file_size(error);
+        entry.lastUsed = GetFileTime(file.last_write_time(error));
+        stats.bytes += entry.bytes;
+    }
+    stats.files = static_cast<int64_t>(entries.size());
+    LOG_INFO("[SolveCache] ✅ ", directory, ": ", stats.files, " cached solves, ", stats.bytes / 1024, " KB");
+}
+
+std::string SolveCache::GetPath(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(directory) / name).string();
+}
+
+bool SolveCache::Find(uint64_t key, Eigen::Index rows, Eigen::Index cols, MatrixIO::MappedMatrix& result) {
+    const std::string path = GetPath(key);
+    std::error_code error;
+    bool found = false;
+    if (std::filesystem::is_regular_file(path, error)) {
+        try {
+            // A file cut short or corrupted on disk (or written by an older version) is a miss, not a wrong S_hat
+            auto file = std::make_shared<TVMIO::MappedFile>(path);
+            CacheFileHeader header{};
+            if (file->Size() >= sizeof(header)) {
+                std::memcpy(&header, file->Data(), sizeof(header));
+            }
+            const char* payload = file->Data() + sizeof(header);
+            if (file->Size() < sizeof(header) || std::memcmp(header.magic, kCacheMagic, 4) != 0 ||
+                header.version != kCacheFileVersion || header.key != key ||
+                header.payloadBytes != file->Size() - sizeof(header) ||
+                TVMIO::Crc32(payload, header.payloadBytes) != header.checksum) {
+                throw std::runtime_error("checksum mismatch");
+            }
+            MatrixIO::MappedMatrix cached = MatrixIO::loadbin(file, payload, static_cast<size_t>(header.payloadBytes), path);
+            if (cached.rows() == rows && cached.cols() == cols) {
+                result = std::move(cached);
+                found = true;
+            }
+            else {
+                LOG_WARN("[SolveCache] ", path, " has the wrong shape, deleting it");
+            }
+        } catch (const std::exception& e) {
+            LOG_WARN("[SolveCache] Can't read ", path, ", deleting it: ", e.what());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto entry = entries.find(key);
+    if (!found) {
+        ++stats.misses;
+        if (entry != entries.end() || std::filesystem::exists(path, error)) {
+            std::filesystem::remove(path, error);
+            if (entry != entries.end()) {
+                stats.bytes -= entry->second.bytes;
+                entries.erase(entry);
+            }
+        }
+        stats.files = static_cast<int64_t>(entries.size());
+        return false;
+    }
+    ++stats.hits;
+    if (entry == entries.end()) {
+        // Stored by another process since this one started
+        entry = entries.emplace(key, Entry{std::filesystem::file_size(path, error), 0}).first;
+        stats.bytes += entry->second.bytes;
+        stats.files = static_cast<int64_t>(entries.size());
+    }
+    // Keep the use in the file itself, so the next launch evicts in the same order
+    const auto now = std::filesystem::file_time_type::clock::now();
+    std::filesystem::last_write_time(path, now, error);
+    entry->second.lastUsed = GetFileTime(now);
+    return true;
+}
+
+bool SolveCache::Store(uint64_t key, const Eigen::Ref<const Eigen::MatrixXd>& sHat) {
+    const std::vector<char> matrix = MatrixIO::tobin(sHat);
+    CacheFileHeader header{};
+    std::memcpy(header.magic, kCacheMagic, 4);
+    header.version = kCacheFileVersion;
+    header.key = key;
+    header.payloadBytes = matrix.size();
+    header.checksum = TVMIO::Crc32(matrix.data(), matrix.size());
+    const uint64_t fileBytes = sizeof(header) + matrix.size();
+    if (maxBytes > 0 && fileBytes > maxBytes) return false;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        EvictLocked(fileBytes);
+    }
+
+    // Write next to the final name and rename, so no reader (in this process or another) maps a partial file
+    static std::atomic<uint64_t> nextTemporary{0};
+    const std::string path = GetPath(key);
+    const std::string temporary = path + ".tmp" + std::to_string(nextTemporary++);
+    std::error_code error;
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(matrix.data(), static_cast<std::streamsize>(matrix.size()));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(temporary, error);
+            LOG_WARN("[SolveCache] Can't write ", temporary);
+            return false;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    Entry& entry = entries[key];
+    stats.bytes += fileBytes - entry.bytes;
+    entry.bytes = fileBytes;
+    entry.lastUsed = GetFileTime(std::filesystem::file_time_type::clock::now());
+    stats.files = static_cast<int64_t>(entries.size());
+    ++stats.stores;
+    return true;
+}
+
+void SolveCache::EvictLocked(uint64_t incomingBytes) {
+    if (maxBytes == 0) return;
+    while (!entries.empty() && stats.bytes + incomingBytes > maxBytes) {
+        auto oldest = std::min_element(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+            return a.second.lastUsed < b.second.lastUsed;
+        });
+        // A file still mapped by a decoder stays readable through its mapping on POSIX. Where it can't be deleted
+        // it is forgotten anyway and indexed again on the next launch
+        std::error_code error;
+        std::filesystem::remove(GetPath(oldest->first), error);
+        stats.bytes -= oldest->second.bytes;
+        entries.erase(oldest);
+        ++stats.evictions;
+    }
+    stats.files = static_cast<int64_t>(entries.size());
+}
+
+SolveCacheStats SolveCache::GetStats() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return stats;
+}
+
+} // namespace TVMDecoder
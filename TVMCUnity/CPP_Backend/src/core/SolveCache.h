@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <Eigen/Dense>
+#include "MatrixIO.h"
+
+namespace TVMDecoder {
+
+/**
+ * @brief SolveCacheStats: Counters of a SolveCache.
+ */
+struct SolveCacheStats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t stores = 0;
+    int64_t evictions = 0;
+    uint64_t bytes = 0;  // The size of the cached files
+    int64_t files = 0;
+};
+
+/**
+ * @brief SolveCache: A directory of solved S_hat matrices kept across launches. Each file holds one S_hat in the
+ *        aligned "TVMM" format behind a small header with its CRC32, named after the hash of everything the solve
+ *        depends on (the reference mesh, dHat, the anchors and the solver settings), so a later decode of the same
+ *        subsequence maps the file and skips the Laplacian and the solve. A file that fails its checksum is a miss
+ *        and is deleted. The directory is bounded, the least recently used files are deleted when a
+ *        store would go over the limit. Thread safe, and a file is only visible once it is completely written.
+ */
+class SolveCache {
+public:
+    static constexpr uint64_t kDefaultMaxBytes = 1ull << 30;
+    static constexpr uint32_t kVersion = 1;  // Part of every key, bump it when the solve changes its result
+
+    /**
+     * @brief SolveCache: Open (or create) the cache directory and index the files already in it.
+     * @param directory: The cache directory.
+     * @param maxBytes: The most bytes the cached files may take, 0 for no limit.
+     * @throws RunTimeError: If the directory can't be created.
+     */
+    SolveCache(const std::string& directory, uint64_t maxBytes = kDefaultMaxBytes);
+
+    SolveCache(const SolveCache&) = delete;
+    SolveCache& operator=(const SolveCache&) = delete;
+
+    /**
+     * @brief Find: Map the cached S_hat for a key.
+     * @param key: The hash of the solve's inputs.
+     * @param rows: The shape the S_hat must have, a file of another shape (or a corrupt one) is treated as a miss
+     *        and deleted.
+     * @param cols: See rows.
+     * @param result: Receives the mapped matrix on a hit.
+     * @return True on a hit.
+     */
+    bool Find(uint64_t key, Eigen::Index rows, Eigen::Index cols, MatrixIO::MappedMatrix& result);
+
+    /**
+     * @brief Store: Write a solved S_hat, evicting the least recently used files it does not fit beside.
+     * @param key: The hash of the solve's inputs.
+     * @param sHat: The solved matrix.
+     * @return False if the file could not be written (the cache is only an optimization, decoding goes on).
+     */
+    bool Store(uint64_t key, const Eigen::Ref<const Eigen::MatrixXd>& sHat);
+
+    SolveCacheStats GetStats();
+    const std::string& GetDirectory() const { return directory; }
+
+private:
+    struct Entry {
+        uint64_t bytes = 0;
+        int64_t lastUsed = 0;  // Seconds since the epoch, kept in the file's modification time across launches
+    };
+
+    std::string GetPath(uint64_t key) const;
+
+    // Delete files, least recently used first, until the cache fits the limit with room for the bytes to add
+    void EvictLocked(uint64_t incomingBytes);
+
+    std::string directory;
+    uint64_t maxBytes;
+    std::mutex cacheMutex;
+    std::unordered_map<uint64_t, Entry> entries;
+    SolveCacheStats stats;
+};
+
+} // namespace TVMDecoder
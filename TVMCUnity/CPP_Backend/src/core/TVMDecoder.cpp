@@ -1,7 +1,9 @@
 #include "TVMDecoder.h"
 #include "SimpleMesh.h"
 #include "SimpleMeshIO.h"
+#include "MappedFile.h"
 #include "MatrixIO.h"
+#include "SolveCache.h"
 #include "TVMLogger.h"
 #include "TVMUtil.h"
 #include <filesystem>
@@ -10,12 +12,19 @@
 #include <Eigen/Dense>
 #include <Eigen/IterativeLinearSolvers>
 #include <vector>
+#include <cstring>
 #include <stdexcept>
 
 namespace TVMDecoder {
 
-Decoder::Decoder(const std::string& name) {
+const std::vector<int> Decoder::kNoIndices;
+
+Decoder::Decoder(const std::string& name, std::shared_ptr<BufferPool> pool, std::shared_ptr<SolveCache> solveCache,
+                 std::shared_ptr<TopologyStore> topologies) {
     decoderName = name;
+    bufferPool = std::move(pool);
+    this->solveCache = std::move(solveCache);
+    topologyStore = std::move(topologies);
 }
 
 Decoder::~Decoder() {
@@ -24,18 +33,18 @@ Decoder::~Decoder() {
 
 void Decoder::Clear() {
     LOG_INFO("[Decoder] 🔄 Clearing decoder state: %s", decoderName.c_str());
-    decodedFrames.clear(); decodedFrames.shrink_to_fit();
+    if (bufferPool) {
+        bufferPool->Release(decodedVertexBuffer);
+    }
     decodedVertexBuffer.clear(); decodedVertexBuffer.shrink_to_fit();
     referenceVertexBuffer.clear(); referenceVertexBuffer.shrink_to_fit();
-    triangleIndicesFlat.clear(); triangleIndicesFlat.shrink_to_fit();
+    topology.reset();
     anchor_indices.clear(); anchor_indices.shrink_to_fit();
 
-    Eigen::MatrixXd().swap(dHat);
-    Eigen::MatrixXd().swap(bMatrix);
-    Eigen::MatrixXd().swap(tMatrix);
-    Eigen::MatrixXd().swap(S_hat);
-    Eigen::MatrixXd().swap(T_hat);
-    Eigen::MatrixXd().swap(tMean);
+    dHat.Reset();
+    bMatrix.Reset();
+    tMatrix.Reset();
+    S_hat.Reset();
     Eigen::SparseMatrix<double>().swap(l_star);
 
     decodedReferenceMesh.vertices.clear();
@@ -47,11 +56,92 @@ void Decoder::Clear() {
 
     totalFrames = 0;
     verticesPerFrame = 0;
-    isDecoded = false;
+    stage = DecodeStage::Empty;
 
     LOG_INFO("[Decoder] ✅ Clear complete for decoder: %s", decoderName.c_str());
 }
 
+void Decoder::Reset(const std::string& name) {
+    // clear() keeps the capacity, the next load and Reconstruct fill the same memory
+    decoderName = name;
+    claimed = false;
+    decodedVertexBuffer.clear();
+    referenceVertexBuffer.clear();
+    topology.reset();  // Shared, let it go rather than keep its capacity
+    anchor_indices.clear();
+
+    // The matrices view the old subsequence's bytes, let those go
+    dHat.Reset();
+    bMatrix.Reset();
+    tMatrix.Reset();
+    S_hat.Reset();
+    Eigen::SparseMatrix<double>().swap(l_star);
+
+    decodedReferenceMesh.vertices.clear();
+    decodedReferenceMesh.triangles.clear();
+    decodedReferenceMesh.adjacency_list.clear();
+
+    totalFrames = 0;
+    verticesPerFrame = 0;
+    stage = DecodeStage::Empty;
+}
+
+uint64_t Decoder::GetSolveKey() const {
+    uint64_t key = TVMIO::Hash64(reinterpret_cast<const char*>(&SolveCache::kVersion), sizeof(SolveCache::kVersion));
+    auto hash = [&key](const void* data, size_t bytes) { key = TVMIO::Hash64(static_cast<const char*>(data), bytes, key); };
+    // The mesh keeps the loaded triangle order, the shared list may be reordered. Its triangles are the same bytes
+    // as the loaded flat indices, so the keys don't depend on the reordering
+    static_assert(sizeof(Eigen::Vector3i) == 3 * sizeof(int), "Eigen::Vector3i must be 3 packed ints");
+    const auto& triangles = decodedReferenceMesh.triangles;
+    const int64_t shape[] = {static_cast<int64_t>(decodedReferenceMesh.vertices.size()),
+                             static_cast<int64_t>(triangles.size() * 3), dHat.rows(), dHat.cols()};
+    hash(shape, sizeof(shape));
+    const double settings[] = {static_cast<double>(kSolveIterations), kSolveTolerance};
+    hash(settings, sizeof(settings));
+    hash(decodedReferenceMesh.vertices.data(), decodedReferenceMesh.vertices.size() * sizeof(Eigen::Vector3d));
+    hash(triangles.data(), triangles.size() * sizeof(Eigen::Vector3i));
+    hash(anchor_indices.data(), anchor_indices.size() * sizeof(int));
+    // dHat may be a view with padded columns, hash the values only
+    const MatrixIO::ConstMatrixMap d = dHat.Map();
+    for (Eigen::Index col = 0; col < d.cols(); ++col) {
+        hash(d.col(col).data(), static_cast<size_t>(d.rows()) * sizeof(double));
+    }
+    return key;
+}
+
+size_t Decoder::GetResidentBytes() const {
+    auto matrixBytes = [](Eigen::Index rows, Eigen::Index cols) { return static_cast<size_t>(rows * cols) * sizeof(double); };
+    size_t bytes = decodedVertexBuffer.capacity() * sizeof(double) +
+                   referenceVertexBuffer.capacity() * sizeof(double) +
+                   (topology ? topology->GetBytes() : 0) +  // Counted by every decoder sharing it, an upper bound
+                   anchor_indices.capacity() * sizeof(int);
+    bytes += decodedReferenceMesh.vertices.capacity() * sizeof(Eigen::Vector3d) +
+             decodedReferenceMesh.triangles.capacity() * sizeof(Eigen::Vector3i);
+    for (const auto& neighbours : decodedReferenceMesh.adjacency_list) {
+        // The buckets plus a heap node per neighbour, a node is about four pointers with the allocator's header
+        bytes += neighbours.bucket_count() * sizeof(void*) + neighbours.size() * 4 * sizeof(void*);
+    }
+    bytes += matrixBytes(dHat.rows(), dHat.cols()) + matrixBytes(bMatrix.rows(), bMatrix.cols()) +
+             matrixBytes(tMatrix.rows(), tMatrix.cols());
+    bytes += matrixBytes(S_hat.rows(), S_hat.cols());
+    bytes += static_cast<size_t>(l_star.nonZeros()) * (sizeof(double) + sizeof(int)) +
+             static_cast<size_t>(l_star.outerSize() + 1) * sizeof(int);
+    return bytes;
+}
+
+void Decoder::ReleaseClaim() {
+    {
+        // Stored under the lock, a waiter between its check and its wait would miss the notification otherwise
+        std::lock_guard<std::mutex> lock(claimMutex);
+        claimed.store(false, std::memory_order_release);
+    }
+    claimReleased.notify_all();
+}
+
+void Decoder::WaitForClaim() {
+    std::unique_lock<std::mutex> lock(claimMutex);
+    claimReleased.wait(lock, [this] { return !claimed.load(std::memory_order_acquire); });
+}
 
 void Decoder::LoadSequence(const std::string& directoryPath) {
 
@@ -59,38 +149,135 @@ void Decoder::LoadSequence(const std::string& directoryPath) {
         LOG_ERROR("[Decoder] ❌ File path is empty!");
     }
     LOG_INFO("[Decoder] Paths received: %s", directoryPath.c_str());
-    std::filesystem::path dirPath(directoryPath);
-    std::string meshFile = (dirPath / "decoded_decimated_reference_mesh_subdivided.obj").string();
-    std::string dHatFile = (dirPath / "delta_trajectories.bin").string();
-    std::string tMatrixFile = (dirPath / "T_matrix.txt").string();
-    std::string bMatrixFile = (dirPath / "B_matrix.txt").string();
+    LoadSequence(TVMIO::DirectorySource(directoryPath), "");
+}
+
+void Decoder::LoadSequence(const TVMIO::SequenceSource& source, const std::string& folder) {
+    LOG_INFO("[Decoder] Loading ", folder.empty() ? "sequence" : folder);
 
     try {
+        // Only this subsequence's files are read
+        LoadReferenceMesh(source.Read(folder, "decoded_decimated_reference_mesh_subdivided.obj"));
+
+        const std::string prefix = folder.empty() ? "" : folder + "/";
+        TVMIO::ByteView dHatData = source.Read(folder, "delta_trajectories.bin");
+        dHat = MatrixIO::loadbin(dHatData.backing, dHatData.data, dHatData.size, prefix + "delta_trajectories.bin");
+        LOG_INFO("[Decoder] ✅ Loaded dHat: ", dHat.rows(), " x ", dHat.cols(), dHat.IsMapped() ? " (mapped)" : " (copied)");
+
+        // Load matrices (binary .bin when present, otherwise .txt)
+        auto loadMatrix = [&](const std::string& stem) {
+            if (source.Contains(folder, stem + ".bin")) {
+                TVMIO::ByteView data = source.Read(folder, stem + ".bin");
+                return MatrixIO::loadbin(data.backing, data.data, data.size, prefix + stem + ".bin");
+            }
+            TVMIO::ByteView data = source.Read(folder, stem + ".txt");
+            return MatrixIO::MappedMatrix(MatrixIO::loadtxt(data.data, data.size, prefix + stem + ".txt"));
+        };
+        bMatrix = loadMatrix("B_matrix");
+        LOG_INFO("[Decoder] ✅ Loaded B_matrix");
+
+        tMatrix = loadMatrix("T_matrix");
+        LOG_INFO("[Decoder] ✅ Loaded T_matrix");
+        stage = DecodeStage::Loaded;
+
+    } catch (const std::exception& e) {
+        LOG_ERROR("[Decoder] ❌ Failed to load sequence: ", e.what());
+    }
+}
+
+void Decoder::SetTopology(std::vector<int> indices, int vertexCount) {
+    topology = topologyStore ? topologyStore->Intern(std::move(indices), vertexCount)
+                             : TopologyStore::MakeUnshared(std::move(indices));
+}
+
+void Decoder::LoadReferenceMesh(const TVMIO::ByteView& obj) {
+    SimpleMeshIO::ReadOBJ(obj.data, obj.size, decodedReferenceMesh);
+    SetTopology(SimpleMeshIO::LoadTriangleIndicesFlat(obj.data, obj.size),
+                static_cast<int>(decodedReferenceMesh.vertices.size()));
+    decodedReferenceMesh.ComputeAdjacencyList();
+    LOG_INFO("[Decoder] ✅ Loaded reference mesh");
+}
+
+void Decoder::LoadSequence(const TVMIO::SequenceContainer& container, int index) {
+    using TVMIO::SectionType;
+    LOG_INFO("[Decoder] Loading subsequence ", index + 1, " from container");
+
+    try {
+        const TVMIO::SubSequenceEntry& entry = container.GetEntry(index);
+        const auto sections = container.ReadSections(index, true);
+        auto section = [&](SectionType type) -> const TVMIO::ByteView& {
+            return sections[static_cast<int>(type)];
+        };
+        if (section(SectionType::ReferenceMesh).size != entry.vertexCount * 3 * sizeof(double) ||
+            section(SectionType::TriangleIndices).size != entry.triangleCount * 3 * sizeof(int32_t)) {
+            throw std::runtime_error("Mesh section sizes do not match the index entry");
+        }
+
         // Load reference mesh
-        SimpleMeshIO::ReadOBJ(meshFile, decodedReferenceMesh);
-        triangleIndicesFlat = SimpleMeshIO::LoadTriangleIndicesFlat(meshFile);
+        const char* vertexData = section(SectionType::ReferenceMesh).data;
+        decodedReferenceMesh.vertices.resize(entry.vertexCount);
+        for (uint32_t v = 0; v < entry.vertexCount; ++v) {
+            double xyz[3];
+            std::memcpy(xyz, vertexData + v * sizeof(xyz), sizeof(xyz));
+            decodedReferenceMesh.vertices[v] = Eigen::Vector3d(xyz[0], xyz[1], xyz[2]);
+        }
+        const char* indexData = section(SectionType::TriangleIndices).data;
+        std::vector<int> triangleIndicesFlat(entry.triangleCount * 3);
+        std::memcpy(triangleIndicesFlat.data(), indexData, triangleIndicesFlat.size() * sizeof(int32_t));
+        for (int idx : triangleIndicesFlat) {
+            if (idx < 0 || idx >= static_cast<int>(entry.vertexCount)) {
+                throw std::runtime_error("Triangle index out of range");
+            }
+        }
+        decodedReferenceMesh.triangles.resize(entry.triangleCount);
+        for (uint32_t t = 0; t < entry.triangleCount; ++t) {
+            decodedReferenceMesh.triangles[t] = Eigen::Vector3i(
+                triangleIndicesFlat[t * 3], triangleIndicesFlat[t * 3 + 1], triangleIndicesFlat[t * 3 + 2]);
+        }
+        SetTopology(std::move(triangleIndicesFlat), static_cast<int>(entry.vertexCount));
         decodedReferenceMesh.ComputeAdjacencyList();
         LOG_INFO("[Decoder] ✅ Loaded reference mesh");
 
-        // Load dHat
-        dHat = MatrixIO::LoadDeltaTrajectories(dHatFile);
-        LOG_INFO("[DEBUG] dHat from file - first values: %f, %f, %f", dHat(0,0), dHat(0,1), dHat(0,2));
-        LOG_INFO("[DEBUG] dHat from file - row 100: %f, %f, %f", dHat(100,0), dHat(100,1), dHat(100,2));
-        LOG_INFO("[Decoder] ✅ Loaded dHat: %d x %d",
-                 static_cast<int>(dHat.rows()), static_cast<int>(dHat.cols()));
-
-        // Load matrices
-        bMatrix = MatrixIO::loadtxt(bMatrixFile);
-        LOG_INFO("[Decoder] ✅ Loaded B_matrix");
-
-        tMatrix = MatrixIO::loadtxt(tMatrixFile);
-        LOG_INFO("[Decoder] ✅ Loaded T_matrix");
+        // Matrices are viewed in place, the decoder keeps the mapping (or fetched span) alive
+        const std::string name = container.GetName() + "#" + std::to_string(index + 1);
+        auto loadSection = [&](SectionType type, const std::string& label) {
+            const TVMIO::ByteView& data = section(type);
+            return MatrixIO::loadbin(data.backing, data.data, data.size, name + "/" + label);
+        };
+        dHat = loadSection(SectionType::DeltaTrajectories, "dHat");
+        bMatrix = loadSection(SectionType::BMatrix, "B_matrix");
+        tMatrix = loadSection(SectionType::TMatrix, "T_matrix");
+        LOG_INFO("[Decoder] ✅ Loaded dHat, B_matrix and T_matrix");
+        stage = DecodeStage::Loaded;
 
     } catch (const std::exception& e) {
-        LOG_ERROR("[Decoder] ❌ Failed to load sequence: %s", e.what());
+        LOG_ERROR("[Decoder] ❌ Failed to load sequence: ", e.what());
     }
 }
+
 bool Decoder::DecodeSequence(){
+    if (!IsLoaded()) {
+        LOG_ERROR("[Decoder] ❌ DecodeSequence called before a successful load: ", decoderName);
+        return false;
+    }
+    // Finish whichever stages are left, a decoder may already be part way through the pipeline
+    if (stage == DecodeStage::Loaded && !BuildLaplacian()) return false;
+    if (stage == DecodeStage::LaplacianBuilt && !Solve()) return false;
+    if (stage == DecodeStage::Solved && !Reconstruct()) return false;
+    return IsDecoded();
+}
+
+bool Decoder::RequireStage(DecodeStage required, const char* step) const {
+    if (stage != required) {
+        LOG_ERROR("[Decoder] ❌ ", step, " called out of order for decoder ", decoderName,
+                  " (stage ", static_cast<int>(stage.load()), ", needs ", static_cast<int>(required), ")");
+        return false;
+    }
+    return true;
+}
+
+bool Decoder::BuildLaplacian() {
+    if (!RequireStage(DecodeStage::Loaded, "BuildLaplacian")) return false;
     int refCount = decodedReferenceMesh.vertices.size();
     int totalRows = dHat.rows();
     int anchorCount = totalRows - refCount;
@@ -98,51 +285,81 @@ bool Decoder::DecodeSequence(){
     for (int i = 0; i < anchorCount; ++i) {
         anchor_indices.push_back(std::round(i * (decodedReferenceMesh.vertices.size() - 1.0) / (anchorCount - 1.0)));
     }
-    Eigen::MatrixXd D_regular = dHat.topRows(refCount);
-    Eigen::MatrixXd D_anchor = dHat.bottomRows(anchorCount);
+    if (solveCache) {
+        // The solve is deterministic, a subsequence decoded before (in this launch or an earlier one) maps its result
+        solveKey = GetSolveKey();
+        if (solveCache->Find(solveKey, refCount, dHat.cols(), S_hat)) {
+            LOG_INFO("[Decoder] ✅ Mapped S_hat from the solve cache");
+            stage = DecodeStage::Solved;
+            return true;
+        }
+    }
     l_star = TVMUtil::BuildLaplacianMatrix(decodedReferenceMesh, anchor_indices);
     LOG_INFO("[Decoder] ✅ Constructed L_star");
+    stage = DecodeStage::LaplacianBuilt;
+    return true;
+}
 
-    Eigen::MatrixXd rhs(l_star.rows(), dHat.cols());
-    rhs.topRows(refCount) = D_regular;
-    rhs.bottomRows(anchorCount) = D_anchor;
-
-    S_hat = TVMUtil::SolveLeastSquares(l_star, rhs, 500, 1e-6);
-    return ProcessLoadedData();
+bool Decoder::Solve() {
+    if (!RequireStage(DecodeStage::LaplacianBuilt, "Solve")) return false;
+    // dHat is already laid out as [D_regular; D_anchor], so it is the right hand side as is
+    S_hat = MatrixIO::MappedMatrix(TVMUtil::SolveLeastSquares(l_star, dHat.Map(), kSolveIterations, kSolveTolerance));
+    if (solveCache && !solveCache->Store(solveKey, S_hat.Map())) {
+        LOG_WARN("[Decoder] S_hat of ", decoderName, " was not cached");
+    }
+    stage = DecodeStage::Solved;
+    return true;
 }
 
-// Common processing logic after data is loaded
-bool Decoder::ProcessLoadedData() {
+bool Decoder::Reconstruct() {
+    if (!RequireStage(DecodeStage::Solved, "Reconstruct")) return false;
     LOG_INFO("[Decoder] Loaded Matrix Shapes:");
     LOG_INFO("  S_hat: %d x %d", static_cast<int>(S_hat.rows()), static_cast<int>(S_hat.cols()));
     LOG_INFO("  B_matrix: %d x %d", static_cast<int>(bMatrix.rows()), static_cast<int>(bMatrix.cols()));
     LOG_INFO("  T_matrix: %d x %d", static_cast<int>(tMatrix.rows()), static_cast<int>(tMatrix.cols()));
 
-    // Compute S * B + T
-    Eigen::MatrixXd sb = S_hat * bMatrix;
-    T_hat = TVMUtil::ApplyTMatrixOffset(sb, tMatrix);
-
     // Set sequence values
     totalFrames = bMatrix.cols() / 3;
     verticesPerFrame = decodedReferenceMesh.vertices.size();
-    decodedVertexBuffer.resize(totalFrames * verticesPerFrame * 3);
-    decodedFrames.clear();
-    decodedFrames.reserve(totalFrames);
+    if (tMatrix.rows() != 1 || tMatrix.cols() != bMatrix.cols()) {
+        LOG_ERROR("[Decoder] ❌ T_matrix must be shape (1, 3 * numFrames) for decoder ", decoderName);
+        return false;
+    }
+    if (GetVertexOrder() && GetVertexOrder()->size() != static_cast<size_t>(verticesPerFrame)) {
+        LOG_ERROR("[Decoder] ❌ The triangle list's vertex order does not match the mesh for decoder ", decoderName);
+        return false;
+    }
+    const size_t bufferSize = static_cast<size_t>(totalFrames) * verticesPerFrame * 3;
+    if (bufferPool) {
+        bufferPool->Release(decodedVertexBuffer);
+        decodedVertexBuffer = bufferPool->Acquire(bufferSize);
+    } else {
+        decodedVertexBuffer.resize(bufferSize);
+    }
 
-    // Cache all frame displacements
+    // Compute S * B + T straight into the frame cache. A frame's xyz triplets are (S_hat * B_f)^T for the frame's
+    // 3 columns B_f of B, so no full size S * B matrix is built and copied
+    const MatrixIO::ConstMatrixMap b = bMatrix.Map();
+    const MatrixIO::ConstMatrixMap t = tMatrix.Map();
+    const MatrixIO::ConstMatrixMap sHat = S_hat.Map();
+    const std::vector<int>* order = GetVertexOrder();
+    Eigen::Matrix<double, 3, Eigen::Dynamic> loadedOrder;  // A frame before it is put in the triangle list's order
+    if (order) {
+        loadedOrder.resize(3, verticesPerFrame);
+    }
     for (int i = 0; i < totalFrames; ++i) {
-        int colStart = i * 3;
-        Eigen::MatrixXd disp = T_hat.block(0, colStart, verticesPerFrame, 3);
-
-        std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d>> frameDisplacements(verticesPerFrame);
-        for (int v = 0; v < verticesPerFrame; ++v) {
-            frameDisplacements[v] = disp.row(v).transpose();
-            size_t offset = (i * verticesPerFrame + v) * 3;
-            decodedVertexBuffer[offset + 0] = frameDisplacements[v].x();
-            decodedVertexBuffer[offset + 1] = frameDisplacements[v].y();
-            decodedVertexBuffer[offset + 2] = frameDisplacements[v].z();
+        Eigen::Map<Eigen::Matrix<double, 3, Eigen::Dynamic>> frame(
+            decodedVertexBuffer.data() + static_cast<size_t>(i) * verticesPerFrame * 3, 3, verticesPerFrame);
+        if (order) {
+            loadedOrder.noalias() = b.middleCols<3>(i * 3).transpose() * sHat.transpose();
+            for (int v = 0; v < verticesPerFrame; ++v) {
+                frame.col(v) = loadedOrder.col((*order)[v]);
+            }
         }
-        decodedFrames.push_back(std::move(frameDisplacements));
+        else {
+            frame.noalias() = b.middleCols<3>(i * 3).transpose() * sHat.transpose();
+        }
+        frame.colwise() += t.block<1, 3>(0, i * 3).transpose();
     }
 
     LOG_INFO("[Decoder] ✅ Decoded and cached %d frames", totalFrames);
@@ -150,36 +367,38 @@ bool Decoder::ProcessLoadedData() {
     // Store reference vertices
     referenceVertexBuffer.clear();
     referenceVertexBuffer.reserve(verticesPerFrame * 3);
-    for (const auto& v : decodedReferenceMesh.vertices) {
+    for (int n = 0; n < verticesPerFrame; ++n) {
+        const Eigen::Vector3d& v = decodedReferenceMesh.vertices[order ? (*order)[n] : n];
         referenceVertexBuffer.push_back(v.x());
         referenceVertexBuffer.push_back(v.y());
         referenceVertexBuffer.push_back(v.z());
     }
 
-    isDecoded = true;
+    stage = DecodeStage::Decoded;
     return true;
 }
 
 std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d>>
 Decoder::ApplyDisplacementToFrame(int frameIndex) const {
-    if (!isDecoded) {
+    if (!IsDecoded()) {
         throw std::runtime_error("Sequence hasn't been loaded yet.");
     }
-    if (frameIndex < 0 || frameIndex >= decodedFrames.size()) {
+    if (frameIndex < 0 || frameIndex >= totalFrames) {
         throw std::out_of_range("Invalid frame index in ApplyDisplacementToFrame");
     }
 
     const auto& baseVerts = decodedReferenceMesh.vertices;
-    const auto& displacements = decodedFrames[frameIndex];
-
-    if (baseVerts.size() != displacements.size()) {
+    if (static_cast<int>(baseVerts.size()) != verticesPerFrame) {
         throw std::runtime_error("Mismatch in base and displacement vector sizes.");
     }
+    const double* displacements = decodedVertexBuffer.data() + static_cast<size_t>(frameIndex) * verticesPerFrame * 3;
 
     std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d>> deformedVerts(baseVerts.size());
 
+    const std::vector<int>* order = GetVertexOrder();
     for (size_t i = 0; i < baseVerts.size(); ++i) {
-        deformedVerts[i] = baseVerts[i] + displacements[i];
+        const Eigen::Vector3d& base = baseVerts[order ? (*order)[i] : i];
+        deformedVerts[i] = base + Eigen::Map<const Eigen::Vector3d>(displacements + i * 3);
     }
 
     return deformedVerts;
@@ -1,12 +1,34 @@
 #pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <Eigen/Sparse>
+#include "BufferPool.h"
 #include "SimpleMesh.h"
+#include "ByteSource.h"
+#include "MatrixIO.h"
+#include "SequenceContainer.h"
+#include "TopologyStore.h"
 
 
 namespace TVMDecoder {
 
+class SolveCache;
+
+/**
+ * @brief DecodeStage: How far a decoder has got, each stage needs the one before it.
+ */
+enum class DecodeStage {
+    Empty = 0,       // Nothing loaded
+    Loaded,          // Files parsed (LoadSequence)
+    LaplacianBuilt,  // L_star built from the reference mesh (BuildLaplacian)
+    Solved,          // S_hat solved (Solve)
+    Decoded          // Frames reconstructed and cached (Reconstruct)
+};
+
 class Decoder {
 public:
     // Required for proper memory alignment when using Eigen in containers
@@ -16,8 +38,13 @@ public:
      * @brief Decoder: constructor
      * @param name: A string corresponding to the name of the decoder to store in the manager.
      * @param out: The out file path for writing files.
+     * @param pool: Optional pool the decoded frame buffer is taken from and returned to.
+     * @param solveCache: Optional cache of solved S_hat matrices, a hit skips the Laplacian and the solve.
+     * @param topologies: Optional store the triangle list is shared through, without it the decoder keeps its own
+     *        (topology id 0).
      */
-    Decoder(const std::string& name);
+    Decoder(const std::string& name, std::shared_ptr<BufferPool> pool = nullptr,
+            std::shared_ptr<SolveCache> solveCache = nullptr, std::shared_ptr<TopologyStore> topologies = nullptr);
     ~Decoder();
 
     /**
@@ -27,11 +54,50 @@ public:
     void LoadSequence(const std::string& directoryPath);
 
     /**
-     * @brief DecodeSequence: Decode the loaded sequence.
+     * @brief LoadSequence: Loads one subsequence of a packed sequence container into memory.
+     *        The matrices are used in place from the container's memory map (or from the one range request
+     *        that fetched them when the container is streamed).
+     * @param container: The opened container.
+     * @param index: The subsequence to load (0-indexed).
+     */
+    void LoadSequence(const TVMIO::SequenceContainer& container, int index);
+
+    /**
+     * @brief LoadSequence: Loads one subsequence out of a sequence folder, zip or server, reading only its files.
+     * @param source: The opened sequence.
+     * @param folder: The subsequence folder name (e.g. "subsequence_001").
+     */
+    void LoadSequence(const TVMIO::SequenceSource& source, const std::string& folder);
+
+    /**
+     * @brief DecodeSequence: Decode the loaded sequence, running whichever of BuildLaplacian, Solve and Reconstruct
+     *        are left in turn.
      * @return A bool correlating to success.
      */
     bool DecodeSequence();
 
+    /**
+     * @brief BuildLaplacian: First decode stage, build the anchored Laplacian L_star of the reference mesh.
+     *        With a solve cache that holds S_hat for this subsequence's inputs, S_hat is mapped from it instead
+     *        and the decoder goes straight to the Solved stage.
+     *        The stages can run on different threads, but only one at a time and in order.
+     * @return False if the decoder is not at the Loaded stage.
+     */
+    bool BuildLaplacian();
+
+    /**
+     * @brief Solve: Second decode stage, solve L_star * S_hat = dHat in the least squares sense, and store S_hat in
+     *        the solve cache when there is one.
+     * @return False if the decoder is not at the LaplacianBuilt stage.
+     */
+    bool Solve();
+
+    /**
+     * @brief Reconstruct: Last decode stage, compute S_hat * B + T and cache every frame's displacements.
+     * @return False if the decoder is not at the Solved stage.
+     */
+    bool Reconstruct();
+
     /**
      * @brief DecodeObjs: Output a sequence of .OBJs from the encoded sequence
      * @return A vector of strings that represent the files paths for the decoded .OBJ files.
@@ -54,36 +120,102 @@ public:
     // Getter functions
     const std::string& GetName() const { return decoderName; }
     int GetTotalFrames() const { return totalFrames; }
-    bool IsDecoded() const { return isDecoded; }
+    DecodeStage GetStage() const { return stage; }
+    bool IsDecoded() const { return stage == DecodeStage::Decoded; }
+    bool IsLoaded() const { return stage >= DecodeStage::Loaded; }
     int GetVertexCount() const { return verticesPerFrame; }
-    std::vector<int> GetTriangleIndicesFlat() const { return triangleIndicesFlat; }
-    const double* GetReferenceVertices() { return referenceVertexBuffer.data(); }
+    // The triangle list's indices refer to the vertices of the frames and of GetReferenceVertices, both come in the
+    // list's vertex order when the topology store reordered it for the vertex caches
+    const std::vector<int>& GetTriangleIndicesFlat() const { return topology ? topology->indices : kNoIndices; }
+    const int* GetTriangleIndexData() const { return GetTriangleIndicesFlat().data(); }  // Valid while loaded
+    size_t GetTriangleIndexCount() const { return GetTriangleIndicesFlat().size(); }
+    // Equal for decoders sharing a triangle list, 0 when none is loaded or it is not interned
+    uint64_t GetTopologyId() const { return topology ? topology->id : 0; }
+    const std::shared_ptr<const Topology>& GetTopology() const { return topology; }  // nullptr before a load
+    const std::vector<double>& GetReferenceVertices() const { return referenceVertexBuffer; }  // x, y, z per vertex
+
+    /**
+     * @brief GetResidentBytes: The memory the decoder holds at its current stage: the parsed files, the mesh, the
+     *        stage intermediates and the frame cache. Matrices viewing a container map count too, their pages stay
+     *        resident while the decoder uses them. Not safe while a stage runs on another thread.
+     */
+    size_t GetResidentBytes() const;
+
+    /**
+     * @brief TryClaim: Claim the decoder to run its load or its next decode stage. A decoder shared by several
+     *        playback instances runs each stage once, for whichever instance claims it first, and the others find
+     *        the stage done. Release the claim after reading what the stage changed (e.g. GetResidentBytes).
+     * @return False if another thread holds the claim.
+     */
+    bool TryClaim() { return !claimed.exchange(true, std::memory_order_acquire); }
+    void ReleaseClaim();
+
+    /**
+     * @brief WaitForClaim: Block until no thread holds the claim, for a caller that needs the stage another
+     *        instance is running. The claim may be taken again by the time it returns.
+     */
+    void WaitForClaim();
+
+    // The solver settings, part of what identifies a decoded subsequence
+    static constexpr int kSolveIterations = 500;
+    static constexpr double kSolveTolerance = 1e-6;
 
     // Memory cleanup
     void Clear();
 
+    /**
+     * @brief Reset: Empty the decoder so it can be reused for another subsequence. Unlike Clear the allocations
+     *        are kept (frame buffer, mesh and vertex buffers), the next subsequence's load and decode reuse
+     *        them when its dimensions fit.
+     * @param name: The name of the decoder for its next subsequence.
+     */
+    void Reset(const std::string& name);
+
 private:
-    // Helper function for common processing after data is loaded
-    bool ProcessLoadedData();
+    // Check the decoder is at the stage a decode step needs
+    bool RequireStage(DecodeStage required, const char* step) const;
+
+    // Share the loaded triangle list through the store, or keep it when there is none
+    void SetTopology(std::vector<int> indices, int vertexCount);
+
+    // Parse the reference mesh and its flat triangle indices from .obj text
+    void LoadReferenceMesh(const TVMIO::ByteView& obj);
+
+    // The loaded vertex of each vertex handed out, nullptr when they are handed out as loaded
+    const std::vector<int>* GetVertexOrder() const {
+        return topology && !topology->vertexOrder.empty() ? &topology->vertexOrder : nullptr;
+    }
+
+    // Hash everything the solve depends on, the key of S_hat in the solve cache
+    uint64_t GetSolveKey() const;
 
     std::string decoderName;
 
     // Decoding data
     SimpleMesh::Mesh decodedReferenceMesh;
-    Eigen::MatrixXd dHat, bMatrix, tMatrix, S_hat, T_hat, tMean;
+    MatrixIO::MappedMatrix dHat, bMatrix, tMatrix;
+    MatrixIO::MappedMatrix S_hat;  // Solved, or mapped from the solve cache
     Eigen::SparseMatrix<double> l_star;
 
-    // Decoded buffers
-    std::vector<std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d>>> decodedFrames;
+    // Decoded buffers, decodedVertexBuffer holds every frame's displacements as xyz triplets
+    std::shared_ptr<BufferPool> bufferPool;
+    std::shared_ptr<SolveCache> solveCache;
+    std::shared_ptr<TopologyStore> topologyStore;
+    uint64_t solveKey = 0;
     std::vector<double> decodedVertexBuffer;
     std::vector<double> referenceVertexBuffer;
-    std::vector<int> triangleIndicesFlat;
+    std::shared_ptr<const Topology> topology;  // Interned, possibly shared with other decoders
     std::vector<int> anchor_indices;
 
     // State
     int totalFrames = 0;
     int verticesPerFrame = 0;
-    bool isDecoded = false;
+    std::atomic<DecodeStage> stage{DecodeStage::Empty};  // Read by the playback thread while a worker loads or decodes
+    std::atomic<bool> claimed{false};
+    std::mutex claimMutex;                     // Only for waiting on the claim, TryClaim takes no lock
+    std::condition_variable claimReleased;
+
+    static const std::vector<int> kNoIndices;
 };
 
 } // namespace TVMDecoder
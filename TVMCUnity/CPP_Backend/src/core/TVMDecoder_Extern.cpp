@@ -3,12 +3,180 @@
 #include "TVMDecoder.h"
 #include "PlaybackManager.h"
 #include "TVMLogger.h"
+#include "MatrixIO.h"
+#include "ByteSource.h"
 #include <cstring>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <climits>
 #include <mutex>
 
 std::shared_ptr<PlaybackManager> g_playbackManager;
+uint64_t g_readaheadBytes = PlaybackManager::kDefaultReadaheadBytes;
+int g_jobWorkers = 0;
+uint64_t g_memoryBudget = 0;
+int g_livePollIntervalMs = LiveOptions().pollIntervalMs;
+bool g_optimizeIndexOrder = false;
+std::shared_ptr<TVMDecoder::SolveCache> g_solveCache;
+
+// The instances created by handle, in a fixed table the Instance functions read without a lock (every frame, on
+// the render thread). A handle's slot is handle % kMaxInstances, a handle is only reused after wrapping around
+// INT_MAX. g_instanceMutex only serializes creating and destroying instances
+struct InstanceEntry {
+    int handle = 0;
+    std::shared_ptr<PlaybackManager> manager;
+};
+constexpr int kMaxInstances = 64;
+std::shared_ptr<const InstanceEntry> g_instances[kMaxInstances];
+std::mutex g_instanceMutex;
+int g_nextHandle = 1;
+std::atomic<int> g_instanceCount{0};
+
+// The instances and g_playbackManager share one context (workers, memory budget, frame buffers) while any of them
+// is alive, the settings above apply to the next context created
+std::mutex g_contextMutex;
+std::weak_ptr<TVMDecoder::PlaybackContext> g_context;
+
+namespace {
+
+std::shared_ptr<TVMDecoder::PlaybackContext> GetLiveContext() {
+    std::lock_guard<std::mutex> lock(g_contextMutex);
+    return g_context.lock();
+}
+
+std::shared_ptr<TVMDecoder::PlaybackContext> GetSharedContext() {
+    if (auto context = GetLiveContext()) {
+        return context;
+    }
+    // Built outside of the lock, it starts the workers. When two threads race, the second context is dropped
+    // (after the lock is released, it joins its workers)
+    auto created = std::make_shared<TVMDecoder::PlaybackContext>(g_jobWorkers, g_memoryBudget, g_solveCache,
+                                                                 g_optimizeIndexOrder);
+    std::lock_guard<std::mutex> lock(g_contextMutex);
+    if (auto context = g_context.lock()) {
+        return context;
+    }
+    g_context = created;
+    return created;
+}
+
+LiveOptions GetLiveOptions(float latencySeconds) {
+    LiveOptions live;
+    live.enabled = true;
+    live.latencySeconds = latencySeconds;
+    live.pollIntervalMs = g_livePollIntervalMs;
+    return live;
+}
+
+bool InitializeManager(const char* path, int memLoad, int decodeLoad, bool enableLogging, bool waitForWindow,
+                       const LiveOptions& live = LiveOptions()) {
+    // Free the last one first, so its memory is back (and new settings apply) when nothing else plays
+    g_playbackManager.reset();
+    try {
+        g_playbackManager = std::make_shared<PlaybackManager>(
+            std::string(path), memLoad, decodeLoad, enableLogging, GetSharedContext(), g_readaheadBytes, waitForWindow, live);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("[PlaybackManager] ❌ Failed to initialize the playback manager: ", e.what());
+        return false;
+    }
+}
+
+int CreateInstance(const char* path, int memLoad, int decodeLoad, bool enableLogging, bool waitForWindow,
+                   const LiveOptions& live = LiveOptions()) {
+    if (!path) return 0;
+    try {
+        auto entry = std::make_shared<InstanceEntry>();
+        entry->manager = std::make_shared<PlaybackManager>(
+            std::string(path), memLoad, decodeLoad, enableLogging, GetSharedContext(), g_readaheadBytes, waitForWindow, live);
+        std::lock_guard<std::mutex> lock(g_instanceMutex);
+        if (g_instanceCount.load() >= kMaxInstances) {
+            LOG_ERROR("[PlaybackManager] ❌ Failed to create an instance: ", kMaxInstances, " instances are alive");
+            return 0;
+        }
+        // The next handle whose slot is free, there is one since fewer than kMaxInstances are alive
+        while (std::atomic_load(&g_instances[g_nextHandle % kMaxInstances])) {
+            g_nextHandle = g_nextHandle < INT_MAX ? g_nextHandle + 1 : 1;
+        }
+        entry->handle = g_nextHandle;
+        g_nextHandle = g_nextHandle < INT_MAX ? g_nextHandle + 1 : 1;
+        std::atomic_store(&g_instances[entry->handle % kMaxInstances], std::shared_ptr<const InstanceEntry>(entry));
+        ++g_instanceCount;
+        return entry->handle;
+    } catch (const std::exception& e) {
+        LOG_ERROR("[PlaybackManager] ❌ Failed to create an instance: ", e.what());
+        return 0;
+    }
+}
+
+std::shared_ptr<PlaybackManager> GetInstance(int handle) {
+    if (handle <= 0) return nullptr;
+    const auto entry = std::atomic_load(&g_instances[handle % kMaxInstances]);
+    return entry && entry->handle == handle ? entry->manager : nullptr;
+}
+
+void CopyFrame(PlaybackManager* manager, int frameIndex, float* outVertices) {
+    if (!manager || !outVertices) return;
+    try {
+        const auto& deformed = manager->fetchFrame(frameIndex);
+        if (deformed.empty()) return; // Handle race condition
+        for (size_t i = 0; i < deformed.size(); ++i) {
+            outVertices[i * 3 + 0] = static_cast<float>(deformed[i].x());
+            outVertices[i * 3 + 1] = static_cast<float>(deformed[i].y());
+            outVertices[i * 3 + 2] = static_cast<float>(deformed[i].z());
+        }
+    } catch (...) {
+        // Handle error
+    }
+}
+
+int GetTotalFrames(PlaybackManager* manager) {
+    auto decoder = manager ? manager->getCurrentDecoder() : nullptr;
+    return decoder ? decoder->GetTotalFrames() : 0;
+}
+
+int GetVertexCount(PlaybackManager* manager) {
+    auto decoder = manager ? manager->getCurrentDecoder() : nullptr;
+    return decoder ? decoder->GetVertexCount() : 0;
+}
+
+int GetTriangleIndexCount(PlaybackManager* manager) {
+    auto decoder = manager ? manager->getCurrentDecoder() : nullptr;
+    return decoder ? static_cast<int>(decoder->GetTriangleIndicesFlat().size()) : 0;
+}
+
+void CopyTriangleIndices(PlaybackManager* manager, int* outIndices, int maxCount) {
+    auto decoder = manager ? manager->getCurrentDecoder() : nullptr;
+    if (!decoder || !outIndices || maxCount <= 0) return;
+    const std::vector<int>& indices = decoder->GetTriangleIndicesFlat();
+    std::copy_n(indices.begin(), std::min(indices.size(), static_cast<size_t>(maxCount)), outIndices);
+    if (indices.size() <= static_cast<size_t>(maxCount)) {
+        manager->MarkTopologyUploaded();
+    }
+}
+
+bool GetAcmr(PlaybackManager* manager, float* outBefore, float* outAfter) {
+    auto decoder = manager ? manager->getCurrentDecoder() : nullptr;
+    const auto topology = decoder ? decoder->GetTopology() : nullptr;
+    if (outBefore) *outBefore = topology ? topology->acmrBefore : 0.0f;
+    if (outAfter) *outAfter = topology ? topology->acmrAfter : 0.0f;
+    return topology != nullptr;
+}
+
+const int* GetTriangleIndexPointer(PlaybackManager* manager) {
+    auto decoder = manager ? manager->getCurrentDecoder() : nullptr;
+    return decoder && decoder->GetTriangleIndexCount() > 0 ? decoder->GetTriangleIndexData() : nullptr;
+}
+
+void CopyReferenceVertices(PlaybackManager* manager, float* outVertices) {
+    auto decoder = manager ? manager->getCurrentDecoder() : nullptr;
+    if (!decoder || !outVertices) return;
+    const std::vector<double>& vertices = decoder->GetReferenceVertices();
+    std::transform(vertices.begin(), vertices.end(), outVertices, [](double value) { return static_cast<float>(value); });
+}
+
+} // namespace
 
 extern "C" {
 
@@ -21,15 +189,331 @@ extern "C" {
  * @return
  */
 bool InitializePlaybackManager(const char* path, int memLoad, int decodeLoad, bool enableLogging) {
-    try {
-        g_playbackManager = std::make_shared<PlaybackManager>(
-            std::string(path), memLoad, decodeLoad,  enableLogging);
-        return true;
-    } catch (const std::exception& e) {
-        return false;
+    return InitializeManager(path, memLoad, decodeLoad, enableLogging, true);
+}
+
+/**
+ * @brief InitializePlaybackManagerAsync: Like InitializePlaybackManager, but returns right away instead of waiting
+ *        for the first window. The first job opens the sequence, then subsequence 1 is decoded ahead of every other
+ *        job and the rest of the window fills in the background: poll GetInitState (calling Tick every frame as
+ *        usual), playback can start at 1 (first frame), -1 if the sequence could not be opened.
+ * @return False if the playback manager could not be created.
+ */
+bool InitializePlaybackManagerAsync(const char* path, int memLoad, int decodeLoad, bool enableLogging) {
+    return InitializeManager(path, memLoad, decodeLoad, enableLogging, false);
+}
+
+/**
+ * @brief GetInitState: How far the first window got: -1 failed (empty or unreadable sequence), 0 loading,
+ *        1 the first frame is ready (the window still fills), 2 the decode window is decoded.
+ */
+int GetInitState() {
+    if (!g_playbackManager) return static_cast<int>(PlaybackInitState::Failed);
+    return static_cast<int>(g_playbackManager->GetInitState());
+}
+
+/**
+ * @brief GetTimeToFirstFrameMs: The time from initialization until the first frame was decoded, -1 before that.
+ */
+float GetTimeToFirstFrameMs() {
+    if (!g_playbackManager) return -1.0f;
+    return static_cast<float>(g_playbackManager->GetTimeToFirstFrameMs());
+}
+
+/**
+ * @brief DestroyPlaybackManager: Free the playback manager, its queued jobs are dropped and running ones waited for.
+ */
+void DestroyPlaybackManager() {
+    g_playbackManager.reset();
+}
+
+/**
+ * @brief InitializeLivePlaybackManager: Play a sequence folder (local or http://) while it is still being encoded.
+ *        The encoder writes "segment.complete" into each subsequence folder after its last file; playback starts at
+ *        the newest complete subsequence, waits there for the next one and picks new ones up as they are completed.
+ *        Returns like InitializePlaybackManagerAsync, poll GetInitState (it stays 0 until the first subsequence is
+ *        complete and decoded) and call Tick or Play.
+ * @param latencySeconds: How far behind the newest complete subsequence playback may fall before it jumps ahead
+ *        (see SetLiveLatency).
+ * @return False if the playback manager could not be created.
+ */
+bool InitializeLivePlaybackManager(const char* path, int memLoad, int decodeLoad, float latencySeconds, bool enableLogging) {
+    return InitializeManager(path, memLoad, decodeLoad, enableLogging, false, GetLiveOptions(latencySeconds));
+}
+
+/**
+ * @brief CreatePlaybackInstance: Create one of several sequences playing at once. Every instance shares one pool of
+ *        workers (jobs run in deadline order across the instances, the ones at the same distance from their
+ *        playheads take turns) and one memory budget (split fairly between the instances that need it). Configure
+ *        them with SetJobWorkerCount/SetMemoryBudget/SetSolveCacheDirectory before the first instance.
+ * @param path: See InitializePlaybackManager.
+ * @return The handle to pass to the Instance functions, 0 if the instance could not be created (or 64 are alive).
+ */
+int CreatePlaybackInstance(const char* path, int memLoad, int decodeLoad, bool enableLogging) {
+    return CreateInstance(path, memLoad, decodeLoad, enableLogging, true);
+}
+
+/**
+ * @brief CreatePlaybackInstanceAsync: Like CreatePlaybackInstance, but returns without waiting for the first
+ *        window (see InitializePlaybackManagerAsync), poll InstanceGetInitState.
+ */
+int CreatePlaybackInstanceAsync(const char* path, int memLoad, int decodeLoad, bool enableLogging) {
+    return CreateInstance(path, memLoad, decodeLoad, enableLogging, false);
+}
+
+/**
+ * @brief CreateLivePlaybackInstance: Like InitializeLivePlaybackManager, for one of several instances.
+ */
+int CreateLivePlaybackInstance(const char* path, int memLoad, int decodeLoad, float latencySeconds, bool enableLogging) {
+    return CreateInstance(path, memLoad, decodeLoad, enableLogging, false, GetLiveOptions(latencySeconds));
+}
+
+/**
+ * @brief DestroyPlaybackInstance: Free an instance, its part of the memory budget goes to the others. The handle is
+ *        invalid afterwards, the Instance functions ignore it.
+ */
+void DestroyPlaybackInstance(int handle) {
+    if (handle <= 0) return;
+    std::shared_ptr<const InstanceEntry> entry;
+    {
+        std::lock_guard<std::mutex> lock(g_instanceMutex);
+        auto& slot = g_instances[handle % kMaxInstances];
+        entry = std::atomic_load(&slot);
+        if (!entry || entry->handle != handle) return;
+        std::atomic_store(&slot, std::shared_ptr<const InstanceEntry>());
+        --g_instanceCount;
+    }
+    // Destroyed outside the lock (once no Instance call holds it), it waits for the instance's running jobs
+    entry.reset();
+}
+
+int GetPlaybackInstanceCount() {
+    return g_instanceCount.load();
+}
+
+/**
+ * @brief GetSharedDecoderCount: The number of distinct subsequences the instances hold, instances playing the same
+ *        sequence share one decoder per subsequence (from its load on) instead of each decoding its own.
+ */
+int GetSharedDecoderCount() {
+    auto context = GetLiveContext();
+    return context ? static_cast<int>(context->GetDecodedCache()->GetStats().entries) : 0;
+}
+
+/**
+ * @brief GetSharedDecodeHitCount: The number of subsequence loads served by a decoder another instance held.
+ */
+long long GetSharedDecodeHitCount() {
+    auto context = GetLiveContext();
+    return context ? static_cast<long long>(context->GetDecodedCache()->GetStats().hits) : 0;
+}
+
+/**
+ * @brief GetSharedTopologyCount: The number of distinct triangle lists the instances' decoders hold, subsequences
+ *        with the same topology share one.
+ */
+int GetSharedTopologyCount() {
+    auto context = GetLiveContext();
+    return context ? static_cast<int>(context->GetTopologyStore()->GetStats().entries) : 0;
+}
+
+/**
+ * @brief GetSharedTopologyHitCount: The number of subsequence loads whose triangle list was already held.
+ */
+long long GetSharedTopologyHitCount() {
+    auto context = GetLiveContext();
+    return context ? static_cast<long long>(context->GetTopologyStore()->GetStats().hits) : 0;
+}
+
+/**
+ * @brief SetOptimizeIndexOrder: Reorder every distinct triangle list for the GPU's vertex caches when it is loaded
+ *        (Forsyth's algorithm), and hand out the vertices in the order the reordered list first uses them. The
+ *        geometry and the decoded positions are the same, only their order changes, so fewer vertices are shaded
+ *        per triangle. Call before InitializePlaybackManager (or the first instance), off by default.
+ */
+void SetOptimizeIndexOrder(bool enabled) {
+    g_optimizeIndexOrder = enabled;
+}
+
+/**
+ * @brief GetIndexOrderAcmr: The average cache miss ratio (vertices shaded per triangle with a 16 entry FIFO cache)
+ *        of the triangle lists loaded so far, weighted by their triangles.
+ * @param outBefore: Receives the ratio in the order the lists were encoded.
+ * @param outAfter: Receives the ratio in the order they are drawn, the same when SetOptimizeIndexOrder is off.
+ * @return False when nothing was loaded yet.
+ */
+bool GetIndexOrderAcmr(float* outBefore, float* outAfter) {
+    auto context = GetLiveContext();
+    const TVMDecoder::TopologyStoreStats stats = context ? context->GetTopologyStore()->GetStats()
+                                                         : TVMDecoder::TopologyStoreStats();
+    if (outBefore) *outBefore = stats.acmrBefore;
+    if (outAfter) *outAfter = stats.acmrAfter;
+    return stats.lookups > 0;
+}
+
+int InstanceTick(int handle) {
+    auto instance = GetInstance(handle);
+    return instance ? instance->Tick() : 0;
+}
+
+bool InstanceAdvanceSubSequence(int handle) {
+    auto instance = GetInstance(handle);
+    return instance && instance->AdvanceSubSequence();
+}
+
+void InstanceRequestWindow(int handle, int subSequence) {
+    if (auto instance = GetInstance(handle)) instance->RequestWindow(subSequence);
+}
+
+int InstanceSeek(int handle, long long globalFrame) {
+    auto instance = GetInstance(handle);
+    return instance ? instance->Seek(globalFrame) : -1;
+}
+
+bool InstanceIsSeekPending(int handle) {
+    auto instance = GetInstance(handle);
+    return instance && instance->IsSeekPending();
+}
+
+void InstanceSetPlaybackRate(int handle, float rate) {
+    if (auto instance = GetInstance(handle)) instance->SetPlaybackRate(rate);
+}
+
+void InstancePlay(int handle) {
+    if (auto instance = GetInstance(handle)) instance->Play();
+}
+
+void InstancePause(int handle) {
+    if (auto instance = GetInstance(handle)) instance->Pause();
+}
+
+void InstanceSetLooping(int handle, bool loop) {
+    if (auto instance = GetInstance(handle)) instance->SetLooping(loop);
+}
+
+void InstanceSetPlaybackTime(int handle, double seconds) {
+    if (auto instance = GetInstance(handle)) instance->SetPlaybackTime(seconds);
+}
+
+double InstanceGetPlaybackTime(int handle) {
+    auto instance = GetInstance(handle);
+    return instance ? instance->GetPlaybackTime() : 0.0;
+}
+
+bool InstanceGetFrameForTime(int handle, double seconds, int* outSubSequence, int* outFrame) {
+    auto instance = GetInstance(handle);
+    int subSequence = 0, frame = 0;
+    const bool found = instance && instance->GetFrameForTime(seconds, subSequence, frame);
+    if (outSubSequence) *outSubSequence = subSequence;
+    if (outFrame) *outFrame = frame;
+    return found;
+}
+
+int InstanceGetInitState(int handle) {
+    auto instance = GetInstance(handle);
+    return static_cast<int>(instance ? instance->GetInitState() : PlaybackInitState::Failed);
+}
+
+float InstanceGetTimeToFirstFrameMs(int handle) {
+    auto instance = GetInstance(handle);
+    return instance ? static_cast<float>(instance->GetTimeToFirstFrameMs()) : -1.0f;
+}
+
+void InstanceSetAdaptiveWindow(int handle, float targetMargin, long long maxBytes) {
+    if (auto instance = GetInstance(handle)) {
+        instance->SetAdaptiveWindow(targetMargin, static_cast<uint64_t>(std::max(maxBytes, 0LL)));
     }
 }
 
+int InstanceGetPreloadWindowSize(int handle) {
+    auto instance = GetInstance(handle);
+    return instance ? instance->GetPreloadWindow() : 0;
+}
+
+int InstanceGetDecodeWindowSize(int handle) {
+    auto instance = GetInstance(handle);
+    return instance ? instance->GetDecodeWindow() : 0;
+}
+
+float InstanceGetWindowMargin(int handle) {
+    auto instance = GetInstance(handle);
+    return instance ? static_cast<float>(instance->GetWindowTuning().margin) : 0.0f;
+}
+
+void InstanceSetLiveLatency(int handle, float latencySeconds) {
+    if (auto instance = GetInstance(handle)) instance->SetLiveLatency(latencySeconds);
+}
+
+double InstanceGetLiveLatency(int handle) {
+    auto instance = GetInstance(handle);
+    return instance ? instance->GetLiveLatency() : 0.0;
+}
+
+int InstanceGetCurrentSubSequence(int handle) {
+    auto instance = GetInstance(handle);
+    return instance ? instance->GetCurrentSubSequence() : 0;
+}
+
+int InstanceGetSubSequenceCount(int handle) {
+    auto instance = GetInstance(handle);
+    return instance ? instance->getSubSequenceCount() : 0;
+}
+
+void InstanceFetchFrame(int handle, int frameIndex, float* outVertices) {
+    CopyFrame(GetInstance(handle).get(), frameIndex, outVertices);
+}
+
+int InstanceGetTotalFrames(int handle) {
+    return GetTotalFrames(GetInstance(handle).get());
+}
+
+int InstanceGetVertexCount(int handle) {
+    return GetVertexCount(GetInstance(handle).get());
+}
+
+int InstanceGetTriangleIndexCount(int handle) {
+    return GetTriangleIndexCount(GetInstance(handle).get());
+}
+
+void InstanceGetTriangleIndices(int handle, int* outIndices, int maxCount) {
+    CopyTriangleIndices(GetInstance(handle).get(), outIndices, maxCount);
+}
+
+void InstanceGetReferenceVertices(int handle, float* outVertices) {
+    CopyReferenceVertices(GetInstance(handle).get(), outVertices);
+}
+
+long long InstanceGetTopologyId(int handle) {
+    auto instance = GetInstance(handle);
+    return instance ? static_cast<long long>(instance->GetTopologyId()) : 0;
+}
+
+bool InstanceTopologyChanged(int handle) {
+    auto instance = GetInstance(handle);
+    return !instance || instance->TopologyChanged();
+}
+
+const int* InstanceGetTriangleIndicesPointer(int handle) {
+    return GetTriangleIndexPointer(GetInstance(handle).get());
+}
+
+void InstanceMarkTopologyUploaded(int handle) {
+    auto instance = GetInstance(handle);
+    if (instance) instance->MarkTopologyUploaded();
+}
+
+bool InstanceGetAcmr(int handle, float* outBefore, float* outAfter) {
+    return GetAcmr(GetInstance(handle).get(), outBefore, outAfter);
+}
+
+/**
+ * @brief InstanceGetMemoryUsage: The bytes held by the decoders of an instance's window.
+ */
+long long InstanceGetMemoryUsage(int handle) {
+    auto instance = GetInstance(handle);
+    return instance ? static_cast<long long>(instance->GetCacheStats().residentBytes) : 0;
+}
+
 /**
  * @brief AdvanceSubSequence: Advance to the next SubSequence
  */
@@ -43,7 +527,238 @@ bool AdvanceSubSequence() {
 }
 
 /**
- * @brief LoadSubsequence: Load a SubSequence into memory
+ * @brief RequestWindow: Start the playback window at a SubSequence, the plugin loads and decodes the window on its
+ *        own workers (nearest first) and cancels queued work that fell out of it.
+ */
+void RequestWindow(int subSequence) {
+    if (!g_playbackManager) return;
+    g_playbackManager->RequestWindow(subSequence);
+}
+
+/**
+ * @brief Seek: Jump to a frame of the whole sequence, decoding its subsequence first. While it is not decoded the
+ *        nearest decoded frame plays, seek again (e.g. every frame while scrubbing) until IsSeekPending is false.
+ * @param globalFrame: The frame (0-indexed) of the whole sequence.
+ * @return The frame to pass to FetchFrame, -1 when nothing is decoded yet.
+ */
+int Seek(long long globalFrame) {
+    if (!g_playbackManager) return -1;
+    return g_playbackManager->Seek(globalFrame);
+}
+
+/**
+ * @brief IsSeekPending: Check if the last Seek landed on a nearby frame because its subsequence is still decoding.
+ */
+bool IsSeekPending() {
+    if (!g_playbackManager) return false;
+    return g_playbackManager->IsSeekPending();
+}
+
+/**
+ * @brief GetCurrentSubSequence: The subsequence (1-indexed) FetchFrame reads from.
+ */
+int GetCurrentSubSequence() {
+    if (!g_playbackManager) return 0;
+    return g_playbackManager->GetCurrentSubSequence();
+}
+
+/**
+ * @brief GetSubSequenceStartFrame: The frame of the whole sequence a subsequence (1-indexed) starts at.
+ */
+long long GetSubSequenceStartFrame(int subSequence) {
+    if (!g_playbackManager) return 0;
+    return g_playbackManager->GetSubSequenceStartFrame(subSequence);
+}
+
+/**
+ * @brief SetPlaybackRate: Set the speed and direction frames are played at, negative plays backwards. The window
+ *        prefetches in the direction of playback and skips whole subsequences when they play faster than they decode.
+ * @param rate: Frames played per frame of the sequence's own rate, e.g. 2 for double speed, -1 for reverse.
+ */
+void SetPlaybackRate(float rate) {
+    if (!g_playbackManager) return;
+    g_playbackManager->SetPlaybackRate(rate);
+}
+
+float GetPlaybackRate() {
+    if (!g_playbackManager) return 1.0f;
+    return g_playbackManager->GetPlaybackRate();
+}
+
+/**
+ * @brief GetWindowStep: The subsequences AdvanceSubSequence moves by, negative backwards, more than 1 when skipping.
+ */
+int GetWindowStep() {
+    if (!g_playbackManager) return 1;
+    return g_playbackManager->GetWindowStep();
+}
+
+/**
+ * @brief GetStallCount: How often playback reached the end of a subsequence before the next one was decoded while
+ *        playing at a rate (rounded to a quarter).
+ */
+long long GetStallCount(float rate) {
+    if (!g_playbackManager) return 0;
+    return g_playbackManager->GetStallCount(rate);
+}
+
+long long GetTotalStallCount() {
+    if (!g_playbackManager) return 0;
+    return g_playbackManager->GetTotalStallCount();
+}
+
+/**
+ * @brief Play: Start or resume the native playback clock. Its worker then moves and schedules the window ahead of
+ *        the clock, so the render thread only calls GetFrameForTime each frame (Tick and AdvanceSubSequence are
+ *        not needed anymore).
+ */
+void Play() {
+    if (!g_playbackManager) return;
+    g_playbackManager->Play();
+}
+
+void Pause() {
+    if (!g_playbackManager) return;
+    g_playbackManager->Pause();
+}
+
+bool IsPlaying() {
+    if (!g_playbackManager) return false;
+    return g_playbackManager->IsPlaying();
+}
+
+/**
+ * @brief SetLooping: Wrap around at the end of the sequence (the default), or pause there.
+ */
+void SetLooping(bool loop) {
+    if (!g_playbackManager) return;
+    g_playbackManager->SetLooping(loop);
+}
+
+/**
+ * @brief SetPlaybackTime: Move the playback clock, e.g. from a timeline. The clock holds until the subsequence at
+ *        the new time is decoded.
+ * @param seconds: The position in the whole sequence.
+ */
+void SetPlaybackTime(double seconds) {
+    if (!g_playbackManager) return;
+    g_playbackManager->SetPlaybackTime(seconds);
+}
+
+/**
+ * @brief GetPlaybackTime: The position of the playback clock in seconds, pass it to GetFrameForTime.
+ */
+double GetPlaybackTime() {
+    if (!g_playbackManager) return 0.0;
+    return g_playbackManager->GetPlaybackTime();
+}
+
+/**
+ * @brief IsBuffering: Check if the clock is held because the subsequence it reached is still decoding.
+ */
+bool IsBuffering() {
+    if (!g_playbackManager) return false;
+    return g_playbackManager->IsBuffering();
+}
+
+/**
+ * @brief SetAdaptiveWindow: Size the pre-load and decode windows from the measured load and decode times, so the
+ *        decoded subsequences ahead play for the target margin times as long as producing the next one takes. The
+ *        windows grow when decoding is slow or playback fast and shrink back when there is headroom. Not used under
+ *        a memory budget, which sizes the windows itself.
+ * @param targetMargin: The safety margin to keep, e.g. 2 for twice the decode time, 0 turns it off and keeps the
+ *        current windows.
+ * @param maxBytes: The most bytes the windows may hold, 0 for no ceiling.
+ */
+void SetAdaptiveWindow(float targetMargin, long long maxBytes) {
+    if (!g_playbackManager) return;
+    g_playbackManager->SetAdaptiveWindow(targetMargin, static_cast<uint64_t>(std::max(maxBytes, 0LL)));
+}
+
+int GetPreloadWindowSize() {
+    if (!g_playbackManager) return 0;
+    return g_playbackManager->GetPreloadWindow();
+}
+
+int GetDecodeWindowSize() {
+    if (!g_playbackManager) return 0;
+    return g_playbackManager->GetDecodeWindow();
+}
+
+/**
+ * @brief GetWindowMargin: How many times as long as producing a subsequence the decoded ones ahead play for, as
+ *        last measured by the adaptive window (0 before it has measured a load and a decode).
+ */
+float GetWindowMargin() {
+    if (!g_playbackManager) return 0.0f;
+    return static_cast<float>(g_playbackManager->GetWindowTuning().margin);
+}
+
+bool IsLivePlayback() {
+    return g_playbackManager && g_playbackManager->IsLive();
+}
+
+/**
+ * @brief SetLiveLatency: How far behind the newest complete subsequence a live sequence may fall before the clock
+ *        jumps ahead to it. Never less than one subsequence plus the time to decode one.
+ */
+void SetLiveLatency(float latencySeconds) {
+    if (!g_playbackManager) return;
+    g_playbackManager->SetLiveLatency(latencySeconds);
+}
+
+/**
+ * @brief GetLiveLatency: How far the clock is behind the end of the newest complete subsequence, in seconds.
+ */
+double GetLiveLatency() {
+    if (!g_playbackManager) return 0.0;
+    return g_playbackManager->GetLiveLatency();
+}
+
+/**
+ * @brief GetLiveSkipCount: How often the clock jumped ahead because it fell behind the live latency target.
+ */
+long long GetLiveSkipCount() {
+    if (!g_playbackManager) return 0;
+    return g_playbackManager->GetLiveSkipCount();
+}
+
+/**
+ * @brief SetPlaybackFrameRate: The frames per second the clock plays, 0 uses the manifest's rate (or 30).
+ */
+void SetPlaybackFrameRate(float frameRate) {
+    if (!g_playbackManager) return;
+    g_playbackManager->SetFrameRate(frameRate);
+}
+
+/**
+ * @brief GetFrameForTime: The decoded frame to show at a time of the playback clock. Its subsequence becomes the
+ *        current one, so FetchFrame and the GetCurrentDecoder calls read from it.
+ * @param seconds: The position in the whole sequence, usually GetPlaybackTime().
+ * @param outSubSequence: Receives the subsequence (1-indexed), set up the mesh again when it changes.
+ * @param outFrame: Receives the frame to pass to FetchFrame.
+ * @return False while the subsequence at the time is not decoded, the nearest frame of the current one is returned.
+ */
+bool GetFrameForTime(double seconds, int* outSubSequence, int* outFrame) {
+    int subSequence = 0, frame = 0;
+    const bool found = g_playbackManager && g_playbackManager->GetFrameForTime(seconds, subSequence, frame);
+    if (outSubSequence) *outSubSequence = subSequence;
+    if (outFrame) *outFrame = frame;
+    return found;
+}
+
+/**
+ * @brief Tick: Keep the playback window scheduled, call once per frame.
+ * @return The number of load and decode jobs queued or running.
+ */
+int Tick() {
+    if (!g_playbackManager) return 0;
+    return g_playbackManager->Tick();
+}
+
+/**
+ * @brief LoadSubsequence: Load a SubSequence into memory, waiting for it. Prefer RequestWindow/Tick, this runs on
+ *        the calling thread's time and only merges with the window's own load.
  */
 void LoadSubSequence(int subSequence) {
     if (!g_playbackManager) return;;
@@ -66,40 +781,368 @@ int getSubSequenceCount(){
  * @brief FetchFrame: Return the vertice positions for a given frame.
  */
 void FetchFrame(int frameIndex, float* outVertices) {
-    if (!g_playbackManager || !outVertices) return;
-    try {
-        const auto& deformed = g_playbackManager->fetchFrame(frameIndex);
-        if (deformed.empty()) return; // Handle race condition
-        for (size_t i = 0; i < deformed.size(); ++i) {
-            outVertices[i * 3 + 0] = static_cast<float>(deformed[i].x());
-            outVertices[i * 3 + 1] = static_cast<float>(deformed[i].y());
-            outVertices[i * 3 + 2] = static_cast<float>(deformed[i].z());
-        }
-    } catch (...) {
-        // Handle error
-    }
+    CopyFrame(g_playbackManager.get(), frameIndex, outVertices);
 }
 
 /**
  * @brief GetCurrentDecoderTotalFrames: Returns the total frames for the current SubSequence
  */
 int GetCurrentDecoderTotalFrames() {
-    if (!g_playbackManager) return 0;
-    auto decoder = g_playbackManager->getCurrentDecoder();
-    if (!decoder) return 0;
-    return decoder->GetTotalFrames();
+    return GetTotalFrames(g_playbackManager.get());
 }
 
 /**
  * @brief GetCurrentDecoderVertexCount: Get the current SubSeqeunce meshes vertex count
  */
 int GetCurrentDecoderVertexCount() {
+    return GetVertexCount(g_playbackManager.get());
+}
+
+/**
+ * @brief GetCurrentDecoderTriangleIndexCount: The number of triangle indices (3 per triangle) of the current
+ *        SubSequence's mesh.
+ */
+int GetCurrentDecoderTriangleIndexCount() {
+    return GetTriangleIndexCount(g_playbackManager.get());
+}
+
+/**
+ * @brief GetCurrentDecoderTriangleIndices: Copy the current SubSequence's triangle indices.
+ * @param outIndices: Receives up to maxCount indices.
+ * @param maxCount: The size of outIndices.
+ */
+void GetCurrentDecoderTriangleIndices(int* outIndices, int maxCount) {
+    CopyTriangleIndices(g_playbackManager.get(), outIndices, maxCount);
+}
+
+/**
+ * @brief GetCurrentDecoderTriangleIndicesPointer: The current SubSequence's triangle indices in place, no copy
+ *        (GetCurrentDecoderTriangleIndexCount ints). Valid until the current SubSequence changes, nullptr without one.
+ *        Call MarkTopologyUploaded after uploading from it.
+ */
+const int* GetCurrentDecoderTriangleIndicesPointer() {
+    return GetTriangleIndexPointer(g_playbackManager.get());
+}
+
+/**
+ * @brief GetCurrentTopologyId: The id of the current SubSequence's triangle list, equal for SubSequences with the
+ *        same topology. 0 without a current SubSequence.
+ */
+long long GetCurrentTopologyId() {
+    if (!g_playbackManager) return 0;
+    return static_cast<long long>(g_playbackManager->GetTopologyId());
+}
+
+/**
+ * @brief TopologyChanged: Whether the current SubSequence's triangle list differs from the one last uploaded
+ *        (copied with GetCurrentDecoderTriangleIndices, or marked with MarkTopologyUploaded). When it doesn't, the
+ *        index buffer and the mesh can stay as they are and only the vertices need updating.
+ */
+bool TopologyChanged() {
+    return !g_playbackManager || g_playbackManager->TopologyChanged();
+}
+
+/**
+ * @brief GetCurrentDecoderAcmr: The average cache miss ratio of the current SubSequence's triangle list as encoded
+ *        and as drawn (see GetIndexOrderAcmr).
+ * @return False without a current SubSequence.
+ */
+bool GetCurrentDecoderAcmr(float* outBefore, float* outAfter) {
+    return GetAcmr(g_playbackManager.get(), outBefore, outAfter);
+}
+
+/**
+ * @brief MarkTopologyUploaded: Record the current SubSequence's triangle list as uploaded, after reading it in
+ *        place through GetCurrentDecoderTriangleIndicesPointer.
+ */
+void MarkTopologyUploaded() {
+    if (!g_playbackManager) return;
+    g_playbackManager->MarkTopologyUploaded();
+}
+
+/**
+ * @brief GetCurrentDecoderReferenceVertices: Copy the current SubSequence's reference mesh, x, y, z per vertex
+ *        (GetCurrentDecoderVertexCount * 3 floats).
+ */
+void GetCurrentDecoderReferenceVertices(float* outVertices) {
+    CopyReferenceVertices(g_playbackManager.get(), outVertices);
+}
+
+/**
+ * @brief HasSequenceManifest: Checks if the sequence came with a manifest (containers always do).
+ *        The sequence/subsequence queries below only return real values when it did.
+ */
+bool HasSequenceManifest() {
+    return g_playbackManager && g_playbackManager->HasManifest();
+}
+
+/**
+ * @brief GetSequenceTotalFrames: The number of frames in the whole sequence.
+ */
+int GetSequenceTotalFrames() {
     if (!g_playbackManager) return 0;
-    auto decoder = g_playbackManager->getCurrentDecoder();
-    if (!decoder) return 0;
-    return decoder->GetVertexCount();
+    return static_cast<int>(g_playbackManager->GetTotalFrameCount());
+}
+
+/**
+ * @brief GetSequenceFrameRate: The capture frame rate from the manifest, 0 when unknown.
+ */
+float GetSequenceFrameRate() {
+    if (!g_playbackManager) return 0.0f;
+    return g_playbackManager->GetFrameRate();
 }
 
+/**
+ * @brief GetMaxVertexCount: The largest vertex count of any subsequence, 0 without a manifest.
+ */
+int GetMaxVertexCount() {
+    if (!g_playbackManager) return 0;
+    return g_playbackManager->GetMaxVertexCount();
+}
+
+/**
+ * @brief GetSubSequenceFrameCount: The frame count of a subsequence (1-indexed), 0 when unknown.
+ */
+int GetSubSequenceFrameCount(int subSequence) {
+    if (!g_playbackManager) return 0;
+    const TVMIO::SubSequenceInfo* info = g_playbackManager->GetSubSequenceInfo(subSequence);
+    return info ? static_cast<int>(info->frameCount) : 0;
+}
+
+/**
+ * @brief GetSubSequenceVertexCount: The vertex count of a subsequence (1-indexed), 0 when unknown.
+ */
+int GetSubSequenceVertexCount(int subSequence) {
+    if (!g_playbackManager) return 0;
+    const TVMIO::SubSequenceInfo* info = g_playbackManager->GetSubSequenceInfo(subSequence);
+    return info ? static_cast<int>(info->vertexCount) : 0;
+}
+
+/**
+ * @brief GetSubSequenceTriangleCount: The triangle count of a subsequence (1-indexed), 0 when unknown.
+ */
+int GetSubSequenceTriangleCount(int subSequence) {
+    if (!g_playbackManager) return 0;
+    const TVMIO::SubSequenceInfo* info = g_playbackManager->GetSubSequenceInfo(subSequence);
+    return info ? static_cast<int>(info->triangleCount) : 0;
+}
+
+/**
+ * @brief GetSubSequenceByteSize: The stored size of a subsequence's data (1-indexed), 0 when unknown.
+ */
+long long GetSubSequenceByteSize(int subSequence) {
+    if (!g_playbackManager) return 0;
+    const TVMIO::SubSequenceInfo* info = g_playbackManager->GetSubSequenceInfo(subSequence);
+    return info ? static_cast<long long>(info->TotalBytes()) : 0;
+}
+
+/**
+ * @brief SetMatrixLoadLimits: Set the maximum matrix dimensions accepted from binary files.
+ *        Raise these for very large captures, the defaults are 1000000 rows x 1000 columns.
+ */
+void SetMatrixLoadLimits(long long maxRows, long long maxCols) {
+    MatrixIO::LoadLimits limits;
+    limits.maxRows = maxRows;
+    limits.maxCols = maxCols;
+    MatrixIO::SetLoadLimits(limits);
+}
+
+/**
+ * @brief SetHttpStreamingOptions: Limits for sequences streamed from an http:// URL. Call before
+ *        InitializePlaybackManager, values below 0 keep the current setting.
+ * @param maxConcurrentRequests: Requests in flight at once (default 4).
+ * @param maxRetries: Extra attempts after a network error, timeout or 5xx response (default 3, at most 10).
+ * @param timeoutMs: Connect, send and receive timeout per request (default 10000).
+ */
+void SetHttpStreamingOptions(int maxConcurrentRequests, int maxRetries, int timeoutMs) {
+    TVMIO::HttpOptions options = TVMIO::HttpSource::GetOptions();
+    if (maxConcurrentRequests >= 0) options.maxConcurrentRequests = std::max(1, maxConcurrentRequests);
+    if (maxRetries >= 0) options.maxRetries = std::min(maxRetries, 10);
+    if (timeoutMs >= 0) options.timeoutMs = std::max(1, timeoutMs);
+    TVMIO::HttpSource::SetOptions(options);
+}
+
+/**
+ * @brief GetHttpBytesReceived: The number of bytes streamed over HTTP so far.
+ */
+long long GetHttpBytesReceived() {
+    return static_cast<long long>(TVMIO::HttpSource::GetStats().bytesReceived);
+}
+
+/**
+ * @brief GetHttpRetryCount: The number of HTTP requests that were retried so far.
+ */
+long long GetHttpRetryCount() {
+    return static_cast<long long>(TVMIO::HttpSource::GetStats().retries);
+}
+
+/**
+ * @brief SetReadaheadLimit: The most bytes read ahead of the pre-load window at once (default 256 MB).
+ *        Call before InitializePlaybackManager, 0 disables readahead.
+ */
+void SetReadaheadLimit(long long maxBytes) {
+    g_readaheadBytes = static_cast<uint64_t>(std::max(0LL, maxBytes));
+}
+
+/**
+ * @brief GetReadaheadBytesInFlight: The number of bytes queued or being read ahead right now.
+ */
+long long GetReadaheadBytesInFlight() {
+    if (!g_playbackManager) return 0;
+    return static_cast<long long>(g_playbackManager->GetReadaheadStats().bytesInFlight);
+}
+
+/**
+ * @brief GetAverageLoadTimeMs: Mean wall time of LoadSubSequence so far.
+ */
+float GetAverageLoadTimeMs() {
+    if (!g_playbackManager) return 0.0f;
+    return static_cast<float>(g_playbackManager->GetAverageLoadMs());
+}
+
+/**
+ * @brief GetAverageDecodeTimeMs: Mean wall time of DecodeSubSequence so far.
+ */
+float GetAverageDecodeTimeMs() {
+    if (!g_playbackManager) return 0.0f;
+    return static_cast<float>(g_playbackManager->GetAverageDecodeMs());
+}
+
+/**
+ * @brief SetJobWorkerCount: The number of threads loading and decoding the window. Call before
+ *        InitializePlaybackManager, 0 picks one from the hardware (the default).
+ */
+void SetJobWorkerCount(int workers) {
+    g_jobWorkers = std::max(0, workers);
+}
+
+/**
+ * @brief GetJobQueueDepth: The number of load and decode jobs waiting for a worker.
+ */
+int GetJobQueueDepth() {
+    if (!g_playbackManager) return 0;
+    return static_cast<int>(g_playbackManager->GetJobStats().queued);
+}
+
+/**
+ * @brief GetRunningJobCount: The number of load and decode jobs on a worker right now.
+ */
+int GetRunningJobCount() {
+    if (!g_playbackManager) return 0;
+    return static_cast<int>(g_playbackManager->GetJobStats().running);
+}
+
+/**
+ * @brief GetCancelledJobCount: The number of queued jobs dropped because their subsequence left the window.
+ */
+long long GetCancelledJobCount() {
+    if (!g_playbackManager) return 0;
+    return static_cast<long long>(g_playbackManager->GetJobStats().cancelled);
+}
+
+/**
+ * @brief GetStageOccupancy: How many workers a decode pipeline stage kept busy on average, the bottleneck stage has
+ *        the highest value. Stages are 0 = load, 1 = Laplacian, 2 = solve, 3 = reconstruct, and 4 = the checks a
+ *        live sequence makes for new subsequences.
+ */
+float GetStageOccupancy(int stage) {
+    if (!g_playbackManager || stage < 0 || stage >= TVMDecoder::kJobTypeCount) return 0.0f;
+    return static_cast<float>(g_playbackManager->GetJobStats().stages[stage].occupancy);
+}
+
+/**
+ * @brief GetStageQueueDepth: The number of subsequences waiting in front of a decode pipeline stage.
+ */
+int GetStageQueueDepth(int stage) {
+    if (!g_playbackManager || stage < 0 || stage >= TVMDecoder::kJobTypeCount) return 0;
+    return static_cast<int>(g_playbackManager->GetJobStats().stages[stage].queued);
+}
+
+/**
+ * @brief SetMemoryBudget: The most bytes the decoders of the playback window may hold. Call before
+ *        InitializePlaybackManager, 0 sizes the window by memLoad and decodeLoad instead (the default).
+ */
+void SetMemoryBudget(long long maxBytes) {
+    g_memoryBudget = maxBytes > 0 ? static_cast<uint64_t>(maxBytes) : 0;
+}
+
+/**
+ * @brief SetLivePollInterval: How often live sequences created from now on look for the next subsequence
+ *        (default 100 ms). Each look checks one file, or makes one HEAD request for a remote sequence.
+ */
+void SetLivePollInterval(int milliseconds) {
+    g_livePollIntervalMs = std::max(milliseconds, 1);
+}
+
+/**
+ * @brief GetMemoryUsage: The bytes held by the decoders of the playback window, loaded or decoded.
+ */
+long long GetMemoryUsage() {
+    if (!g_playbackManager) return 0;
+    return static_cast<long long>(g_playbackManager->GetCacheStats().residentBytes);
+}
+
+/**
+ * @brief GetDecodedMemoryUsage: The part of GetMemoryUsage held by decoded subsequences.
+ */
+long long GetDecodedMemoryUsage() {
+    if (!g_playbackManager) return 0;
+    return static_cast<long long>(g_playbackManager->GetCacheStats().decodedBytes);
+}
+
+/**
+ * @brief GetCacheHitRate: The share of subsequences entering the playback window that were still decoded, 0 before
+ *        any entered it.
+ */
+float GetCacheHitRate() {
+    if (!g_playbackManager) return 0.0f;
+    const CacheStats stats = g_playbackManager->GetCacheStats();
+    return stats.lookups > 0 ? static_cast<float>(stats.hits) / static_cast<float>(stats.lookups) : 0.0f;
+}
+
+/**
+ * @brief SetSolveCacheDirectory: Keep solved S_hat matrices in a directory, so subsequences decoded before (in this
+ *        launch or an earlier one) skip the Laplacian and the solve. Call before InitializePlaybackManager.
+ * @param directory: The cache directory, created if needed. nullptr or "" turns the cache off.
+ * @param maxBytes: The most bytes the cached files may take, 0 or less for the default (1 GB).
+ * @return False if the directory can't be used, the cache is then off.
+ */
+bool SetSolveCacheDirectory(const char* directory, long long maxBytes) {
+    g_solveCache.reset();
+    if (!directory || !*directory) return true;
+    try {
+        g_solveCache = std::make_shared<TVMDecoder::SolveCache>(
+            directory, maxBytes > 0 ? static_cast<uint64_t>(maxBytes) : TVMDecoder::SolveCache::kDefaultMaxBytes);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("[SolveCache] ❌ ", e.what());
+        return false;
+    }
+}
+
+/**
+ * @brief GetSolveCacheHitCount: The number of decodes that mapped S_hat from the solve cache.
+ */
+long long GetSolveCacheHitCount() {
+    if (!g_solveCache) return 0;
+    return g_solveCache->GetStats().hits;
+}
+
+/**
+ * @brief GetSolveCacheMissCount: The number of decodes that had to solve S_hat.
+ */
+long long GetSolveCacheMissCount() {
+    if (!g_solveCache) return 0;
+    return g_solveCache->GetStats().misses;
+}
+
+/**
+ * @brief GetSolveCacheBytes: The size of the files in the solve cache directory.
+ */
+long long GetSolveCacheBytes() {
+    if (!g_solveCache) return 0;
+    return static_cast<long long>(g_solveCache->GetStats().bytes);
+}
 
 /**
  * @brief IsPlaybackManagerLoaded: Checks if the playback manager was initialized.
@@ -10,7 +10,7 @@
 
 namespace TVMUtil {
 Eigen::MatrixXd SolveLeastSquares(const Eigen::SparseMatrix<double>& L_star,
-                                  const Eigen::MatrixXd& D_hat,
+                                  const Eigen::Ref<const Eigen::MatrixXd>& D_hat,
                                   int maxIter,
                                   double tol) {
     const int numCols = D_hat.cols();     // Typically 4
@@ -155,7 +155,7 @@ Eigen::SparseMatrix<double> TVMUtil::BuildLaplacianMatrix(
 //Apply frame offsets stored in TMatrix
 Eigen::MatrixXd TVMUtil::ApplyTMatrixOffset(
     const Eigen::MatrixXd& vertexDisplacements,
-    const Eigen::MatrixXd& frameTranslations)
+    const Eigen::Ref<const Eigen::MatrixXd>& frameTranslations)
 {
     Eigen::MatrixXd result = vertexDisplacements;
     int numFrames = frameTranslations.cols() / 3;
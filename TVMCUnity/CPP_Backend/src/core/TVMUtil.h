@@ -20,7 +20,7 @@ namespace TVMUtil
 * @return Eigen::MatrixXd Solution matrix X of size (n x k).
 */
 Eigen::MatrixXd SolveLeastSquares(const Eigen::SparseMatrix<double>& L_star,
-                                  const Eigen::MatrixXd& D_hat,
+                                  const Eigen::Ref<const Eigen::MatrixXd>& D_hat,
                                   int maxIter,
                                   double tol);
 
@@ -55,7 +55,7 @@ Eigen::SparseMatrix<double> BuildLaplacianMatrix(const SimpleMesh::Mesh& mesh,
  * @return Eigen::MatrixXd: Updated displacement matrix with T_matrix offsets applied.
  */
 Eigen::MatrixXd ApplyTMatrixOffset(const Eigen::MatrixXd& vertexDisplacements,
-                                   const Eigen::MatrixXd& frameTranslations);
+                                   const Eigen::Ref<const Eigen::MatrixXd>& frameTranslations);
 
 }// namespace TVMUtil
 
@@ -0,0 +1,154 @@
+#include "TopologyStore.h"
+#include "MappedFile.h"
+#include "TVMLogger.h"
+#include "VertexCacheOptimizer.h"
+#include <algorithm>
+#include <iterator>
+
+namespace TVMDecoder {
+
+namespace {
+
+uint64_t HashIndices(const std::vector<int>& indices) {
+    return TVMIO::Hash64(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(int));
+}
+
+bool SameList(const Topology& a, const Topology& b) {
+    return a.hash == b.hash && a.indices == b.indices && a.vertexOrder == b.vertexOrder &&
+           a.triangleOrder == b.triangleOrder;
+}
+
+} // namespace
+
+bool Topology::Matches(const std::vector<int>& loaded, int vertexCount) const {
+    if (vertexOrder.empty()) {
+        return indices == loaded;
+    }
+    if (loaded.size() != indices.size() || vertexOrder.size() != static_cast<size_t>(vertexCount)) {
+        return false;
+    }
+    // Undo the reordering instead of keeping the loaded list around
+    for (size_t n = 0; n < triangleOrder.size(); ++n) {
+        const size_t t = static_cast<size_t>(triangleOrder[n]);
+        for (size_t k = 0; k < 3; ++k) {
+            if (loaded[t * 3 + k] != vertexOrder[indices[n * 3 + k]]) return false;
+        }
+    }
+    return true;
+}
+
+size_t Topology::GetBytes() const {
+    return (indices.size() + vertexOrder.size() + triangleOrder.size()) * sizeof(int);
+}
+
+TopologyStore::TopologyStore(bool optimizeOrder) : optimizeOrder(optimizeOrder) {
+}
+
+std::shared_ptr<const Topology> TopologyStore::Intern(std::vector<int> indices, int vertexCount) {
+    // Hashed outside of the lock, a list is a few MB on dense meshes
+    const uint64_t hash = HashIndices(indices);
+    {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        ++stats.lookups;
+        if (auto shared = FindLocked(hash, indices, vertexCount)) {
+            return shared;
+        }
+    }
+
+    // Reordering takes a while on dense meshes too, another decoder may intern the same list meanwhile
+    std::shared_ptr<Topology> topology = Build(std::move(indices), vertexCount, hash);
+    std::lock_guard<std::mutex> lock(storeMutex);
+    auto range = entries.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        auto shared = it->second.lock();
+        if (shared && SameList(*shared, *topology)) {
+            ++stats.hits;
+            stats.savedBytes += static_cast<int64_t>(shared->GetBytes());
+            return shared;
+        }
+    }
+    topology->id = nextId++;
+    const double triangleCount = static_cast<double>(topology->indices.size() / 3);
+    triangles += triangleCount;
+    missesBefore += topology->acmrBefore * triangleCount;
+    missesAfter += topology->acmrAfter * triangleCount;
+    if (!topology->vertexOrder.empty()) {
+        ++stats.reordered;
+    }
+    entries.emplace(hash, topology);
+    if (entries.size() >= pruneAt) {
+        PruneLocked();
+    }
+    return topology;
+}
+
+std::shared_ptr<const Topology> TopologyStore::FindLocked(uint64_t hash, const std::vector<int>& indices, int vertexCount) {
+    auto range = entries.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        auto shared = it->second.lock();
+        if (shared && shared->Matches(indices, vertexCount)) {
+            ++stats.hits;
+            stats.savedBytes += static_cast<int64_t>(shared->GetBytes());
+            return shared;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Topology> TopologyStore::Build(std::vector<int> indices, int vertexCount, uint64_t hash) const {
+    auto topology = std::make_shared<Topology>();
+    topology->hash = hash;
+    topology->acmrBefore = static_cast<float>(SimpleMesh::ComputeAcmr(indices));
+    SimpleMesh::IndexOrder order;
+    if (optimizeOrder && SimpleMesh::OptimizeVertexCache(indices, vertexCount, order)) {
+        topology->indices = std::move(order.indices);
+        topology->vertexOrder = std::move(order.vertexOrder);
+        topology->triangleOrder = std::move(order.triangleOrder);
+        topology->acmrAfter = static_cast<float>(SimpleMesh::ComputeAcmr(topology->indices));
+        LOG_INFO("[TopologyStore] ✅ Reordered ", topology->indices.size() / 3, " triangles, ACMR ",
+                 topology->acmrBefore, " -> ", topology->acmrAfter);
+    }
+    else {
+        if (optimizeOrder) {
+            LOG_WARN("[TopologyStore] Triangle indices out of range, keeping their order");
+        }
+        topology->indices = std::move(indices);
+        topology->acmrAfter = topology->acmrBefore;
+    }
+    return topology;
+}
+
+std::shared_ptr<const Topology> TopologyStore::MakeUnshared(std::vector<int> indices) {
+    auto topology = std::make_shared<Topology>();
+    topology->hash = HashIndices(indices);
+    topology->indices = std::move(indices);
+    return topology;
+}
+
+void TopologyStore::PruneLocked() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        it = it->second.expired() ? entries.erase(it) : std::next(it);
+    }
+    pruneAt = std::max<size_t>(64, entries.size() * 2);
+}
+
+TopologyStoreStats TopologyStore::GetStats() {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    PruneLocked();
+    TopologyStoreStats current = stats;
+    current.entries = 0;
+    current.bytes = 0;
+    for (const auto& entry : entries) {
+        if (auto shared = entry.second.lock()) {
+            ++current.entries;
+            current.bytes += static_cast<int64_t>(shared->GetBytes());
+        }
+    }
+    if (triangles > 0.0) {
+        current.acmrBefore = static_cast<float>(missesBefore / triangles);
+        current.acmrAfter = static_cast<float>(missesAfter / triangles);
+    }
+    return current;
+}
+
+} // namespace TVMDecoder
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace TVMDecoder {
+
+/**
+ * @brief Topology: A triangle list (3 indices per triangle) shared by every decoder whose mesh has it. Immutable
+ *        once interned. When the store reorders it for the vertex caches, the decoders hand out their vertices in
+ *        vertexOrder, so the indices refer to them as drawn.
+ */
+struct Topology {
+    uint64_t id = 0;    // Unique per distinct triangle list of a store, 0 when not interned
+    uint64_t hash = 0;  // Of the indices as loaded
+    std::vector<int> indices;        // As drawn
+    std::vector<int> vertexOrder;    // The loaded vertex of each drawn one, empty when not reordered
+    std::vector<int> triangleOrder;  // The loaded triangle of each drawn one, empty when not reordered
+    float acmrBefore = 0.0f;         // Average cache miss ratio as loaded (SimpleMesh::ComputeAcmr)
+    float acmrAfter = 0.0f;          // And as drawn
+
+    /**
+     * @brief Matches: Whether the list was interned from these loaded indices.
+     */
+    bool Matches(const std::vector<int>& loaded, int vertexCount) const;
+
+    size_t GetBytes() const;
+};
+
+/**
+ * @brief TopologyStoreStats: Counters of a TopologyStore.
+ */
+struct TopologyStoreStats {
+    int64_t lookups = 0;
+    int64_t hits = 0;        // Triangle lists a decoder already held
+    int64_t entries = 0;     // Distinct triangle lists held right now
+    int64_t bytes = 0;       // Their indices and orders
+    int64_t savedBytes = 0;  // Indices the hits did not have to keep a copy of
+    int64_t reordered = 0;   // Lists reordered for the vertex caches
+    float acmrBefore = 0.0f; // Average cache miss ratio of the lists interned, per triangle, as loaded
+    float acmrAfter = 0.0f;  // And as drawn
+};
+
+/**
+ * @brief TopologyStore: The triangle lists of the decoders of a context, interned by their hash. Subsequences of a
+ *        capture often keep the topology of the one before, so they share one list (and its id) instead of each
+ *        holding a copy, and the render side can tell from the id that the indices it uploaded still apply. Entries
+ *        only refer to their list: it lives as long as a decoder holds it, and a list interned again after that
+ *        gets a new id. Thread safe.
+ */
+class TopologyStore {
+public:
+    /**
+     * @brief TopologyStore: Constructor.
+     * @param optimizeOrder: Reorder every new list for the GPU's vertex caches (SimpleMesh::OptimizeVertexCache),
+     *        once per distinct list. The decoders then reorder their vertices to match, the geometry is unchanged.
+     */
+    explicit TopologyStore(bool optimizeOrder = false);
+
+    /**
+     * @brief Intern: Share a triangle list, the one already held when another decoder has the same indices.
+     * @param indices: The flat triangle indices as loaded, taken over when they are not held yet.
+     * @param vertexCount: The vertices of the mesh, the ones no triangle uses keep their place after the others.
+     * @return The shared list.
+     */
+    std::shared_ptr<const Topology> Intern(std::vector<int> indices, int vertexCount);
+
+    /**
+     * @brief MakeUnshared: A list with id 0 for a decoder without a store.
+     */
+    static std::shared_ptr<const Topology> MakeUnshared(std::vector<int> indices);
+
+    bool IsOptimizingOrder() const { return optimizeOrder; }
+    TopologyStoreStats GetStats();
+
+private:
+    // A new list for the indices, reordered when the store optimizes
+    std::shared_ptr<Topology> Build(std::vector<int> indices, int vertexCount, uint64_t hash) const;
+
+    // The live list interned from these indices, the caller holds storeMutex
+    std::shared_ptr<const Topology> FindLocked(uint64_t hash, const std::vector<int>& indices, int vertexCount);
+
+    // Drop the entries whose list went away, the caller holds storeMutex
+    void PruneLocked();
+
+    const bool optimizeOrder;
+    std::mutex storeMutex;
+    std::unordered_multimap<uint64_t, std::weak_ptr<const Topology>> entries;  // By hash, a collision adds an entry
+    uint64_t nextId = 1;
+    size_t pruneAt = 64;  // Prune when the map grows to this size
+    TopologyStoreStats stats;
+    double triangles = 0.0, missesBefore = 0.0, missesAfter = 0.0;  // Over the lists interned, for the ACMR stats
+};
+
+} // namespace TVMDecoder
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+
+namespace TVMDecoder {
+
+/**
+ * @brief TripleBuffer: Hands the latest version of a value from writer threads to one reader thread without the
+ *        reader ever waiting. The writer fills a back buffer and swaps it with the middle one, the reader swaps the
+ *        middle one into its front buffer when a new version is there. Both swaps are a single atomic exchange, so
+ *        the reader never blocks and never sees a half written value.
+ *        Writers must be serialized by the caller (e.g. under the lock that guards the source of the value).
+ *        Release is called on the versions nobody will read again (the one the reader leaves, the one the writer
+ *        gets back), so values that own resources can let go of them instead of keeping them until overwritten.
+ */
+struct KeepStale {
+    template <typename T>
+    void operator()(T&) const {}
+};
+
+template <typename T, typename Release = KeepStale>
+class TripleBuffer {
+public:
+    /**
+     * @brief GetWriteBuffer: The back buffer, the writer may change it freely until Publish.
+     *        It holds a stale version (passed through Release), not the latest one.
+     */
+    T& GetWriteBuffer() { return buffers[back]; }
+
+    /**
+     * @brief Publish: Make the back buffer the latest version.
+     */
+    void Publish() {
+        back = middle.exchange(back | kFresh, std::memory_order_acq_rel) & kIndexMask;
+        release(buffers[back]);
+    }
+
+    /**
+     * @brief Read: The latest published version, wait free. Reader thread only, the reference stays valid until
+     *        the next Read.
+     */
+    const T& Read() {
+        if (middle.load(std::memory_order_acquire) & kFresh) {
+            // Released while still the reader's, the writer may take it back as soon as it is exchanged
+            release(buffers[front]);
+            front = middle.exchange(front, std::memory_order_acq_rel) & kIndexMask;
+        }
+        return buffers[front];
+    }
+
+private:
+    static constexpr int kIndexMask = 3;
+    static constexpr int kFresh = 4;  // Set on the middle index when it holds a version the reader has not seen
+
+    T buffers[3];
+    Release release;
+    std::atomic<int> middle{1};
+    int back = 2;   // Writer side
+    int front = 0;  // Reader side
+};
+
+} // namespace TVMDecoder
@@ -0,0 +1,613 @@
+#include "ByteSource.h"
+#include "TVMLogger.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace TVMIO {
+
+namespace {
+
+#if defined(_WIN32)
+using SocketHandle = SOCKET;
+const SocketHandle kInvalidSocket = INVALID_SOCKET;
+void CloseSocket(SocketHandle s) { ::closesocket(s); }
+#else
+using SocketHandle = int;
+const SocketHandle kInvalidSocket = -1;
+void CloseSocket(SocketHandle s) { ::close(s); }
+#endif
+
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+// Failures worth another attempt: network errors, timeouts, truncated bodies and 5xx responses
+struct TransientError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// The most a response body may hold when the caller knows no better bound (a whole file of unknown size)
+constexpr uint64_t kMaxBodyBytes = uint64_t{1} << 31;
+
+// Retry delays stop doubling here, however many retries are allowed
+constexpr int64_t kMaxRetryDelayMs = 10000;
+
+// Global request limit, options and counters shared by every HttpSource
+std::mutex g_httpMutex;
+std::condition_variable g_slotReleased;
+HttpOptions g_httpOptions;
+int g_activeRequests = 0;
+std::atomic<int64_t> g_requests{0}, g_retries{0}, g_failures{0}, g_bytesReceived{0};
+
+// Holds one of the maxConcurrentRequests slots for its lifetime
+class RequestSlot {
+public:
+    RequestSlot() {
+        std::unique_lock<std::mutex> lock(g_httpMutex);
+        g_slotReleased.wait(lock, [] { return g_activeRequests < std::max(1, g_httpOptions.maxConcurrentRequests); });
+        ++g_activeRequests;
+    }
+    ~RequestSlot() {
+        {
+            std::lock_guard<std::mutex> lock(g_httpMutex);
+            --g_activeRequests;
+        }
+        g_slotReleased.notify_one();
+    }
+    RequestSlot(const RequestSlot&) = delete;
+    RequestSlot& operator=(const RequestSlot&) = delete;
+};
+
+void EnsureNetworking() {
+#if defined(_WIN32)
+    static std::once_flag once;
+    std::call_once(once, [] {
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+    });
+#endif
+}
+
+bool SetBlocking(SocketHandle s, bool blocking) {
+#if defined(_WIN32)
+    u_long mode = blocking ? 0 : 1;
+    return ::ioctlsocket(s, FIONBIO, &mode) == 0;
+#else
+    const int flags = ::fcntl(s, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(s, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK)) == 0;
+#endif
+}
+
+// connect() with a timeout: start it non-blocking and wait for the socket to become writable
+bool ConnectWithTimeout(SocketHandle s, const sockaddr* address, socklen_t length, int timeoutMs) {
+    if (!SetBlocking(s, false)) return false;
+    if (::connect(s, address, length) != 0) {
+#if defined(_WIN32)
+        if (WSAGetLastError() != WSAEWOULDBLOCK) return false;
+        WSAPOLLFD pfd{};
+        pfd.fd = s;
+        pfd.events = POLLWRNORM;
+        if (WSAPoll(&pfd, 1, timeoutMs) <= 0) return false;
+#else
+        if (errno != EINPROGRESS) return false;
+        pollfd pfd{};
+        pfd.fd = s;
+        pfd.events = POLLOUT;
+        if (::poll(&pfd, 1, timeoutMs) <= 0) return false;
+#endif
+        int error = 0;
+        socklen_t errorLength = sizeof(error);
+        if (::getsockopt(s, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &errorLength) != 0 || error != 0) {
+            return false;
+        }
+    }
+    return SetBlocking(s, true);
+}
+
+// A single HTTP/1.1 connection, closed by the server after one response
+class Connection {
+public:
+    Connection(const std::string& host, const std::string& port, int timeoutMs) {
+        EnsureNetworking();
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* results = nullptr;
+        if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &results) != 0) {
+            throw TransientError("Failed to resolve " + host);
+        }
+        for (addrinfo* ai = results; ai && handle == kInvalidSocket; ai = ai->ai_next) {
+            SocketHandle s = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (s == kInvalidSocket) continue;
+            if (ConnectWithTimeout(s, ai->ai_addr, static_cast<socklen_t>(ai->ai_addrlen), timeoutMs)) {
+                handle = s;
+            } else {
+                CloseSocket(s);
+            }
+        }
+        ::freeaddrinfo(results);
+        if (handle == kInvalidSocket) {
+            throw TransientError("Failed to connect to " + host + ":" + port);
+        }
+
+#if defined(_WIN32)
+        DWORD timeout = static_cast<DWORD>(timeoutMs);
+#else
+        timeval timeout{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+#endif
+        ::setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+        ::setsockopt(handle, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+#if defined(SO_NOSIGPIPE)
+        int noSigPipe = 1;
+        ::setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+    }
+
+    ~Connection() { CloseSocket(handle); }
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    void Send(const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            const auto n = ::send(handle, data.data() + sent, static_cast<int>(data.size() - sent), kSendFlags);
+            if (n <= 0) throw TransientError("Failed to send request");
+            sent += static_cast<size_t>(n);
+        }
+    }
+
+    // Receive up to size bytes, 0 at the end of the response
+    size_t Receive(char* out, size_t size) {
+        const auto n = ::recv(handle, out, static_cast<int>(std::min<size_t>(size, 1 << 20)), 0);
+        if (n < 0) throw TransientError("Connection lost or timed out");
+        return static_cast<size_t>(n);
+    }
+
+private:
+    SocketHandle handle = kInvalidSocket;
+};
+
+struct HttpResponse {
+    int status = 0;
+    int64_t contentLength = -1;
+    std::string contentRange;
+    std::shared_ptr<std::vector<char>> body = std::make_shared<std::vector<char>>();
+};
+
+std::string ToLower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+std::string Trim(const std::string& s) {
+    const size_t first = s.find_first_not_of(" \t");
+    const size_t last = s.find_last_not_of(" \t\r");
+    return first == std::string::npos ? "" : s.substr(first, last - first + 1);
+}
+
+// Decode a chunked transfer encoded body in place
+void Dechunk(std::vector<char>& body) {
+    std::vector<char> out;
+    size_t pos = 0;
+    while (true) {
+        const auto lineEnd = std::search(body.begin() + pos, body.end(), "\r\n", "\r\n" + 2);
+        if (lineEnd == body.end()) throw TransientError("Truncated chunked response");
+        const std::string sizeLine(body.begin() + pos, lineEnd);
+        const uint64_t chunk = std::strtoull(sizeLine.c_str(), nullptr, 16);
+        pos = static_cast<size_t>(lineEnd - body.begin()) + 2;
+        if (chunk == 0) break;
+        // The chunk and its trailing CRLF must both be there, the size line is not trusted
+        if (chunk > body.size() - pos || body.size() - pos - chunk < 2) {
+            throw TransientError("Truncated chunked response");
+        }
+        const size_t chunkEnd = pos + static_cast<size_t>(chunk);
+        if (body[chunkEnd] != '\r' || body[chunkEnd + 1] != '\n') {
+            throw TransientError("Malformed chunked response");
+        }
+        out.insert(out.end(), body.begin() + pos, body.begin() + chunkEnd);
+        pos = chunkEnd + 2;
+    }
+    body.swap(out);
+}
+
+// The number of bytes of a "first-last" range
+uint64_t GetRangeBytes(const std::string& range) {
+    const size_t dash = range.find('-');
+    const uint64_t first = std::strtoull(range.c_str(), nullptr, 10);
+    const uint64_t last = std::strtoull(range.c_str() + dash + 1, nullptr, 10);
+    return last - first + 1;
+}
+
+// Make one request, the body is read in full (or skipped for HEAD). A partial response may not be larger than the
+// range asked for and a full one not larger than maxBody, the sizes the server reports are not trusted
+HttpResponse Request(const std::string& host, const std::string& port, const std::string& target,
+                     const std::string& method, const std::string& range, int timeoutMs,
+                     uint64_t maxBody = kMaxBodyBytes) {
+    Connection connection(host, port, timeoutMs);
+    std::string request = method + " " + target + " HTTP/1.1\r\n";
+    request += "Host: " + host + (port == "80" ? "" : ":" + port) + "\r\n";
+    request += "User-Agent: TVMDecoder\r\nAccept-Encoding: identity\r\nConnection: close\r\n";
+    if (!range.empty()) request += "Range: bytes=" + range + "\r\n";
+    request += "\r\n";
+    connection.Send(request);
+    ++g_requests;
+
+    // Read up to the end of the headers
+    std::string head;
+    size_t headerEnd = std::string::npos;
+    char buffer[16384];
+    while (headerEnd == std::string::npos) {
+        const size_t n = connection.Receive(buffer, sizeof(buffer));
+        if (n == 0) throw TransientError("Connection closed before the response headers");
+        head.append(buffer, n);
+        headerEnd = head.find("\r\n\r\n");
+        if (headerEnd == std::string::npos && head.size() > 65536) {
+            throw std::runtime_error("Response headers too large");
+        }
+    }
+
+    HttpResponse response;
+    bool chunked = false;
+    size_t lineStart = 0;
+    for (size_t lineIndex = 0; lineStart < headerEnd; ++lineIndex) {
+        const size_t lineEnd = head.find("\r\n", lineStart);
+        const std::string line = head.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 2;
+        if (lineIndex == 0) {
+            // "HTTP/1.1 206 Partial Content"
+            const size_t space = line.find(' ');
+            if (line.rfind("HTTP/", 0) != 0 || space == std::string::npos) {
+                throw TransientError("Malformed response status line");
+            }
+            response.status = std::atoi(line.c_str() + space + 1);
+            continue;
+        }
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        const std::string key = ToLower(Trim(line.substr(0, colon)));
+        const std::string value = Trim(line.substr(colon + 1));
+        if (key == "content-length") response.contentLength = std::strtoll(value.c_str(), nullptr, 10);
+        else if (key == "content-range") response.contentRange = value;
+        else if (key == "transfer-encoding") chunked = ToLower(value).find("chunked") != std::string::npos;
+    }
+
+    // HEAD responses and errors carry no body we need
+    const bool hasBody = method != "HEAD" && response.status >= 200 && response.status < 300 && response.status != 204;
+    if (!hasBody) return response;
+
+    const uint64_t limit = response.status == 206 && !range.empty() ? GetRangeBytes(range) : maxBody;
+    auto checkSize = [&](uint64_t bytes, uint64_t max) {
+        if (bytes > max) {
+            throw std::runtime_error("Response body larger than the " + std::to_string(limit) + " bytes expected");
+        }
+    };
+    std::vector<char>& body = *response.body;
+    const size_t leftover = head.size() - headerEnd - 4;
+    if (!chunked && response.contentLength >= 0) {
+        // Receive straight into the final buffer
+        checkSize(static_cast<uint64_t>(response.contentLength), limit);
+        body.resize(static_cast<size_t>(response.contentLength));
+        size_t received = std::min(leftover, body.size());
+        std::memcpy(body.data(), head.data() + headerEnd + 4, received);
+        while (received < body.size()) {
+            const size_t n = connection.Receive(body.data() + received, body.size() - received);
+            if (n == 0) throw TransientError("Truncated response body");
+            received += n;
+        }
+    } else {
+        // Read to the end of the connection, leaving room for the size lines of a chunked body (any but tiny chunks)
+        const uint64_t received = chunked ? limit * 2 + 4096 : limit;
+        body.assign(head.begin() + headerEnd + 4, head.end());
+        for (size_t n; (n = connection.Receive(buffer, sizeof(buffer))) > 0;) {
+            body.insert(body.end(), buffer, buffer + n);
+            checkSize(body.size(), received);
+        }
+        if (chunked) Dechunk(body);
+        checkSize(body.size(), limit);
+    }
+    g_bytesReceived += static_cast<int64_t>(body.size());
+    return response;
+}
+
+// Run a request, retrying transient failures with exponential backoff
+template <typename Fn>
+auto WithRetry(const std::string& url, Fn&& fn) -> decltype(fn(0)) {
+    const HttpOptions options = HttpSource::GetOptions();
+    for (int attempt = 0;; ++attempt) {
+        try {
+            RequestSlot slot;
+            return fn(options.timeoutMs);
+        } catch (const TransientError& e) {
+            if (attempt >= options.maxRetries) {
+                ++g_failures;
+                throw std::runtime_error(std::string(e.what()) + " (" + url + ")");
+            }
+            ++g_retries;
+            LOG_WARN("[HttpSource] Retrying ", url, " after: ", e.what());
+            const int64_t delayMs = static_cast<int64_t>(std::max(options.retryDelayMs, 0)) << std::min(attempt, 16);
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::min(delayMs, kMaxRetryDelayMs)));
+        } catch (const std::exception&) {
+            ++g_failures;
+            throw;
+        }
+    }
+}
+
+// Throw for any status that is not the one we expect, transient for the ones worth retrying
+void CheckStatus(const HttpResponse& response, const std::string& url) {
+    if (response.status >= 200 && response.status < 300) return;
+    const std::string message = "HTTP " + std::to_string(response.status);
+    if (response.status >= 500 || response.status == 408 || response.status == 429) {
+        throw TransientError(message);  // The URL is added once the retries run out
+    }
+    throw std::runtime_error(message + " for " + url);
+}
+
+} // anonymous namespace
+
+MappedFileSource::MappedFileSource(const std::string& path) : ByteSource(path) {
+    file = std::make_shared<MappedFile>(path);
+}
+
+ByteView MappedFileSource::Read(uint64_t offset, uint64_t bytes) const {
+    if (offset > file->Size() || file->Size() - offset < bytes) {
+        throw std::runtime_error("Read past the end of " + name);
+    }
+    ByteView view;
+    view.backing = file;
+    view.data = file->Data() + offset;
+    view.size = static_cast<size_t>(bytes);
+    return view;
+}
+
+MemorySource::MemorySource(ByteView view, const std::string& sourceName)
+    : ByteSource(sourceName), bytes(std::move(view)) {}
+
+ByteView MemorySource::Read(uint64_t offset, uint64_t count) const {
+    if (offset > bytes.size || bytes.size - offset < count) {
+        throw std::runtime_error("Read past the end of " + name);
+    }
+    ByteView view = bytes;
+    view.data = bytes.data + offset;
+    view.size = static_cast<size_t>(count);
+    return view;
+}
+
+HttpSource::HttpSource(const std::string& url) : ByteSource(url) {
+    const std::string scheme = "http://";
+    if (ToLower(url.substr(0, scheme.size())) != scheme) {
+        throw std::invalid_argument("Only http:// URLs can be streamed (no TLS support): " + url);
+    }
+    const size_t hostStart = scheme.size();
+    const size_t pathStart = std::min(url.find('/', hostStart), url.size());
+    std::string authority = url.substr(hostStart, pathStart - hostStart);
+    target = pathStart < url.size() ? url.substr(pathStart) : "/";
+    port = "80";
+
+    // "host", "host:port", "[v6]" or "[v6]:port"
+    const size_t bracket = authority.find(']');
+    const size_t colon = authority.find(':', bracket == std::string::npos ? 0 : bracket);
+    if (colon != std::string::npos) {
+        port = authority.substr(colon + 1);
+        authority.resize(colon);
+    }
+    host = authority.size() > 1 && authority.front() == '[' ? authority.substr(1, authority.size() - 2) : authority;
+    if (host.empty() || port.empty()) {
+        throw std::invalid_argument("Malformed URL: " + url);
+    }
+}
+
+bool HttpSource::Exists(const std::string& url) {
+    HttpSource source(url);
+    const HttpResponse response = WithRetry(url, [&](int timeoutMs) {
+        HttpResponse r = Request(source.host, source.port, source.target, "HEAD", "", timeoutMs);
+        if (r.status == 404 || r.status == 410) return r;
+        CheckStatus(r, url);
+        return r;
+    });
+    return response.status >= 200 && response.status < 300;
+}
+
+uint64_t HttpSource::Size() const {
+    const int64_t known = size.load();
+    if (known >= 0) return static_cast<uint64_t>(known);
+
+    // A HEAD request gives the length, a one byte range request gives it in Content-Range otherwise
+    int64_t total = WithRetry(name, [&](int timeoutMs) {
+        HttpResponse r = Request(host, port, target, "HEAD", "", timeoutMs);
+        CheckStatus(r, name);
+        return r.status == 200 ? r.contentLength : -1;
+    });
+    if (total < 0) {
+        total = WithRetry(name, [&](int timeoutMs) {
+            HttpResponse r = Request(host, port, target, "GET", "0-0", timeoutMs);
+            CheckStatus(r, name);
+            const size_t slash = r.contentRange.find('/');
+            if (r.status == 206 && slash != std::string::npos) {
+                return static_cast<int64_t>(std::strtoll(r.contentRange.c_str() + slash + 1, nullptr, 10));
+            }
+            return r.status == 200 ? static_cast<int64_t>(r.body->size()) : int64_t(-1);
+        });
+    }
+    if (total < 0) {
+        throw std::runtime_error("Server did not report the size of " + name);
+    }
+    size = total;
+    return static_cast<uint64_t>(total);
+}
+
+ByteView HttpSource::Read(uint64_t offset, uint64_t bytes) const {
+    if (bytes == 0) return ByteView{};
+    const std::string range = std::to_string(offset) + "-" + std::to_string(offset + bytes - 1);
+    return WithRetry(name, [&](int timeoutMs) {
+        // A server that ignores the range sends the whole file, which is no larger than the size when known
+        const int64_t known = size.load();
+        HttpResponse r = Request(host, port, target, "GET", range, timeoutMs,
+                                 known >= 0 ? static_cast<uint64_t>(known) : kMaxBodyBytes);
+        CheckStatus(r, name);
+        ByteView view;
+        if (r.status == 206) {
+            // "bytes first-last/total", the bytes must be the ones asked for
+            if (r.contentRange.rfind("bytes " + range + "/", 0) != 0) {
+                throw std::runtime_error("Content-Range \"" + r.contentRange + "\" does not match the range " + range +
+                                         " asked for from " + name);
+            }
+            if (r.body->size() != bytes) throw TransientError("Short range response");
+            view.data = r.body->data();
+        } else {
+            // The server ignored the range and sent the whole file
+            if (r.body->size() < offset || r.body->size() - offset < bytes) {
+                throw std::runtime_error("Read past the end of " + name);
+            }
+            size = static_cast<int64_t>(r.body->size());
+            view.data = r.body->data() + offset;
+        }
+        view.size = static_cast<size_t>(bytes);
+        view.backing = r.body;
+        return view;
+    });
+}
+
+ByteView HttpSource::ReadAll() const {
+    // One plain GET rather than a size query followed by a range request
+    return WithRetry(name, [&](int timeoutMs) {
+        const int64_t known = size.load();
+        HttpResponse r = Request(host, port, target, "GET", "", timeoutMs,
+                                 known >= 0 ? static_cast<uint64_t>(known) : kMaxBodyBytes);
+        CheckStatus(r, name);
+        size = static_cast<int64_t>(r.body->size());
+        ByteView view;
+        view.data = r.body->data();
+        view.size = r.body->size();
+        view.backing = r.body;
+        return view;
+    });
+}
+
+void HttpSource::SetOptions(const HttpOptions& options) {
+    {
+        std::lock_guard<std::mutex> lock(g_httpMutex);
+        g_httpOptions = options;
+    }
+    g_slotReleased.notify_all();
+}
+
+HttpOptions HttpSource::GetOptions() {
+    std::lock_guard<std::mutex> lock(g_httpMutex);
+    return g_httpOptions;
+}
+
+HttpStats HttpSource::GetStats() {
+    HttpStats stats;
+    stats.requests = g_requests;
+    stats.retries = g_retries;
+    stats.failures = g_failures;
+    stats.bytesReceived = g_bytesReceived;
+    return stats;
+}
+
+bool IsUrl(const std::string& path) {
+    const std::string lower = ToLower(path.substr(0, 8));
+    return lower.rfind("http://", 0) == 0 || lower.rfind("https://", 0) == 0;
+}
+
+std::shared_ptr<ByteSource> OpenByteSource(const std::string& pathOrUrl) {
+    if (IsUrl(pathOrUrl)) {
+        try {
+            return std::make_shared<HttpSource>(pathOrUrl);
+        } catch (const std::invalid_argument& e) {
+            throw std::runtime_error(e.what());
+        }
+    }
+    return std::make_shared<MappedFileSource>(pathOrUrl);
+}
+
+DirectorySource::DirectorySource(const std::string& rootPath) : root(rootPath), remote(IsUrl(rootPath)) {
+    while (remote && !root.empty() && root.back() == '/') root.pop_back();
+}
+
+std::string DirectorySource::Join(const std::string& folder, const std::string& file) const {
+    if (remote) {
+        return root + "/" + (folder.empty() ? file : folder + "/" + file);
+    }
+    return (std::filesystem::path(root) / folder / file).string();
+}
+
+bool DirectorySource::Contains(const std::string& folder, const std::string& file) const {
+    return remote ? HttpSource::Exists(Join(folder, file)) : FileExists(Join(folder, file));
+}
+
+ByteView DirectorySource::Read(const std::string& folder, const std::string& file) const {
+    return OpenByteSource(Join(folder, file))->ReadAll();
+}
+
+bool DirectorySource::Contains(const std::string& file) const {
+    return Contains("", file);
+}
+
+ByteView DirectorySource::Read(const std::string& file) const {
+    return Read("", file);
+}
+
+int DirectorySource::GetSubSequenceCount() const {
+    int count = 0;
+    if (!remote) {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(root, error)) {
+            if (entry.is_directory() && entry.path().filename().string().rfind("subsequence_", 0) == 0) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    // Folders are numbered from 1, stop at the first one without a reference mesh
+    while (true) {
+        const std::string number = std::to_string(count + 1);
+        const std::string folder = "subsequence_" + std::string(number.size() < 3 ? 3 - number.size() : 0, '0') + number;
+        if (!HttpSource::Exists(Join(folder, "decoded_decimated_reference_mesh_subdivided.obj"))) break;
+        ++count;
+    }
+    return count;
+}
+
+std::vector<ByteRange> DirectorySource::GetFileRanges(const std::string& folder) const {
+    std::vector<ByteRange> ranges;
+    if (remote) return ranges;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::path(root) / folder, error)) {
+        if (!entry.is_regular_file()) continue;
+        try {
+            auto file = std::make_shared<MappedFileSource>(entry.path().string());
+            ranges.push_back({file, 0, file->Size()});
+        } catch (const std::exception&) {
+            // Readahead is only a hint, the load reports unreadable files
+        }
+    }
+    return ranges;
+}
+
+} // namespace TVMIO
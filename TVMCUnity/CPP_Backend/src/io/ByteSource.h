@@ -0,0 +1,259 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+namespace TVMIO {
+
+/**
+ * @brief ByteSource: Random access to the bytes of one file, wherever it lives. Sequence readers
+ *        (SequenceContainer, ZipArchive, DirectorySource) only go through this interface, so the same asset can be
+ *        memory mapped from disk, held in memory or streamed over HTTP with range requests.
+ *        Implementations must be safe to read from several threads at once.
+ */
+class ByteSource {
+public:
+    virtual ~ByteSource() = default;
+
+    /**
+     * @brief Size: The total number of bytes in the source.
+     * @throws RunTimeError: If the size can't be determined.
+     */
+    virtual uint64_t Size() const = 0;
+
+    /**
+     * @brief Read: Read a byte range. Sources that already hold the bytes (mappings, buffers) return a view into
+     *        them, others fetch the range into a new buffer owned by the view.
+     * @param offset: The first byte to read.
+     * @param bytes: The number of bytes to read.
+     * @throws RunTimeError: If the range is outside of the source or can't be read.
+     * @return The bytes.
+     */
+    virtual ByteView Read(uint64_t offset, uint64_t bytes) const = 0;
+
+    /**
+     * @brief ReadAll: Read the whole source.
+     */
+    virtual ByteView ReadAll() const { return Read(0, Size()); }
+
+    /**
+     * @brief Prefetch: Bring a byte range into memory ahead of a Read, blocking until it is resident. Does
+     *        nothing for sources that have no cache to warm (memory buffers, HTTP).
+     * @param offset: The first byte of the range.
+     * @param bytes: The number of bytes.
+     */
+    virtual void Prefetch(uint64_t /*offset*/, uint64_t /*bytes*/) const {}
+
+    // Getter functions
+    const std::string& GetName() const { return name; }
+
+protected:
+    explicit ByteSource(const std::string& sourceName) : name(sourceName) {}
+
+    std::string name;
+};
+
+/**
+ * @brief MappedFileSource: A local file, memory mapped once and viewed in place.
+ */
+class MappedFileSource : public ByteSource {
+public:
+    /**
+     * @brief MappedFileSource: constructor
+     * @param path: The file path of the file we are mapping.
+     * @throws RunTimeError: If the file can't be opened or mapped.
+     */
+    explicit MappedFileSource(const std::string& path);
+
+    uint64_t Size() const override { return file->Size(); }
+    ByteView Read(uint64_t offset, uint64_t bytes) const override;
+    void Prefetch(uint64_t offset, uint64_t bytes) const override { file->Prefetch(offset, bytes); }
+
+private:
+    std::shared_ptr<MappedFile> file;
+};
+
+/**
+ * @brief MemorySource: Bytes that are already in memory (a downloaded asset, a stored zip entry, ...).
+ */
+class MemorySource : public ByteSource {
+public:
+    /**
+     * @brief MemorySource: constructor
+     * @param view: The bytes, kept alive by the view's backing for the source's lifetime.
+     * @param sourceName: The name used in error messages.
+     */
+    MemorySource(ByteView view, const std::string& sourceName);
+
+    uint64_t Size() const override { return bytes.size; }
+    ByteView Read(uint64_t offset, uint64_t bytes) const override;
+
+private:
+    ByteView bytes;
+};
+
+/**
+ * @brief HttpOptions: Limits applied to every HTTP request made by the plugin.
+ */
+struct HttpOptions {
+    int maxConcurrentRequests = 4;  // Requests in flight across all sources
+    int maxRetries = 3;             // Extra attempts after a network error, timeout or 5xx response
+    int timeoutMs = 10000;          // Connect, send and receive timeout per request
+    int retryDelayMs = 250;         // Delay before the first retry, doubled for every following one up to 10 s
+};
+
+/**
+ * @brief HttpStats: Counters over every HTTP request made by the plugin.
+ */
+struct HttpStats {
+    int64_t requests = 0;
+    int64_t retries = 0;
+    int64_t failures = 0;       // Requests that failed after their last retry
+    int64_t bytesReceived = 0;  // Response body bytes
+};
+
+/**
+ * @brief HttpSource: A file on an HTTP/1.1 server, fetched with range requests so only the bytes that are read
+ *        get downloaded. Requests share a global concurrency limit and are retried with exponential backoff on
+ *        transient failures. Plain http:// only, there is no TLS support.
+ */
+class HttpSource : public ByteSource {
+public:
+    /**
+     * @brief HttpSource: constructor, no request is made until the source is read.
+     * @param url: The http:// URL of the file.
+     * @throws InvalidArgument: If the URL is malformed or not http://.
+     */
+    explicit HttpSource(const std::string& url);
+
+    /**
+     * @brief Exists: Check whether the server has a file at the given URL.
+     * @param url: The http:// URL of the file.
+     * @throws RunTimeError: If the server can't be reached.
+     */
+    static bool Exists(const std::string& url);
+
+    uint64_t Size() const override;
+    ByteView Read(uint64_t offset, uint64_t bytes) const override;
+    ByteView ReadAll() const override;
+
+    static void SetOptions(const HttpOptions& options);
+    static HttpOptions GetOptions();
+    static HttpStats GetStats();
+
+private:
+    std::string host, port, target;
+    mutable std::atomic<int64_t> size{-1};  // Fetched on first use
+};
+
+/**
+ * @brief IsUrl: Check whether a path is an http:// or https:// URL.
+ */
+bool IsUrl(const std::string& path);
+
+/**
+ * @brief OpenByteSource: Open a local path (memory mapped) or an http:// URL (range requests).
+ * @param pathOrUrl: The file path or URL.
+ * @throws RunTimeError: If a local file can't be opened or the URL is not supported.
+ */
+std::shared_ptr<ByteSource> OpenByteSource(const std::string& pathOrUrl);
+
+/**
+ * @brief ByteRange: A range of a byte source, used to schedule readahead.
+ */
+struct ByteRange {
+    std::shared_ptr<const ByteSource> source;
+    uint64_t offset = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * @brief SequenceSource: The files of an encoded sequence laid out as subsequence_XXX folders, wherever they are
+ *        stored (a directory on disk or on a server, or a .zip). Decoders load a subsequence through this interface.
+ */
+class SequenceSource {
+public:
+    // Written into a subsequence folder once all of its files are, the folders of a live sequence that is still
+    // being encoded are only read when it exists
+    static constexpr const char* kCompleteFileName = "segment.complete";
+
+    virtual ~SequenceSource() = default;
+
+    /**
+     * @brief Contains: Check if the sequence holds a subsequence file.
+     * @param folder: The subsequence folder name (e.g. "subsequence_001").
+     * @param file: The file name inside the folder.
+     */
+    virtual bool Contains(const std::string& folder, const std::string& file) const = 0;
+
+    /**
+     * @brief Read: Read a whole subsequence file.
+     * @param folder: The subsequence folder name (e.g. "subsequence_001").
+     * @param file: The file name inside the folder.
+     * @throws RunTimeError: If the file is missing or can't be read.
+     */
+    virtual ByteView Read(const std::string& folder, const std::string& file) const = 0;
+
+    /**
+     * @brief Contains: Check if the sequence holds a file outside of the subsequence folders (e.g. the manifest).
+     */
+    virtual bool Contains(const std::string& file) const = 0;
+
+    /**
+     * @brief Read: Read a file that lives outside of the subsequence folders (e.g. the manifest).
+     * @throws RunTimeError: If the file is missing or can't be read.
+     */
+    virtual ByteView Read(const std::string& file) const = 0;
+
+    /**
+     * @brief GetSubSequenceCount: The number of subsequence_XXX folders in the sequence.
+     */
+    virtual int GetSubSequenceCount() const = 0;
+
+    /**
+     * @brief GetFileRanges: The byte ranges a subsequence's files occupy, so they can be read ahead before the
+     *        subsequence is loaded. Empty when the storage has nothing to warm.
+     * @param folder: The subsequence folder name (e.g. "subsequence_001").
+     */
+    virtual std::vector<ByteRange> GetFileRanges(const std::string& /*folder*/) const { return {}; }
+};
+
+/**
+ * @brief DirectorySource: A sequence folder on disk, or the same layout under an http:// base URL.
+ */
+class DirectorySource : public SequenceSource {
+public:
+    /**
+     * @brief DirectorySource: constructor
+     * @param root: The sequence folder path or base URL.
+     */
+    explicit DirectorySource(const std::string& root);
+
+    bool Contains(const std::string& folder, const std::string& file) const override;
+    ByteView Read(const std::string& folder, const std::string& file) const override;
+    bool Contains(const std::string& file) const override;
+    ByteView Read(const std::string& file) const override;
+
+    /**
+     * @brief GetSubSequenceCount: Counts the subsequence_XXX folders. Servers can't list folders, so remote
+     *        sequences are probed one subsequence at a time; give them a manifest to avoid this.
+     */
+    int GetSubSequenceCount() const override;
+
+    /**
+     * @brief GetFileRanges: Every file of a local subsequence folder, nothing for remote folders.
+     */
+    std::vector<ByteRange> GetFileRanges(const std::string& folder) const override;
+
+private:
+    std::string Join(const std::string& folder, const std::string& file) const;
+
+    std::string root;
+    bool remote = false;
+};
+
+} // namespace TVMIO
@@ -0,0 +1,205 @@
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <zlib.h>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace TVMIO {
+
+MappedFile::MappedFile(const std::string& path) : filePath(path) {
+#if !defined(_WIN32)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat file: " + path);
+    }
+    size = static_cast<size_t>(st.st_size);
+
+    // mmap rejects zero length mappings, an empty file is just an empty view
+    if (size > 0) {
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            data = static_cast<const char*>(mapped);
+            isMapped = true;
+        }
+    }
+    ::close(fd);
+    if (isMapped || size == 0) return;
+#endif
+
+    // Fallback: read the whole file into memory
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+    fallbackBuffer.resize(size);
+    if (size > 0 && !file.read(fallbackBuffer.data(), size)) {
+        throw std::runtime_error("Failed to read file: " + path);
+    }
+    data = fallbackBuffer.data();
+}
+
+MappedFile::~MappedFile() {
+#if !defined(_WIN32)
+    if (isMapped) {
+        ::munmap(const_cast<char*>(data), size);
+    }
+#endif
+}
+
+void MappedFile::Prefetch(uint64_t offset, uint64_t bytes) const {
+    if (offset >= size) return;
+    bytes = std::min<uint64_t>(bytes, size - offset);
+#if !defined(_WIN32)
+    static const uint64_t pageSize = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+    if (isMapped) {
+        // madvise wants a page aligned start, the kernel then reads the range in large asynchronous requests
+        const uint64_t start = offset / pageSize * pageSize;
+        ::madvise(const_cast<char*>(data) + start, static_cast<size_t>(offset + bytes - start), MADV_WILLNEED);
+    }
+#else
+    const uint64_t pageSize = 4096;
+#endif
+    // Touch one byte per page so the range is resident (and the read is finished) when we return
+    volatile char sink = 0;
+    const uint64_t end = offset + bytes;
+    for (uint64_t page = offset / pageSize * pageSize; page < end; page += pageSize) {
+        sink += data[std::max(page, offset)];
+    }
+    (void)sink;
+}
+
+ByteView MapFile(const std::string& path) {
+    auto file = std::make_shared<MappedFile>(path);
+    ByteView view;
+    view.data = file->Data();
+    view.size = file->Size();
+    view.backing = std::move(file);
+    return view;
+}
+
+uint32_t Crc32(const char* data, uint64_t bytes) {
+    uLong crc = crc32(0L, Z_NULL, 0);
+    // zlib takes 32 bit lengths, feed large blocks in chunks
+    while (bytes > 0) {
+        const uInt chunk = static_cast<uInt>(std::min<uint64_t>(bytes, 1u << 30));
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(data), chunk);
+        data += chunk;
+        bytes -= chunk;
+    }
+    return static_cast<uint32_t>(crc);
+}
+
+uint64_t Hash64(const char* data, uint64_t bytes, uint64_t seed) {
+    const uint64_t m = 0xc6a4a7935bd1e995ull;
+    const int r = 47;
+    uint64_t h = seed ^ (bytes * m);
+    const char* end = data + (bytes & ~uint64_t(7));
+    for (; data != end; data += 8) {
+        uint64_t k;
+        std::memcpy(&k, data, sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+    const unsigned char* tail = reinterpret_cast<const unsigned char*>(data);
+    switch (bytes & 7) {
+        case 7: h ^= uint64_t(tail[6]) << 48; [[fallthrough]];
+        case 6: h ^= uint64_t(tail[5]) << 40; [[fallthrough]];
+        case 5: h ^= uint64_t(tail[4]) << 32; [[fallthrough]];
+        case 4: h ^= uint64_t(tail[3]) << 24; [[fallthrough]];
+        case 3: h ^= uint64_t(tail[2]) << 16; [[fallthrough]];
+        case 2: h ^= uint64_t(tail[1]) << 8; [[fallthrough]];
+        case 1: h ^= uint64_t(tail[0]);
+                h *= m;
+    }
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+bool Inflate(const char* data, uint64_t bytes, char* out, uint64_t outBytes, bool raw) {
+    z_stream stream{};
+    if (inflateInit2(&stream, raw ? -MAX_WBITS : MAX_WBITS) != Z_OK) {
+        return false;
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.next_out = reinterpret_cast<Bytef*>(out);
+    uint64_t inRemaining = bytes, outRemaining = outBytes;
+    int status = Z_OK;
+    while (status == Z_OK) {
+        // zlib counts in 32 bits, refill in chunks for very large streams
+        if (stream.avail_in == 0) {
+            stream.avail_in = static_cast<uInt>(std::min<uint64_t>(inRemaining, 1u << 30));
+            inRemaining -= stream.avail_in;
+        }
+        if (stream.avail_out == 0) {
+            stream.avail_out = static_cast<uInt>(std::min<uint64_t>(outRemaining, 1u << 30));
+            outRemaining -= stream.avail_out;
+        }
+        const uInt inBefore = stream.avail_in, outBefore = stream.avail_out;
+        status = inflate(&stream, Z_NO_FLUSH);
+        if (status == Z_BUF_ERROR) {
+            // Only a window that ran dry may resume, a truncated stream or a full buffer never gets further
+            if (stream.avail_in == inBefore && stream.avail_out == outBefore) {
+                inflateEnd(&stream);
+                throw std::runtime_error("Inflate made no progress, the stream is truncated or larger than expected");
+            }
+            status = Z_OK;
+        }
+    }
+    const uint64_t produced = stream.total_out;
+    inflateEnd(&stream);
+    return status == Z_STREAM_END && produced == outBytes;
+}
+
+std::vector<char> Deflate(const char* data, uint64_t bytes, int level) {
+    z_stream stream{};
+    if (deflateInit(&stream, level) != Z_OK) {
+        throw std::runtime_error("Failed to initialize deflate");
+    }
+    std::vector<char> out;
+    std::vector<char> chunk(1 << 20);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    uint64_t inRemaining = bytes;
+    int status = Z_OK;
+    while (status != Z_STREAM_END) {
+        if (stream.avail_in == 0 && inRemaining > 0) {
+            stream.avail_in = static_cast<uInt>(std::min<uint64_t>(inRemaining, 1u << 30));
+            inRemaining -= stream.avail_in;
+        }
+        stream.next_out = reinterpret_cast<Bytef*>(chunk.data());
+        stream.avail_out = static_cast<uInt>(chunk.size());
+        status = deflate(&stream, inRemaining > 0 ? Z_NO_FLUSH : Z_FINISH);
+        if (status == Z_STREAM_ERROR) {
+            deflateEnd(&stream);
+            throw std::runtime_error("Deflate failed");
+        }
+        out.insert(out.end(), chunk.data(), chunk.data() + (chunk.size() - stream.avail_out));
+    }
+    deflateEnd(&stream);
+    return out;
+}
+
+bool FileExists(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 && (st.st_mode & S_IFMT) == S_IFREG;
+}
+
+} // namespace TVMIO
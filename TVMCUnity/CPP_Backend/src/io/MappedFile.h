@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TVMIO {
+
+/**
+ * @brief ByteView: A span of bytes together with the object that keeps them alive
+ *        (a memory mapped file, an inflated zip entry, ...).
+ */
+struct ByteView {
+    std::shared_ptr<const void> backing;
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * @brief MappedFile: Read-only view of a whole file. Uses mmap where available and falls back to
+ *        reading the file into an owned buffer otherwise. The view stays valid for the object's lifetime.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief MappedFile: constructor
+     * @param path: The file path of the file we are mapping.
+     * @throws RunTimeError: If the file can't be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Prefetch: Bring a byte range into memory ahead of use. Asks the kernel to start reading the range
+     *        (madvise WILLNEED) and then touches every page, so the range is resident when this returns.
+     * @param offset: The first byte of the range.
+     * @param bytes: The number of bytes, clamped to the end of the file.
+     */
+    void Prefetch(uint64_t offset, uint64_t bytes) const;
+
+    // Getter functions
+    const char* Data() const { return data; }
+    size_t Size() const { return size; }
+    const std::string& GetPath() const { return filePath; }
+
+private:
+    std::string filePath;
+    const char* data = nullptr;
+    size_t size = 0;
+    bool isMapped = false;
+    std::vector<char> fallbackBuffer;
+};
+
+/**
+ * @brief MapFile: Memory map a whole file as a ByteView.
+ * @param path: The file path of the file we are mapping.
+ * @throws RunTimeError: If the file can't be opened or mapped.
+ */
+ByteView MapFile(const std::string& path);
+
+/**
+ * @brief Crc32: Compute the zlib CRC32 of a block of bytes (any size).
+ * @param data: A pointer to the bytes.
+ * @param bytes: The number of bytes.
+ * @return The CRC32 value.
+ */
+uint32_t Crc32(const char* data, uint64_t bytes);
+
+/**
+ * @brief Hash64: Compute a 64 bit hash of a block of bytes (MurmurHash64A, not cryptographic). Chain blocks by
+ *        passing the previous hash as the seed.
+ * @param data: A pointer to the bytes.
+ * @param bytes: The number of bytes.
+ * @param seed: The starting value.
+ * @return The hash value.
+ */
+uint64_t Hash64(const char* data, uint64_t bytes, uint64_t seed = 0);
+
+/**
+ * @brief Inflate: Decompress a zlib (or raw deflate) stream of any size into a buffer of known size.
+ * @param data: A pointer to the compressed bytes.
+ * @param bytes: The number of compressed bytes.
+ * @param out: The buffer receiving the decompressed bytes.
+ * @param outBytes: The exact decompressed size.
+ * @param raw: True for a raw deflate stream (as stored in zip entries), false for a zlib stream.
+ * @return A boolean representing if the stream decompressed to exactly outBytes.
+ * @throws std::runtime_error if the stream stops short of its end (truncated, or more than outBytes).
+ */
+bool Inflate(const char* data, uint64_t bytes, char* out, uint64_t outBytes, bool raw = false);
+
+/**
+ * @brief Deflate: Compress a block of bytes (any size) into a zlib stream.
+ * @param data: A pointer to the bytes.
+ * @param bytes: The number of bytes.
+ * @param level: The zlib compression level (0-9).
+ * @return The compressed stream.
+ */
+std::vector<char> Deflate(const char* data, uint64_t bytes, int level = 6);
+
+/**
+ * @brief FileExists: Check whether a regular file exists at the given path.
+ * @param path: The file path to check.
+ * @return A boolean representing if the file exists.
+ */
+bool FileExists(const std::string& path);
+
+} // namespace TVMIO
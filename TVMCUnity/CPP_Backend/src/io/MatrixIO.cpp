@@ -1,110 +1,518 @@
 #include "MatrixIO.h"
+#include "MappedFile.h"
 #include "TVMLogger.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <vector>
 #include <stdexcept>
+#include <string_view>
 #include <iostream>
 
-Eigen::MatrixXd MatrixIO::loadtxt(const std::string& filename) {
-    // Load file
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + filename);
-    }
+namespace {
+
+constexpr char kMatrixMagic[4] = {'T', 'V', 'M', 'M'};
+constexpr uint32_t kMatrixVersion = 1;
+constexpr uint32_t kEncodedMatrixVersion = 2;
+constexpr uint64_t kAlignment = 64;
 
-    std::vector<std::vector<double>> rows;
-    std::string line;
+using MatrixIO::MatrixCompression;
+using MatrixIO::MatrixEncoding;
+
+std::atomic<int64_t> g_maxRows{MatrixIO::LoadLimits().maxRows};
+std::atomic<int64_t> g_maxCols{MatrixIO::LoadLimits().maxCols};
+
+bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
 
-    while (std::getline(file, line)) {
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
+// Parse a single token, the whole token must be consumed
+double ParseToken(const char* first, const char* last, const std::string& name) {
+    const std::string_view token(first, last - first);
+    if (*first == '+') {
+        ++first;  // from_chars does not accept a leading '+'
+        if (first < last && (*first == '+' || *first == '-')) {
+            throw std::runtime_error("Invalid double in " + name + ": " + std::string(token));
         }
+    }
+    double val = 0.0;
+#if defined(__cpp_lib_to_chars)
+    auto result = std::from_chars(first, last, val);
+    if (result.ec == std::errc::result_out_of_range) {
+        throw std::runtime_error("Number out of range in " + name + ": " + std::string(token));
+    }
+    if (result.ec != std::errc() || result.ptr != last) {
+        throw std::runtime_error("Invalid double in " + name + ": " + std::string(token));
+    }
+#else
+    // strtod needs a terminated string, mapped files are not terminated
+    char buffer[64];
+    const size_t length = static_cast<size_t>(last - first);
+    if (length == 0 || length >= sizeof(buffer)) {
+        throw std::runtime_error("Invalid double in " + name + ": " + std::string(token));
+    }
+    std::memcpy(buffer, first, length);
+    buffer[length] = '\0';
+    char* end = nullptr;
+    errno = 0;
+    val = std::strtod(buffer, &end);
+    if (end != buffer + length) {
+        throw std::runtime_error("Invalid double in " + name + ": " + std::string(token));
+    }
+    if (errno == ERANGE) {
+        throw std::runtime_error("Number out of range in " + name + ": " + std::string(token));
+    }
+#endif
+    return val;
+}
 
-        std::vector<double> row;
-        size_t start = 0;
+// a * b, false when it does not fit (header fields come straight from the file)
+bool CheckedMul(uint64_t a, uint64_t b, uint64_t& product) {
+    if (a != 0 && b > UINT64_MAX / a) {
+        return false;
+    }
+    product = a * b;
+    return true;
+}
 
-        while (start < line.size()) {
-            // Skip whitespace
-            while (start < line.size() && std::isspace(line[start])) ++start;
-            if (start >= line.size()) break;
+uint64_t AlignUp(uint64_t value) {
+    return (value + kAlignment - 1) / kAlignment * kAlignment;
+}
 
-            // Find next delimiter (space or end)
-            size_t end = start;
-            while (end < line.size() && !std::isspace(line[end])) ++end;
+size_t ElementSize(MatrixEncoding encoding) {
+    switch (encoding) {
+        case MatrixEncoding::Float64: return sizeof(double);
+        case MatrixEncoding::Float32: return sizeof(float);
+        case MatrixEncoding::Float16: return sizeof(uint16_t);
+        case MatrixEncoding::Int16: return sizeof(int16_t);
+    }
+    return 0;
+}
 
-            std::string token = line.substr(start, end - start);
+// Bytes of the per column (offset, scale) table that precedes Int16 payloads
+uint64_t ScaleTableBytes(MatrixEncoding encoding, uint64_t cols) {
+    return encoding == MatrixEncoding::Int16 ? AlignUp(cols * 2 * sizeof(double)) : 0;
+}
 
-            // Parse number
-            if (!token.empty()) {
-                try {
-                    double val = std::stod(token);
-                    row.push_back(val);
-                } catch (const std::invalid_argument&) {
-                    throw std::runtime_error("Invalid double in " + filename + ": " + token);
-                } catch (const std::out_of_range&) {
-                    throw std::runtime_error("Number out of range in " + filename + ": " + token);
-                }
+float BitsToFloat(uint32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+uint32_t FloatToBits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+// Branch free half -> float, handles subnormals, infinities and NaN. Written so the
+// decode loops below vectorize and never touch denormal floats (slow on many CPUs).
+float HalfToFloat(uint16_t h) {
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+    const uint32_t exponent = h & 0x7C00u;
+    const uint32_t mantissa = h & 0x03FFu;
+    // Rebias the exponent (15 -> 127), the all-ones exponent (Inf/NaN) maps to the float one
+    uint32_t bits = exponent == 0x7C00u ? 0x7F800000u | (mantissa << 13) : ((exponent + 0x1C000u) | mantissa) << 13;
+    // Zero and subnormals are mantissa * 2^-24
+    bits = exponent == 0 ? FloatToBits(static_cast<float>(mantissa) * 5.9604644775390625e-8f) : bits;
+    return BitsToFloat(bits | sign);
+}
+
+// float -> half with round to nearest even, overflow saturates to infinity
+uint16_t FloatToHalf(float value) {
+    uint32_t bits = FloatToBits(value);
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+    uint16_t half;
+    if (bits >= (143u << 23)) {
+        half = bits > 0x7F800000u ? 0x7E00 : 0x7C00;         // NaN or too large
+    } else if (bits < (113u << 23)) {
+        // Subnormal half, let the FPU do the rounding
+        const uint32_t denormMagic = 126u << 23;
+        half = static_cast<uint16_t>(FloatToBits(BitsToFloat(bits) + BitsToFloat(denormMagic)) - denormMagic);
+    } else {
+        const uint32_t mantissaOdd = (bits >> 13) & 1;
+        bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xFFF + mantissaOdd;
+        half = static_cast<uint16_t>(bits >> 13);
+    }
+    return static_cast<uint16_t>(half | (sign >> 16));
+}
+
+// Decode an encoded payload into a column-major float64 matrix
+void DecodeColumns(const char* payload, const MatrixIO::MatrixFileHeader& header, Eigen::MatrixXd& mat) {
+    const auto encoding = static_cast<MatrixEncoding>(header.encoding);
+    const Eigen::Index rows = mat.rows();
+    const size_t columnBytes = header.columnStride * ElementSize(encoding);
+    const char* columns = payload + ScaleTableBytes(encoding, header.cols);
+
+    for (Eigen::Index c = 0; c < mat.cols(); ++c) {
+        const char* column = columns + c * columnBytes;
+        double* out = mat.col(c).data();
+        switch (encoding) {
+            case MatrixEncoding::Float32: {
+                mat.col(c) = Eigen::Map<const Eigen::VectorXf>(reinterpret_cast<const float*>(column), rows).cast<double>();
+                break;
+            }
+            case MatrixEncoding::Float16: {
+                const uint16_t* in = reinterpret_cast<const uint16_t*>(column);
+                for (Eigen::Index r = 0; r < rows; ++r) out[r] = HalfToFloat(in[r]);
+                break;
+            }
+            case MatrixEncoding::Int16: {
+                const double* table = reinterpret_cast<const double*>(payload);
+                const double offset = table[2 * c], scale = table[2 * c + 1];
+                const int16_t* in = reinterpret_cast<const int16_t*>(column);
+                for (Eigen::Index r = 0; r < rows; ++r) out[r] = offset + scale * in[r];
+                break;
             }
+            case MatrixEncoding::Float64: {
+                std::memcpy(out, column, rows * sizeof(double));
+                break;
+            }
+        }
+    }
+}
+
+// Encode a column-major float64 matrix into a padded payload
+std::vector<char> EncodeColumns(const Eigen::Ref<const Eigen::MatrixXd>& mat, MatrixEncoding encoding,
+                                uint64_t columnStride) {
+    const uint64_t cols = static_cast<uint64_t>(mat.cols());
+    const uint64_t tableBytes = ScaleTableBytes(encoding, cols);
+    const size_t columnBytes = columnStride * ElementSize(encoding);
+    std::vector<char> payload(tableBytes + columnBytes * cols, 0);
 
-            start = end;
+    for (Eigen::Index c = 0; c < mat.cols(); ++c) {
+        char* column = payload.data() + tableBytes + c * columnBytes;
+        switch (encoding) {
+            case MatrixEncoding::Float64: {
+                Eigen::Map<Eigen::VectorXd>(reinterpret_cast<double*>(column), mat.rows()) = mat.col(c);
+                break;
+            }
+            case MatrixEncoding::Float32: {
+                Eigen::Map<Eigen::VectorXf>(reinterpret_cast<float*>(column), mat.rows()) = mat.col(c).cast<float>();
+                break;
+            }
+            case MatrixEncoding::Float16: {
+                uint16_t* out = reinterpret_cast<uint16_t*>(column);
+                for (Eigen::Index r = 0; r < mat.rows(); ++r) out[r] = FloatToHalf(static_cast<float>(mat(r, c)));
+                break;
+            }
+            case MatrixEncoding::Int16: {
+                // Map [min, max] of the column onto [-32767, 32767]
+                const double minValue = mat.col(c).minCoeff(), maxValue = mat.col(c).maxCoeff();
+                const double offset = 0.5 * (maxValue + minValue);
+                const double scale = 0.5 * (maxValue - minValue) / 32767.0;
+                double* table = reinterpret_cast<double*>(payload.data());
+                table[2 * c] = offset;
+                table[2 * c + 1] = scale;
+                int16_t* out = reinterpret_cast<int16_t*>(column);
+                for (Eigen::Index r = 0; r < mat.rows(); ++r) {
+                    const double q = scale > 0.0 ? std::round((mat(r, c) - offset) / scale) : 0.0;
+                    out[r] = static_cast<int16_t>(std::clamp(q, -32767.0, 32767.0));
+                }
+                break;
+            }
         }
+    }
+    return payload;
+}
 
-        // Add non-empty rows, ensuring consistent column count
-        if (!row.empty()) {
-            if (!rows.empty() && row.size() != rows[0].size()) {
-                throw std::runtime_error("Inconsistent column count in: " + filename);
+const char* SkipBlanks(const char* p, const char* end) {
+    while (p < end && IsBlank(*p)) ++p;
+    return p;
+}
+
+const char* LineEnd(const char* p, const char* end) {
+    const void* nl = std::memchr(p, '\n', end - p);
+    return nl ? static_cast<const char*>(nl) : end;
+}
+
+} // anonymous namespace
+
+Eigen::MatrixXd MatrixIO::loadtxt(const std::string& filename) {
+    // Load file
+    TVMIO::MappedFile file(filename);
+    return loadtxt(file.Data(), file.Size(), filename);
+}
+
+Eigen::MatrixXd MatrixIO::loadtxt(const char* data, size_t size, const std::string& name) {
+    const char* end = data + size;
+
+    // First pass: count the non-empty rows and the columns of the first row so the
+    // matrix can be allocated once
+    Eigen::Index rows = 0, cols = 0;
+    for (const char* line = data; line < end;) {
+        const char* lineEnd = LineEnd(line, end);
+        const char* p = SkipBlanks(line, lineEnd);
+        if (p < lineEnd) {
+            if (rows == 0) {
+                while (p < lineEnd) {
+                    while (p < lineEnd && !IsBlank(*p)) ++p;
+                    ++cols;
+                    p = SkipBlanks(p, lineEnd);
+                }
             }
-            rows.push_back(row);
+            ++rows;
         }
+        if (lineEnd == end) break;
+        line = lineEnd + 1;
     }
 
-    if (rows.empty()) {
-        throw std::runtime_error("No data found in: " + filename);
+    if (rows == 0) {
+        throw std::runtime_error("No data found in: " + name);
     }
 
-    // Convert to Eigen matrix
-    Eigen::MatrixXd mat(rows.size(), rows[0].size());
-    for (size_t i = 0; i < rows.size(); ++i) {
-        for (size_t j = 0; j < rows[i].size(); ++j) {
-            mat(i, j) = rows[i][j];
+    // Second pass: parse each token straight into the column-major matrix
+    Eigen::MatrixXd mat(rows, cols);
+    Eigen::Index row = 0;
+    for (const char* line = data; line < end;) {
+        const char* lineEnd = LineEnd(line, end);
+        const char* p = SkipBlanks(line, lineEnd);
+        if (p < lineEnd) {
+            Eigen::Index col = 0;
+            while (p < lineEnd) {
+                const char* tokenEnd = p;
+                while (tokenEnd < lineEnd && !IsBlank(*tokenEnd)) ++tokenEnd;
+                if (col >= cols) {
+                    throw std::runtime_error("Inconsistent column count in: " + name);
+                }
+                mat(row, col++) = ParseToken(p, tokenEnd, name);
+                p = SkipBlanks(tokenEnd, lineEnd);
+            }
+            if (col != cols) {
+                throw std::runtime_error("Inconsistent column count in: " + name);
+            }
+            ++row;
         }
+        if (lineEnd == end) break;
+        line = lineEnd + 1;
     }
 
     return mat;
 }
 
+MatrixIO::MappedMatrix::MappedMatrix(Eigen::MatrixXd mat)
+    : owned(std::move(mat)) {
+    values = owned.data();
+    numRows = owned.rows();
+    numCols = owned.cols();
+    stride = owned.rows();
+}
+
+MatrixIO::MappedMatrix::MappedMatrix(std::shared_ptr<const void> backingObject, const double* data,
+                                     Eigen::Index rows, Eigen::Index cols, Eigen::Index columnStride)
+    : backing(std::move(backingObject)), values(data), numRows(rows), numCols(cols), stride(columnStride) {}
 
+void MatrixIO::MappedMatrix::Reset() {
+    Eigen::MatrixXd().swap(owned);
+    backing.reset();
+    values = nullptr;
+    numRows = numCols = stride = 0;
+}
+
+void MatrixIO::SetLoadLimits(const LoadLimits& limits) {
+    g_maxRows.store(limits.maxRows);
+    g_maxCols.store(limits.maxCols);
+}
+
+MatrixIO::LoadLimits MatrixIO::GetLoadLimits() {
+    LoadLimits limits;
+    limits.maxRows = g_maxRows.load();
+    limits.maxCols = g_maxCols.load();
+    return limits;
+}
+
+MatrixIO::MappedMatrix MatrixIO::loadbin(const std::string& filename) {
+    auto file = std::make_shared<TVMIO::MappedFile>(filename);
+    const char* data = file->Data();
+    const size_t size = file->Size();
+    return loadbin(std::move(file), data, size, filename);
+}
+
+MatrixIO::MappedMatrix MatrixIO::loadbin(std::shared_ptr<const void> backing, const char* data, size_t size,
+                                         const std::string& name) {
+    const LoadLimits limits = GetLoadLimits();
+
+    // Aligned format: validate the header and view the payload in place
+    if (size >= sizeof(MatrixFileHeader) && std::memcmp(data, kMatrixMagic, 4) == 0) {
+        MatrixFileHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        LOG_INFO("[MatrixIO] Shape from header: ", header.rows, " rows x ", header.cols, " cols");
+
+        if (header.version != kMatrixVersion && header.version != kEncodedMatrixVersion) {
+            throw std::runtime_error("Unsupported BIN version in " + name);
+        }
+        if (header.version == kMatrixVersion) {
+            header.encoding = static_cast<uint16_t>(MatrixEncoding::Float64);
+            header.compression = static_cast<uint16_t>(MatrixCompression::None);
+            header.storedBytes = header.dataBytes;
+        }
+        if (header.encoding > static_cast<uint16_t>(MatrixEncoding::Int16) ||
+            header.compression > static_cast<uint16_t>(MatrixCompression::Deflate)) {
+            throw std::runtime_error("Unsupported BIN encoding in " + name);
+        }
+        const auto encoding = static_cast<MatrixEncoding>(header.encoding);
+        const auto compression = static_cast<MatrixCompression>(header.compression);
+        const size_t elementSize = ElementSize(encoding);
+
+        if (header.rows == 0 || header.cols == 0 ||
+            header.rows > static_cast<uint64_t>(limits.maxRows) || header.cols > static_cast<uint64_t>(limits.maxCols) ||
+            header.columnStride < header.rows || header.columnStride > header.dataBytes / elementSize) {
+            throw std::runtime_error("Corrupt BIN: invalid dimensions in " + name);
+        }
+        // The stride is bounded by dataBytes, the products can still wrap with a huge dataBytes
+        uint64_t strideValues = 0, neededValues = 0;
+        if (!CheckedMul(header.cols - 1, header.columnStride, strideValues) ||
+            strideValues > UINT64_MAX - header.rows ||
+            !CheckedMul(strideValues + header.rows, elementSize, neededValues) ||
+            neededValues > UINT64_MAX - ScaleTableBytes(encoding, header.cols)) {
+            throw std::runtime_error("Corrupt BIN: invalid dimensions in " + name);
+        }
+        const uint64_t needed = ScaleTableBytes(encoding, header.cols) + neededValues;
+        if (header.dataOffset % alignof(double) != 0 || header.dataBytes < needed ||
+            header.dataOffset > size || size - header.dataOffset < header.storedBytes) {
+            throw std::runtime_error("Corrupt BIN: truncated payload in " + name);
+        }
+        if (compression == MatrixCompression::None && header.storedBytes != header.dataBytes) {
+            throw std::runtime_error("Corrupt BIN: payload size mismatch in " + name);
+        }
+        // The inflated size comes from the header, do not let a corrupt one allocate more than the matrix needs
+        if (compression == MatrixCompression::Deflate &&
+            header.dataBytes > needed + header.cols * kAlignment) {
+            throw std::runtime_error("Corrupt BIN: invalid payload size in " + name);
+        }
 
+        const char* payload = data + header.dataOffset;
+        const Eigen::Index rows = static_cast<Eigen::Index>(header.rows);
+        const Eigen::Index cols = static_cast<Eigen::Index>(header.cols);
+        if (compression == MatrixCompression::Deflate) {
+            auto inflated = std::make_shared<std::vector<char>>(static_cast<size_t>(header.dataBytes));
+            if (!TVMIO::Inflate(payload, header.storedBytes, inflated->data(), inflated->size())) {
+                throw std::runtime_error("Corrupt BIN: failed to inflate payload in " + name);
+            }
+            payload = inflated->data();
+            backing = std::move(inflated);
+        } else if (reinterpret_cast<uintptr_t>(payload) % alignof(double) != 0) {
+            // e.g. a stored zip entry, take an aligned copy before viewing it
+            auto copy = std::make_shared<std::vector<char>>(payload, payload + header.dataBytes);
+            payload = copy->data();
+            backing = std::move(copy);
+        }
 
-Eigen::MatrixXd MatrixIO::LoadDeltaTrajectories(const std::string& bin_file_path) {
-    //Load File
-    std::ifstream file(bin_file_path, std::ios::binary);
-    if (!file) {
-        throw std::runtime_error("Failed to open binary displacement file.");
+        // Float64 is viewed in place (in the mapping or the inflated buffer), other encodings are decoded once
+        if (encoding == MatrixEncoding::Float64) {
+            const double* values = reinterpret_cast<const double*>(payload);
+            return MappedMatrix(std::move(backing), values, rows, cols, static_cast<Eigen::Index>(header.columnStride));
+        }
+        Eigen::MatrixXd mat(rows, cols);
+        DecodeColumns(payload, header, mat);
+        return MappedMatrix(std::move(mat));
     }
 
-    //Set Values
+    // Legacy format: int32 header followed by row-major values
     int32_t numRows = 0, numCols = 0;
-    file.read(reinterpret_cast<char*>(&numRows), sizeof(int32_t));
-    file.read(reinterpret_cast<char*>(&numCols), sizeof(int32_t));
-    LOG_INFO("[Decoder] Shape from header: ", numRows, " rows x ", numCols," cols");
+    const size_t headerSize = 2 * sizeof(int32_t);
+    if (size < headerSize) {
+        throw std::runtime_error("Corrupt BIN: missing header in " + name);
+    }
+    std::memcpy(&numRows, data, sizeof(int32_t));
+    std::memcpy(&numCols, data + sizeof(int32_t), sizeof(int32_t));
+    LOG_INFO("[MatrixIO] Shape from header: ", numRows, " rows x ", numCols, " cols");
 
     //Check for valid shape
-    if (numRows <= 0 || numCols <= 0 || numCols > 1000 || numRows > 1000000) {
-        LOG_ERROR("[Decoder] ❌ Invalid shape. Rejecting BIN.");
-        throw std::runtime_error("Corrupt BIN: invalid dimensions");
+    if (numRows <= 0 || numCols <= 0 || numRows > limits.maxRows || numCols > limits.maxCols) {
+        LOG_ERROR("[MatrixIO] ❌ Invalid shape. Rejecting BIN.");
+        throw std::runtime_error("Corrupt BIN: invalid dimensions in " + name);
+    }
+    const size_t byteCount = static_cast<size_t>(numRows) * static_cast<size_t>(numCols) * sizeof(double);
+    if (size - headerSize < byteCount) {
+        throw std::runtime_error("Corrupt BIN: truncated payload in " + name);
     }
 
-    const size_t totalValues = static_cast<size_t>(numRows) * numCols;
-    const size_t byteCount = totalValues * sizeof(double);
+    LOG_INFO("[MatrixIO] ", name, " uses the legacy row-major layout, convert it with "
+             "npy_to_bin_recursive.py to load it without copies");
 
-    std::vector<double> buffer(totalValues);
-    file.read(reinterpret_cast<char*>(buffer.data()), byteCount);
+    // Single copy from the row-major file into the column-major matrix
+    Eigen::MatrixXd mat(numRows, numCols);
+    const char* payload = data + headerSize;
+    if (reinterpret_cast<uintptr_t>(payload) % alignof(double) == 0) {
+        mat = Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+            reinterpret_cast<const double*>(payload), numRows, numCols);
+    } else {
+        for (int32_t r = 0; r < numRows; ++r) {
+            for (int32_t c = 0; c < numCols; ++c) {
+                std::memcpy(&mat(r, c), payload + (static_cast<size_t>(r) * numCols + c) * sizeof(double), sizeof(double));
+            }
+        }
+    }
+    return MappedMatrix(std::move(mat));
+}
 
-    //Project and return
-    Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> mat64(buffer.data(), numRows, numCols);
-    Eigen::MatrixXd mat32 = mat64.cast<double>();
+std::vector<char> MatrixIO::tobin(const Eigen::Ref<const Eigen::MatrixXd>& mat, const EncodeOptions& options) {
+    // Pad every column to a whole number of 64 byte lines
+    const uint64_t valuesPerLine = kAlignment / ElementSize(options.encoding);
+    const uint64_t rows = static_cast<uint64_t>(mat.rows());
+    const uint64_t stride = (rows + valuesPerLine - 1) / valuesPerLine * valuesPerLine;
+    const bool encoded = options.encoding != MatrixEncoding::Float64 || options.compression != MatrixCompression::None;
 
-    return mat32;
+    MatrixFileHeader header{};
+    std::memcpy(header.magic, kMatrixMagic, 4);
+    header.version = encoded ? kEncodedMatrixVersion : kMatrixVersion;
+    header.rows = rows;
+    header.cols = static_cast<uint64_t>(mat.cols());
+    header.columnStride = stride;
+    header.dataOffset = sizeof(MatrixFileHeader);
+
+    std::vector<char> payload = EncodeColumns(mat, options.encoding, stride);
+    header.dataBytes = payload.size();
+    if (options.compression == MatrixCompression::Deflate) {
+        payload = TVMIO::Deflate(payload.data(), payload.size(), options.level);
+    }
+    if (encoded) {
+        header.encoding = static_cast<uint16_t>(options.encoding);
+        header.compression = static_cast<uint16_t>(options.compression);
+        header.storedBytes = payload.size();
+    }
+
+    std::vector<char> bytes(header.dataOffset + payload.size(), 0);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + header.dataOffset, payload.data(), payload.size());
+    return bytes;
+}
+
+bool MatrixIO::savebin(const std::string& filename, const Eigen::Ref<const Eigen::MatrixXd>& mat,
+                       const EncodeOptions& options) {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) return false;
+    const std::vector<char> bytes = tobin(mat, options);
+    out.write(bytes.data(), bytes.size());
+    return static_cast<bool>(out);
 }
 
+MatrixIO::MatrixEncoding MatrixIO::ParseEncoding(const std::string& name) {
+    if (name == "f64") return MatrixEncoding::Float64;
+    if (name == "f32") return MatrixEncoding::Float32;
+    if (name == "f16") return MatrixEncoding::Float16;
+    if (name == "q16") return MatrixEncoding::Int16;
+    throw std::invalid_argument("Unknown matrix encoding: " + name + " (expected f64, f32, f16 or q16)");
+}
+
+MatrixIO::MappedMatrix MatrixIO::LoadMatrix(const std::string& directory, const std::string& stem) {
+    std::filesystem::path dirPath(directory);
+    std::string binFile = (dirPath / (stem + ".bin")).string();
+    if (TVMIO::FileExists(binFile)) {
+        return loadbin(binFile);
+    }
+    return MappedMatrix(loadtxt((dirPath / (stem + ".txt")).string()));
+}
+
+MatrixIO::MappedMatrix MatrixIO::LoadDeltaTrajectories(const std::string& bin_file_path) {
+    return loadbin(bin_file_path);
+}
@@ -1,9 +1,138 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 #include <Eigen/Dense>
 
 namespace MatrixIO {
+    /**
+     * @brief ConstMatrixMap: A read-only column-major view with a (possibly padded) column stride.
+     */
+    using ConstMatrixMap = Eigen::Map<const Eigen::MatrixXd, Eigen::Unaligned, Eigen::OuterStride<>>;
+
+    /**
+     * @brief MatrixEncoding: How the values of a binary matrix are stored (version 2 files).
+     *        Float64 files are used in place, the others are decoded into a float64 matrix on load.
+     */
+    enum class MatrixEncoding : uint16_t {
+        Float64 = 0,  // Raw float64
+        Float32 = 1,  // IEEE float32
+        Float16 = 2,  // IEEE half precision
+        Int16 = 3     // Per column quantization: value = offset + scale * q, one (offset, scale) pair per column
+    };
+
+    /**
+     * @brief MatrixCompression: Optional compression of the payload (version 2 files).
+     */
+    enum class MatrixCompression : uint16_t {
+        None = 0,
+        Deflate = 1   // The payload is a single zlib stream of storedBytes bytes that inflates to dataBytes
+    };
+
+    /**
+     * @brief MatrixFileHeader: Header of the aligned binary matrix format (".bin" files starting with "TVMM").
+     *        The payload is column-major starting at dataOffset (a multiple of 64 bytes), with every column padded
+     *        to columnStride values so each column also starts on a 64 byte boundary. Version 1 files are always
+     *        float64 and can be memory mapped and used in place without any copies. Version 2 adds an encoding
+     *        and compression; Int16 payloads start with the per column (offset, scale) float64 pairs, padded
+     *        to 64 bytes.
+     */
+    struct MatrixFileHeader {
+        char magic[4];          // "TVMM"
+        uint32_t version;       // Format version (1, or 2 when encoded/compressed)
+        uint64_t rows;          // Number of rows
+        uint64_t cols;          // Number of columns
+        uint64_t columnStride;  // Distance between columns in values (>= rows)
+        uint64_t dataOffset;    // Byte offset of the payload from the start of the header
+        uint64_t dataBytes;     // Byte size of the (decompressed) payload
+        uint16_t encoding;      // MatrixEncoding, zero in version 1
+        uint16_t compression;   // MatrixCompression, zero in version 1
+        uint32_t reserved;      // Zero
+        uint64_t storedBytes;   // Byte size of the payload in the file, zero in version 1 (same as dataBytes)
+    };
+    static_assert(sizeof(MatrixFileHeader) == 64, "MatrixFileHeader must be 64 bytes");
+
+    /**
+     * @brief EncodeOptions: How tobin/savebin store a matrix. The defaults write a version 1 float64 file.
+     */
+    struct EncodeOptions {
+        MatrixEncoding encoding = MatrixEncoding::Float64;
+        MatrixCompression compression = MatrixCompression::None;
+        int level = 6;  // zlib level used with Deflate
+    };
+
+    /**
+     * @brief ParseEncoding: Parse an encoding name ("f64", "f32", "f16" or "q16").
+     * @param name: The encoding name.
+     * @throws InvalidArgument: If the name is unknown.
+     * @return The encoding.
+     */
+    MatrixEncoding ParseEncoding(const std::string& name);
+
+    /**
+     * @brief LoadLimits: Sanity limits applied to matrix dimensions read from binary headers.
+     */
+    struct LoadLimits {
+        int64_t maxRows = 1000000;
+        int64_t maxCols = 1000;
+    };
+
+    /**
+     * @brief SetLoadLimits: Set the dimension limits used when reading binary matrices.
+     * @param limits: The new limits.
+     */
+    void SetLoadLimits(const LoadLimits& limits);
+
+    /**
+     * @brief GetLoadLimits: Get the dimension limits used when reading binary matrices.
+     * @return The current limits.
+     */
+    LoadLimits GetLoadLimits();
+
+    /**
+     * @brief MappedMatrix: A loaded matrix that either views memory owned by a backing object
+     *        (e.g. a memory mapped file) or owns its values.
+     */
+    class MappedMatrix {
+    public:
+        MappedMatrix() = default;
+
+        /**
+         * @brief MappedMatrix: Take ownership of an already built matrix.
+         * @param owned: The matrix to store.
+         */
+        explicit MappedMatrix(Eigen::MatrixXd owned);
+
+        /**
+         * @brief MappedMatrix: View values kept alive by a backing object.
+         * @param backing: The object owning the memory (kept alive by this matrix).
+         * @param values: Pointer to the first column-major value.
+         * @param rows: Number of rows.
+         * @param cols: Number of columns.
+         * @param columnStride: Distance between columns in values.
+         */
+        MappedMatrix(std::shared_ptr<const void> backing, const double* values,
+                     Eigen::Index rows, Eigen::Index cols, Eigen::Index columnStride);
+
+        // Getter functions
+        ConstMatrixMap Map() const { return ConstMatrixMap(values, numRows, numCols, Eigen::OuterStride<>(stride)); }
+        Eigen::Index rows() const { return numRows; }
+        Eigen::Index cols() const { return numCols; }
+        bool IsEmpty() const { return numRows == 0 || numCols == 0; }
+        bool IsMapped() const { return backing != nullptr; }
+
+        // Memory cleanup
+        void Reset();
+
+    private:
+        Eigen::MatrixXd owned;
+        std::shared_ptr<const void> backing;
+        const double* values = nullptr;
+        Eigen::Index numRows = 0, numCols = 0, stride = 0;
+    };
+
     /**
      * @brief loadtxt: Load a .txt file as a matrix for use with the decoder.
      * @param filename: A string corresponding to the filepath of the file we are reading.
@@ -11,11 +140,67 @@ namespace MatrixIO {
      */
     Eigen::MatrixXd loadtxt(const std::string& filename);
 
+    /**
+     * @brief loadtxt: Parse whitespace separated text already held in memory as a matrix.
+     * @param data: A pointer to the first character of the text.
+     * @param size: The number of characters in the text.
+     * @param name: A name for the text used in error messages.
+     * @return A convererted matrix based off the text.
+     */
+    Eigen::MatrixXd loadtxt(const char* data, size_t size, const std::string& name);
+
+    /**
+     * @brief loadbin: Load a binary matrix file. Aligned float64 "TVMM" files are memory mapped and used in place,
+     *        encoded or compressed ones are decoded once into a float64 matrix and legacy files (int32 rows,
+     *        int32 cols, row-major float64) are copied once into a column-major matrix.
+     * @param filename: A string corresponding to the filepath of the file we are reading.
+     * @throws RunTimeError: If the file is truncated or its dimensions are outside the load limits.
+     * @return The loaded matrix.
+     */
+    MappedMatrix loadbin(const std::string& filename);
+
+    /**
+     * @brief loadbin: Parse a binary matrix already held in memory.
+     * @param backing: The object owning the memory. Aligned files are viewed in place and keep it alive.
+     * @param data: A pointer to the start of the binary matrix.
+     * @param size: The number of bytes available at data.
+     * @param name: A name for the matrix used in error messages.
+     * @return The loaded matrix.
+     */
+    MappedMatrix loadbin(std::shared_ptr<const void> backing, const char* data, size_t size, const std::string& name);
+
+    /**
+     * @brief tobin: Serialize a matrix in the aligned "TVMM" binary format.
+     * @param mat: The matrix to serialize.
+     * @param options: The value encoding and compression to use.
+     * @return The header and padded payload bytes.
+     */
+    std::vector<char> tobin(const Eigen::Ref<const Eigen::MatrixXd>& mat, const EncodeOptions& options = {});
+
+    /**
+     * @brief savebin: Write a matrix in the aligned "TVMM" binary format.
+     * @param filename: A string corresponding to the filepath of the file we are writing.
+     * @param mat: The matrix to write.
+     * @param options: The value encoding and compression to use.
+     * @return A boolean representing the function's success.
+     */
+    bool savebin(const std::string& filename, const Eigen::Ref<const Eigen::MatrixXd>& mat,
+                 const EncodeOptions& options = {});
+
+    /**
+     * @brief LoadMatrix: Load a matrix by name from a subsequence folder. Uses <stem>.bin when it
+     *        exists and falls back to <stem>.txt otherwise.
+     * @param directory: The subsequence folder holding the matrix files.
+     * @param stem: The file name without its extension (e.g. "B_matrix").
+     * @return The loaded matrix.
+     */
+    MappedMatrix LoadMatrix(const std::string& directory, const std::string& stem);
+
     /**
      * @brief LoadDeltaTrajectories: The the dekta trajectories .bin file into a matrix for
      *        use with the decoder.
      * @param bin_file_path: A string corresponding to the file path for the file we will load.
-     * @return A convererted matrix based off the file.
+     * @return The loaded matrix, mapped in place when the file uses the aligned format.
      */
-    Eigen::MatrixXd LoadDeltaTrajectories(const std::string& bin_file_path);
+    MappedMatrix LoadDeltaTrajectories(const std::string& bin_file_path);
 }
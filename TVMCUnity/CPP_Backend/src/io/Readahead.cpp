@@ -0,0 +1,89 @@
+#include "Readahead.h"
+#include "TVMLogger.h"
+#include <algorithm>
+
+namespace TVMIO {
+
+namespace {
+
+// Ranges are read in chunks so the worker notices a shutdown quickly and the counters move smoothly
+constexpr uint64_t kChunkBytes = 4ull << 20;
+
+} // anonymous namespace
+
+Readahead::Readahead(uint64_t maxBytesInFlight) : maxBytes(maxBytesInFlight) {
+    worker = std::thread(&Readahead::Run, this);
+}
+
+Readahead::~Readahead() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+        queue.clear();
+    }
+    queueChanged.notify_all();
+    worker.join();
+}
+
+uint64_t Readahead::Enqueue(const std::vector<ByteRange>& ranges) {
+    uint64_t queued = 0;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        for (const ByteRange& range : ranges) {
+            if (!range.source || range.bytes == 0) continue;
+            const bool duplicate = std::any_of(queue.begin(), queue.end(), [&](const ByteRange& other) {
+                return other.source->GetName() == range.source->GetName() && other.offset == range.offset;
+            });
+            if (duplicate) continue;
+            if (static_cast<uint64_t>(bytesInFlight.load()) + range.bytes > maxBytes) {
+                ++rangesDropped;
+                continue;
+            }
+            bytesInFlight += static_cast<int64_t>(range.bytes);
+            queue.push_back(range);
+            queued += range.bytes;
+        }
+    }
+    queueChanged.notify_one();
+    return queued;
+}
+
+ReadaheadStats Readahead::GetStats() const {
+    ReadaheadStats stats;
+    stats.bytesInFlight = bytesInFlight;
+    stats.bytesCompleted = bytesCompleted;
+    stats.rangesDropped = rangesDropped;
+    return stats;
+}
+
+void Readahead::Run() {
+    while (true) {
+        ByteRange range;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueChanged.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) return;
+            range = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        uint64_t done = 0;
+        try {
+            for (; done < range.bytes; done += std::min(kChunkBytes, range.bytes - done)) {
+                {
+                    std::lock_guard<std::mutex> lock(queueMutex);
+                    if (stopping) break;
+                }
+                const uint64_t chunk = std::min(kChunkBytes, range.bytes - done);
+                range.source->Prefetch(range.offset + done, chunk);
+                bytesInFlight -= static_cast<int64_t>(chunk);
+                bytesCompleted += static_cast<int64_t>(chunk);
+            }
+        } catch (const std::exception& e) {
+            LOG_WARN("[Readahead] Failed to read ahead ", range.source->GetName(), ": ", e.what());
+        }
+        bytesInFlight -= static_cast<int64_t>(range.bytes - std::min(done, range.bytes));
+    }
+}
+
+} // namespace TVMIO
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ByteSource.h"
+
+namespace TVMIO {
+
+/**
+ * @brief ReadaheadStats: Counters of a Readahead worker.
+ */
+struct ReadaheadStats {
+    int64_t bytesInFlight = 0;   // Queued or being read
+    int64_t bytesCompleted = 0;  // Read ahead so far
+    int64_t rangesDropped = 0;   // Skipped because the queue was full
+};
+
+/**
+ * @brief Readahead: A background reader that brings byte ranges into memory before they are loaded, so loads
+ *        and decodes do not stall on cold storage. Ranges are read one at a time in queue order and the queue is
+ *        bounded by the number of bytes it holds, ranges that do not fit are dropped (readahead is only a hint).
+ */
+class Readahead {
+public:
+    /**
+     * @brief Readahead: Start the worker thread.
+     * @param maxBytesInFlight: The most bytes that may be queued or being read at once.
+     */
+    explicit Readahead(uint64_t maxBytesInFlight);
+
+    /**
+     * @brief ~Readahead: Drop the queued ranges and stop the worker once its current chunk is read.
+     */
+    ~Readahead();
+
+    Readahead(const Readahead&) = delete;
+    Readahead& operator=(const Readahead&) = delete;
+
+    /**
+     * @brief Enqueue: Queue ranges to be read ahead. Ranges that are already queued are skipped.
+     * @param ranges: The ranges, typically every file of one subsequence.
+     * @return The number of bytes that were queued.
+     */
+    uint64_t Enqueue(const std::vector<ByteRange>& ranges);
+
+    ReadaheadStats GetStats() const;
+
+private:
+    void Run();
+
+    uint64_t maxBytes;
+    mutable std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::deque<ByteRange> queue;
+    bool stopping = false;
+    std::atomic<int64_t> bytesInFlight{0}, bytesCompleted{0}, rangesDropped{0};
+    std::thread worker;
+};
+
+} // namespace TVMIO
@@ -0,0 +1,193 @@
+#include "SequenceContainer.h"
+#include "MatrixIO.h"
+#include "TVMLogger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace TVMIO {
+
+namespace {
+
+constexpr char kContainerMagic[8] = {'T', 'V', 'M', 'C', 'S', 'E', 'Q', '\0'};
+
+uint64_t AlignUp(uint64_t value) {
+    return (value + kContainerAlignment - 1) / kContainerAlignment * kContainerAlignment;
+}
+
+} // anonymous namespace
+
+SequenceContainer::SequenceContainer(const std::string& path) : SequenceContainer(OpenByteSource(path)) {}
+
+SequenceContainer::SequenceContainer(std::shared_ptr<ByteSource> containerSource) : source(std::move(containerSource)) {
+    const std::string& path = source->GetName();
+    const uint64_t size = source->Size();
+
+    // Validate the header
+    ContainerHeader header;
+    if (size < sizeof(header)) {
+        throw std::runtime_error("Corrupt container: missing header in " + path);
+    }
+    std::memcpy(&header, source->Read(0, sizeof(header)).data, sizeof(header));
+    if (std::memcmp(header.magic, kContainerMagic, sizeof(kContainerMagic)) != 0) {
+        throw std::runtime_error("Not a sequence container: " + path);
+    }
+    if (header.version != kContainerVersion) {
+        throw std::runtime_error("Unsupported container version in " + path);
+    }
+
+    // Validate and copy the index table
+    const uint64_t indexBytes = static_cast<uint64_t>(header.subSequenceCount) * sizeof(SubSequenceEntry);
+    if (header.indexBytes != indexBytes || header.indexOffset > size || size - header.indexOffset < indexBytes) {
+        throw std::runtime_error("Corrupt container: invalid index table in " + path);
+    }
+    const ByteView index = source->Read(header.indexOffset, indexBytes);
+    if (Crc32(index.data, indexBytes) != header.indexChecksum) {
+        throw std::runtime_error("Corrupt container: index checksum mismatch in " + path);
+    }
+    frameRate = header.frameRate >= 0.0f ? header.frameRate : 0.0f;
+    entries.resize(header.subSequenceCount);
+    if (indexBytes > 0) {
+        std::memcpy(entries.data(), index.data, indexBytes);
+    }
+
+    // Every section must lie inside the file
+    for (const auto& entry : entries) {
+        for (const auto& section : entry.sections) {
+            if (section.offset > size || size - section.offset < section.bytes) {
+                throw std::runtime_error("Corrupt container: section out of range in " + path);
+            }
+        }
+    }
+    LOG_INFO("[SequenceContainer] ✅ Opened ", path, " with ", entries.size(), " subsequences");
+}
+
+bool SequenceContainer::IsContainer(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(kContainerMagic)] = {};
+    if (!in.read(magic, sizeof(magic))) return false;
+    return std::memcmp(magic, kContainerMagic, sizeof(kContainerMagic)) == 0;
+}
+
+const SubSequenceEntry& SequenceContainer::GetEntry(int index) const {
+    if (index < 0 || index >= static_cast<int>(entries.size())) {
+        throw std::out_of_range("Invalid subsequence index in SequenceContainer");
+    }
+    return entries[index];
+}
+
+ByteRange SequenceContainer::GetSubSequenceRange(int index) const {
+    uint64_t first = UINT64_MAX, last = 0;
+    for (const auto& section : GetEntry(index).sections) {
+        first = std::min(first, section.offset);
+        last = std::max(last, section.offset + section.bytes);
+    }
+    return {source, first, last - first};
+}
+
+std::array<ByteView, static_cast<int>(SectionType::Count)> SequenceContainer::ReadSections(int index, bool verify) const {
+    const SubSequenceEntry& entry = GetEntry(index);
+
+    // The writer stores a subsequence's sections back to back, read them as one span unless they are scattered
+    uint64_t first = UINT64_MAX, last = 0, total = 0;
+    for (const auto& section : entry.sections) {
+        first = std::min(first, section.offset);
+        last = std::max(last, section.offset + section.bytes);
+        total += section.bytes;
+    }
+    const bool contiguous = last - first <= total + kContainerAlignment * static_cast<int>(SectionType::Count);
+    const ByteView span = contiguous ? source->Read(first, last - first) : ByteView{};
+
+    std::array<ByteView, static_cast<int>(SectionType::Count)> sections;
+    for (int type = 0; type < static_cast<int>(SectionType::Count); ++type) {
+        const ContainerSection& section = entry.sections[type];
+        if (contiguous) {
+            sections[type] = span;
+            sections[type].data = span.data + (section.offset - first);
+            sections[type].size = static_cast<size_t>(section.bytes);
+        } else {
+            sections[type] = source->Read(section.offset, section.bytes);
+        }
+        if (verify && Crc32(sections[type].data, section.bytes) != section.checksum) {
+            throw std::runtime_error("Corrupt container: checksum mismatch in subsequence " + std::to_string(index + 1) +
+                                     " section " + std::to_string(type));
+        }
+    }
+    return sections;
+}
+
+bool SequenceContainer::Write(const std::string& path, const std::vector<SubSequenceData>& subSequences,
+                              const MatrixIO::EncodeOptions& encoding, float frameRate) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) return false;
+
+    ContainerHeader header{};
+    std::memcpy(header.magic, kContainerMagic, sizeof(kContainerMagic));
+    header.version = kContainerVersion;
+    header.subSequenceCount = static_cast<uint32_t>(subSequences.size());
+    header.indexOffset = sizeof(ContainerHeader);
+    header.indexBytes = subSequences.size() * sizeof(SubSequenceEntry);
+    header.frameRate = frameRate;
+
+    // Sections are written after the index table, padding each to the alignment
+    std::vector<SubSequenceEntry> entries(subSequences.size());
+    uint64_t offset = AlignUp(header.indexOffset + header.indexBytes);
+    out.seekp(static_cast<std::streamoff>(offset));
+
+    auto writeSection = [&](ContainerSection& section, const char* bytes, uint64_t count) {
+        section.offset = offset;
+        section.bytes = count;
+        section.checksum = Crc32(bytes, count);
+        section.reserved = 0;
+        out.write(bytes, static_cast<std::streamsize>(count));
+        const uint64_t padded = AlignUp(offset + count);
+        const std::vector<char> zeros(padded - offset - count, 0);
+        out.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+        offset = padded;
+    };
+
+    for (size_t i = 0; i < subSequences.size(); ++i) {
+        const SubSequenceData& sub = subSequences[i];
+        SubSequenceEntry& entry = entries[i];
+        entry.vertexCount = static_cast<uint32_t>(sub.referenceMesh.vertices.size());
+        entry.triangleCount = static_cast<uint32_t>(sub.referenceMesh.triangles.size());
+        entry.frameCount = static_cast<uint32_t>(sub.bMatrix.cols() / 3);
+        entry.basisCount = static_cast<uint32_t>(sub.dHat.cols());
+
+        std::vector<double> vertices;
+        vertices.reserve(sub.referenceMesh.vertices.size() * 3);
+        for (const auto& v : sub.referenceMesh.vertices) {
+            vertices.push_back(v.x());
+            vertices.push_back(v.y());
+            vertices.push_back(v.z());
+        }
+        std::vector<int32_t> indices;
+        indices.reserve(sub.referenceMesh.triangles.size() * 3);
+        for (const auto& tri : sub.referenceMesh.triangles) {
+            indices.push_back(tri[0]);
+            indices.push_back(tri[1]);
+            indices.push_back(tri[2]);
+        }
+
+        writeSection(entry.sections[static_cast<int>(SectionType::ReferenceMesh)],
+                     reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(double));
+        writeSection(entry.sections[static_cast<int>(SectionType::TriangleIndices)],
+                     reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(int32_t));
+        const std::vector<char> b = MatrixIO::tobin(sub.bMatrix, encoding);
+        writeSection(entry.sections[static_cast<int>(SectionType::BMatrix)], b.data(), b.size());
+        const std::vector<char> t = MatrixIO::tobin(sub.tMatrix);
+        writeSection(entry.sections[static_cast<int>(SectionType::TMatrix)], t.data(), t.size());
+        const std::vector<char> d = MatrixIO::tobin(sub.dHat, encoding);
+        writeSection(entry.sections[static_cast<int>(SectionType::DeltaTrajectories)], d.data(), d.size());
+    }
+
+    // Now that every section is placed, write the header and index table
+    header.indexChecksum = Crc32(reinterpret_cast<const char*>(entries.data()), header.indexBytes);
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(header.indexBytes));
+    return static_cast<bool>(out);
+}
+
+} // namespace TVMIO
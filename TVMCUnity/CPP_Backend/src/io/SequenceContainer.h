@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "ByteSource.h"
+#include "MappedFile.h"
+#include "MatrixIO.h"
+#include "SimpleMesh.h"
+
+namespace TVMIO {
+
+/**
+ * Packed sequence container (.tvmc)
+ *
+ * A whole encoded sequence in one file so it can be memory mapped at startup with no extraction or text parsing:
+ *
+ *   ContainerHeader                   64 bytes
+ *   SubSequenceEntry[count]           index table, one entry per subsequence
+ *   sections...                       every section starts on a 64 byte boundary
+ *
+ * Each subsequence has five sections: the reference mesh vertices (float64 x,y,z per vertex), the triangle
+ * indices (int32, 3 per triangle, 0-based) and the B, T and dHat matrices stored in the aligned "TVMM" binary
+ * matrix format (see MatrixIO::MatrixFileHeader). Every section carries a CRC32 of its bytes.
+ */
+
+constexpr uint32_t kContainerVersion = 1;
+constexpr uint64_t kContainerAlignment = 64;
+
+enum class SectionType : uint32_t {
+    ReferenceMesh = 0,
+    TriangleIndices = 1,
+    BMatrix = 2,
+    TMatrix = 3,
+    DeltaTrajectories = 4,
+    Count = 5
+};
+
+struct ContainerSection {
+    uint64_t offset;    // Byte offset from the start of the file
+    uint64_t bytes;     // Byte size of the section
+    uint32_t checksum;  // CRC32 of the section bytes
+    uint32_t reserved;
+};
+
+struct SubSequenceEntry {
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+    uint32_t frameCount;
+    uint32_t basisCount;  // K, the number of columns of dHat
+    ContainerSection sections[static_cast<int>(SectionType::Count)];
+};
+
+struct ContainerHeader {
+    char magic[8];            // "TVMCSEQ\0"
+    uint32_t version;         // kContainerVersion
+    uint32_t subSequenceCount;
+    uint64_t indexOffset;     // Byte offset of the SubSequenceEntry table
+    uint64_t indexBytes;      // Byte size of the SubSequenceEntry table
+    uint32_t indexChecksum;   // CRC32 of the SubSequenceEntry table
+    float frameRate;          // Capture frame rate, 0 when unknown
+    uint8_t reserved[24];     // Zero, pads the header to 64 bytes
+};
+static_assert(sizeof(ContainerHeader) == 64, "ContainerHeader must be 64 bytes");
+
+/**
+ * @brief SubSequenceData: The decoded inputs for one subsequence, used when writing a container.
+ */
+struct SubSequenceData {
+    SimpleMesh::Mesh referenceMesh;
+    Eigen::MatrixXd bMatrix, tMatrix, dHat;
+};
+
+class SequenceContainer {
+public:
+    /**
+     * @brief SequenceContainer: Memory map a container, or open a container URL, and validate its header and
+     *        index table.
+     * @param path: The file path or http:// URL of the .tvmc container.
+     * @throws RunTimeError: If the file is not a valid container.
+     */
+    explicit SequenceContainer(const std::string& path);
+
+    /**
+     * @brief SequenceContainer: Validate the header and index table of a container read through a byte source.
+     *        Only the header and index are read here, subsequences are read on demand.
+     * @param source: The source holding the .tvmc bytes.
+     * @throws RunTimeError: If the source is not a valid container.
+     */
+    explicit SequenceContainer(std::shared_ptr<ByteSource> source);
+
+    /**
+     * @brief IsContainer: Check whether a path points to a container file (by its magic bytes).
+     * @param path: The path to check.
+     * @return A boolean representing if the path is a container.
+     */
+    static bool IsContainer(const std::string& path);
+
+    /**
+     * @brief Write: Write a container holding the given subsequences.
+     * @param path: The file path of the .tvmc we are writing.
+     * @param subSequences: The subsequences in playback order.
+     * @param encoding: How B and dHat are stored (T is always float64, it holds the per frame translations).
+     * @param frameRate: The capture frame rate, 0 when unknown.
+     * @return A boolean representing the function's success.
+     */
+    static bool Write(const std::string& path, const std::vector<SubSequenceData>& subSequences,
+                      const MatrixIO::EncodeOptions& encoding = {}, float frameRate = 0.0f);
+
+    /**
+     * @brief GetEntry: Get the index entry for a subsequence.
+     * @param index: The subsequence to fetch (0-indexed).
+     * @throws OutOfRange: If the index is outside of the container.
+     */
+    const SubSequenceEntry& GetEntry(int index) const;
+
+    /**
+     * @brief ReadSections: Read every section of a subsequence. Sections that are stored next to each other are
+     *        fetched with a single read, so a streamed subsequence costs one range request.
+     * @param index: The subsequence (0-indexed).
+     * @param verify: Check each section's CRC32 before returning it.
+     * @throws RunTimeError: If a section can't be read or verification is requested and a checksum does not match.
+     * @return The sections' bytes, indexed by SectionType (mapped containers are viewed in place).
+     */
+    std::array<ByteView, static_cast<int>(SectionType::Count)> ReadSections(int index, bool verify) const;
+
+    /**
+     * @brief GetSubSequenceRange: The byte range covering every section of a subsequence, for readahead.
+     * @param index: The subsequence (0-indexed).
+     * @throws OutOfRange: If the index is outside of the container.
+     */
+    ByteRange GetSubSequenceRange(int index) const;
+
+    // Getter functions
+    int GetSubSequenceCount() const { return static_cast<int>(entries.size()); }
+    float GetFrameRate() const { return frameRate; }
+    const std::string& GetName() const { return source->GetName(); }
+
+private:
+    std::shared_ptr<ByteSource> source;
+    float frameRate = 0.0f;
+    std::vector<SubSequenceEntry> entries;
+};
+
+} // namespace TVMIO
@@ -0,0 +1,116 @@
+#include "SequenceManifest.h"
+#include "MappedFile.h"
+#include "SequenceContainer.h"
+#include "TVMLogger.h"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace TVMIO {
+
+namespace {
+
+constexpr int kManifestVersion = 1;
+
+} // anonymous namespace
+
+SequenceManifest SequenceManifest::Parse(const char* data, size_t size, const std::string& name) {
+    SequenceManifest manifest;
+    std::istringstream in(std::string(data, size));
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+
+        std::istringstream fields(line);
+        std::string key;
+        if (!(fields >> key)) continue;
+
+        bool known = true, valid = true;
+        if (key == "version") {
+            int version = 0;
+            valid = static_cast<bool>(fields >> version);
+            if (valid && version != kManifestVersion) {
+                throw std::runtime_error("Unsupported manifest version in " + name);
+            }
+        } else if (key == "fps") {
+            valid = static_cast<bool>(fields >> manifest.frameRate) && manifest.frameRate >= 0.0f;
+        } else if (key == "subsequence") {
+            SubSequenceInfo info;
+            valid = static_cast<bool>(fields >> info.path >> info.vertexCount >> info.triangleCount >> info.frameCount >>
+                                      info.basisCount >> info.meshBytes >> info.dHatBytes >> info.bBytes >> info.tBytes) &&
+                    info.vertexCount > 0 && info.frameCount > 0;
+            manifest.subSequences.push_back(std::move(info));
+        } else {
+            // Unknown keys are skipped so newer writers stay readable
+            known = false;
+            LOG_WARN("[SequenceManifest] Ignoring unknown key ", key, " in ", name);
+        }
+        std::string extra;
+        if (known && valid && (fields >> extra)) {
+            valid = false;
+        }
+        if (!valid) {
+            throw std::runtime_error("Malformed manifest line " + std::to_string(lineNumber) + " in " + name);
+        }
+    }
+
+    if (manifest.subSequences.empty()) {
+        throw std::runtime_error("Manifest lists no subsequences: " + name);
+    }
+    return manifest;
+}
+
+SequenceManifest SequenceManifest::Load(const std::string& path) {
+    MappedFile file(path);
+    return Parse(file.Data(), file.Size(), path);
+}
+
+SequenceManifest SequenceManifest::FromContainer(const SequenceContainer& container) {
+    SequenceManifest manifest;
+    manifest.frameRate = container.GetFrameRate();
+    for (int i = 0; i < container.GetSubSequenceCount(); ++i) {
+        const SubSequenceEntry& entry = container.GetEntry(i);
+        auto sectionBytes = [&](SectionType type) { return entry.sections[static_cast<int>(type)].bytes; };
+        SubSequenceInfo info;
+        info.vertexCount = entry.vertexCount;
+        info.triangleCount = entry.triangleCount;
+        info.frameCount = entry.frameCount;
+        info.basisCount = entry.basisCount;
+        info.meshBytes = sectionBytes(SectionType::ReferenceMesh) + sectionBytes(SectionType::TriangleIndices);
+        info.dHatBytes = sectionBytes(SectionType::DeltaTrajectories);
+        info.bBytes = sectionBytes(SectionType::BMatrix);
+        info.tBytes = sectionBytes(SectionType::TMatrix);
+        manifest.subSequences.push_back(std::move(info));
+    }
+    return manifest;
+}
+
+const SubSequenceInfo& SequenceManifest::GetSubSequence(int index) const {
+    if (index < 0 || index >= static_cast<int>(subSequences.size())) {
+        throw std::out_of_range("Invalid subsequence index in SequenceManifest");
+    }
+    return subSequences[index];
+}
+
+int64_t SequenceManifest::GetTotalFrames() const {
+    int64_t frames = 0;
+    for (const auto& info : subSequences) frames += info.frameCount;
+    return frames;
+}
+
+uint32_t SequenceManifest::GetMaxVertexCount() const {
+    uint32_t count = 0;
+    for (const auto& info : subSequences) count = std::max(count, info.vertexCount);
+    return count;
+}
+
+uint32_t SequenceManifest::GetMaxFrameCount() const {
+    uint32_t count = 0;
+    for (const auto& info : subSequences) count = std::max(count, info.frameCount);
+    return count;
+}
+
+} // namespace TVMIO
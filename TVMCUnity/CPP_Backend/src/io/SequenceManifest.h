@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace TVMIO {
+
+class SequenceContainer;
+
+/**
+ * @brief SubSequenceInfo: What a manifest records about one subsequence.
+ */
+struct SubSequenceInfo {
+    std::string path;             // Folder of the subsequence, relative to the sequence root
+    uint32_t vertexCount = 0;
+    uint32_t triangleCount = 0;
+    uint32_t frameCount = 0;
+    uint32_t basisCount = 0;      // K, the number of columns of dHat
+    uint64_t meshBytes = 0;       // Stored byte sizes of the reference mesh, dHat, B and T
+    uint64_t dHatBytes = 0;
+    uint64_t bBytes = 0;
+    uint64_t tBytes = 0;
+
+    uint64_t TotalBytes() const { return meshBytes + dHatBytes + bBytes + tBytes; }
+};
+
+/**
+ * @brief SequenceManifest: A description of a whole sequence (subsequence folders, vertex, triangle and frame
+ *        counts, K and byte sizes) that is known before any subsequence is loaded. Folders and zips carry it as
+ *        a "sequence_manifest.txt" written by write_manifest.py, containers build it from their index table.
+ *
+ *        The text format is line based, '#' starts a comment:
+ *            version 1
+ *            fps 30
+ *            subsequence <path> <vertices> <triangles> <frames> <K> <mesh bytes> <dHat bytes> <B bytes> <T bytes>
+ */
+class SequenceManifest {
+public:
+    static constexpr const char* kFileName = "sequence_manifest.txt";
+
+    /**
+     * @brief Parse: Parse manifest text already held in memory.
+     * @param data: A pointer to the first character of the text.
+     * @param size: The number of characters in the text.
+     * @param name: A name for the manifest used in error messages.
+     * @throws RunTimeError: If the manifest is malformed.
+     * @return The parsed manifest.
+     */
+    static SequenceManifest Parse(const char* data, size_t size, const std::string& name);
+
+    /**
+     * @brief Load: Read and parse a manifest file.
+     * @param path: The file path of the manifest.
+     * @throws RunTimeError: If the file can't be read or is malformed.
+     * @return The parsed manifest.
+     */
+    static SequenceManifest Load(const std::string& path);
+
+    /**
+     * @brief FromContainer: Build a manifest from a container's index table.
+     * @param container: The opened container.
+     * @return The manifest, subsequence paths are left empty.
+     */
+    static SequenceManifest FromContainer(const SequenceContainer& container);
+
+    /**
+     * @brief GetSubSequence: Get the info for a subsequence.
+     * @param index: The subsequence to fetch (0-indexed).
+     * @throws OutOfRange: If the index is outside of the manifest.
+     */
+    const SubSequenceInfo& GetSubSequence(int index) const;
+
+    // Getter functions
+    int GetSubSequenceCount() const { return static_cast<int>(subSequences.size()); }
+    float GetFrameRate() const { return frameRate; }  // 0 when unknown
+    int64_t GetTotalFrames() const;
+    uint32_t GetMaxVertexCount() const;
+    uint32_t GetMaxFrameCount() const;
+
+private:
+    float frameRate = 0.0f;
+    std::vector<SubSequenceInfo> subSequences;
+};
+
+} // namespace TVMIO
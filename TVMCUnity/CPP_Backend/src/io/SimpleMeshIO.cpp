@@ -1,62 +1,135 @@
 #include "SimpleMeshIO.h"
+#include "MappedFile.h"
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
 
 namespace SimpleMeshIO {
 
+namespace {
+
+bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char* SkipBlanks(const char* p, const char* end) {
+    while (p < end && IsBlank(*p)) ++p;
+    return p;
+}
+
+const char* TokenEnd(const char* p, const char* end) {
+    while (p < end && !IsBlank(*p)) ++p;
+    return p;
+}
+
+// Parse a float the way an istream would (strtof rounding), false if the token isn't a number
+bool ParseFloat(const char* first, const char* last, float& value) {
+    if (first < last && *first == '+') ++first;
+#if defined(__cpp_lib_to_chars)
+    return std::from_chars(first, last, value).ec == std::errc();
+#else
+    char buffer[64];
+    const size_t length = static_cast<size_t>(last - first);
+    if (length == 0 || length >= sizeof(buffer)) return false;
+    std::memcpy(buffer, first, length);
+    buffer[length] = '\0';
+    char* end = nullptr;
+    value = std::strtof(buffer, &end);
+    return end != buffer;
+#endif
+}
+
+// Parse the vertex index of a face token, ignoring texture/normal data if present ("12/4/7")
+bool ParseIndex(const char* first, const char* last, int& value) {
+    if (first < last && *first == '+') ++first;
+    return std::from_chars(first, last, value).ec == std::errc();
+}
+
+// Call onLine for every line of a text buffer with the [begin, end) of the line
+template <typename Fn>
+void ForEachLine(const char* data, size_t size, Fn onLine) {
+    const char* end = data + size;
+    for (const char* line = data; line < end;) {
+        const void* nl = std::memchr(line, '\n', end - line);
+        const char* lineEnd = nl ? static_cast<const char*>(nl) : end;
+        onLine(line, lineEnd);
+        if (lineEnd == end) break;
+        line = lineEnd + 1;
+    }
+}
+
+// Parse the three vertex indices of an "f " line, false if the line is malformed
+bool ParseFace(const char* p, const char* end, int indices[3]) {
+    p = SkipBlanks(p + 2, end);
+    for (int i = 0; i < 3; ++i) {
+        const char* tokenEnd = TokenEnd(p, end);
+        if (p == tokenEnd || !ParseIndex(p, tokenEnd, indices[i])) return false;
+        p = SkipBlanks(tokenEnd, end);
+    }
+    return true;
+}
+
+} // anonymous namespace
+
 
 bool ReadOBJ(const std::string& filename, SimpleMesh::Mesh& mesh) {
-    std::ifstream in(filename);
-    if (!in.is_open()) return false;
+    try {
+        TVMIO::MappedFile file(filename);
+        return ReadOBJ(file.Data(), file.Size(), mesh);
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
 
-    std::string line;
-    while (std::getline(in, line)) {
-        std::istringstream iss(line);
-        if (line.substr(0, 2) == "v ") {
+bool ReadOBJ(const char* data, size_t size, SimpleMesh::Mesh& mesh) {
+    ForEachLine(data, size, [&](const char* line, const char* end) {
+        if (end - line < 2 || line[1] != ' ') return;
+        if (line[0] == 'v') {
             // Parse vertex line: v x y z
-            char v; float x, y, z;
-            iss >> v >> x >> y >> z;
-            mesh.vertices.emplace_back(x, y, z);
-        } else if (line.substr(0, 2) == "f ") {
+            float xyz[3] = {0.0f, 0.0f, 0.0f};
+            const char* p = SkipBlanks(line + 2, end);
+            for (int i = 0; i < 3; ++i) {
+                const char* tokenEnd = TokenEnd(p, end);
+                if (!ParseFloat(p, tokenEnd, xyz[i])) break;
+                p = SkipBlanks(tokenEnd, end);
+            }
+            mesh.vertices.emplace_back(xyz[0], xyz[1], xyz[2]);
+        } else if (line[0] == 'f') {
             // Parse face line: f i j k
-            char f; int v1, v2, v3;
-            iss >> f >> v1 >> v2 >> v3;
-            mesh.triangles.push_back({v1 - 1, v2 - 1, v3 - 1});  // OBJ is 1-based
+            int v[3];
+            if (ParseFace(line, end, v)) {
+                mesh.triangles.push_back({v[0] - 1, v[1] - 1, v[2] - 1});  // OBJ is 1-based
+            }
         }
-    }
-
-    in.close();
+    });
     return true;
 }
 
 
 std::vector<int> LoadTriangleIndicesFlat(const std::string& path) {
-    std::vector<int> triangleIndices;
-    std::ifstream in(path);
-    if (!in.is_open()) return triangleIndices;
-
-    std::string line;
-    while (std::getline(in, line)) {
-        if (line.rfind("f ", 0) == 0) {
-            std::istringstream iss(line);
-            std::string prefix;
-            iss >> prefix;
-
-            std::string v1, v2, v3;
-            if (!(iss >> v1 >> v2 >> v3)) continue;
-
-            // Parse each vertex index, ignoring texture/normal data if present
-            auto parseIndex = [](const std::string& token) {
-                size_t slash = token.find('/');
-                return std::stoi(token.substr(0, slash)) - 1;
-            };
-
-            triangleIndices.push_back(parseIndex(v1));
-            triangleIndices.push_back(parseIndex(v2));
-            triangleIndices.push_back(parseIndex(v3));
-        }
+    try {
+        TVMIO::MappedFile file(path);
+        return LoadTriangleIndicesFlat(file.Data(), file.Size());
+    } catch (const std::exception&) {
+        return std::vector<int>();
     }
+}
+
 
+std::vector<int> LoadTriangleIndicesFlat(const char* data, size_t size) {
+    std::vector<int> triangleIndices;
+    ForEachLine(data, size, [&](const char* line, const char* end) {
+        if (end - line < 2 || line[0] != 'f' || line[1] != ' ') return;
+        int v[3];
+        if (!ParseFace(line, end, v)) return;
+        triangleIndices.push_back(v[0] - 1);
+        triangleIndices.push_back(v[1] - 1);
+        triangleIndices.push_back(v[2] - 1);
+    });
     return triangleIndices;
 }
 
@@ -2,6 +2,7 @@
 
 #include "SimpleMesh.h"
 #include <string>
+#include <vector>
 
 namespace SimpleMeshIO {
     /**
@@ -12,6 +13,15 @@ namespace SimpleMeshIO {
      */
     bool ReadOBJ(const std::string& filename, SimpleMesh::Mesh& mesh);
 
+    /**
+     * @brief ReadOBJ: Parse .obj text already held in memory into a Mesh object.
+     * @param data: A pointer to the first character of the .obj text.
+     * @param size: The number of characters in the text.
+     * @param mesh: The simple mesh object to store the read .obj
+     * @return A boolean representing the function's success.
+     */
+    bool ReadOBJ(const char* data, size_t size, SimpleMesh::Mesh& mesh);
+
     /**
      * @brief WriteOBJ: Write a new .obj file from a simple mesh object.
      * @param filename: A string representing the file path where we are storing the .obj
@@ -26,4 +36,12 @@ namespace SimpleMeshIO {
      * @return A vector of integers representing the triangle sets for the .obj mesh.
      */
     std::vector<int> LoadTriangleIndicesFlat(const std::string& path);
+
+    /**
+     * @brief LoadTriangleIndicesFlat: Get a flat vector of triangle sets from .obj text already held in memory.
+     * @param data: A pointer to the first character of the .obj text.
+     * @param size: The number of characters in the text.
+     * @return A vector of integers representing the triangle sets for the .obj mesh.
+     */
+    std::vector<int> LoadTriangleIndicesFlat(const char* data, size_t size);
 }
@@ -0,0 +1,263 @@
+#include "ZipArchive.h"
+#include "TVMLogger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+
+namespace TVMIO {
+
+namespace {
+
+constexpr uint32_t kLocalHeaderSignature = 0x04034b50;
+constexpr uint32_t kCentralHeaderSignature = 0x02014b50;
+constexpr uint32_t kEndOfCentralDirSignature = 0x06054b50;
+constexpr uint32_t kZip64LocatorSignature = 0x07064b50;
+constexpr uint32_t kZip64EndOfCentralDirSignature = 0x06064b50;
+constexpr uint16_t kZip64ExtraField = 0x0001;
+constexpr uint16_t kMethodStored = 0;
+constexpr uint16_t kMethodDeflated = 8;
+
+// Zip fields are little endian and unaligned
+uint16_t Read16(const char* p) {
+    const auto* b = reinterpret_cast<const uint8_t*>(p);
+    return static_cast<uint16_t>(b[0] | (b[1] << 8));
+}
+
+uint32_t Read32(const char* p) {
+    return static_cast<uint32_t>(Read16(p)) | (static_cast<uint32_t>(Read16(p + 2)) << 16);
+}
+
+uint64_t Read64(const char* p) {
+    return static_cast<uint64_t>(Read32(p)) | (static_cast<uint64_t>(Read32(p + 4)) << 32);
+}
+
+// "a/b/subsequence_001/B_matrix.txt" -> "subsequence_001/B_matrix.txt"
+std::string EntryKey(const std::string& name) {
+    const size_t last = name.find_last_of('/');
+    if (last == std::string::npos || last == 0) return "";
+    const size_t parent = name.find_last_of('/', last - 1);
+    return parent == std::string::npos ? name : name.substr(parent + 1);
+}
+
+} // anonymous namespace
+
+ZipArchive::ZipArchive(const std::string& path) : ZipArchive(OpenByteSource(path)) {}
+
+ZipArchive::ZipArchive(std::shared_ptr<ByteSource> zipSource) : source(std::move(zipSource)) {
+    const std::string& path = source->GetName();
+    const uint64_t size = source->Size();
+
+    // Find the end of central directory record, it is followed by at most a 64KB comment.
+    // The tail read also covers the zip64 locator that sits right before the record.
+    const uint64_t eocdSize = 22;
+    if (size < eocdSize) {
+        throw std::runtime_error("Not a zip archive: " + path);
+    }
+    const uint64_t tailOffset = size > eocdSize + 0xFFFF + 20 ? size - eocdSize - 0xFFFF - 20 : 0;
+    const ByteView tail = source->Read(tailOffset, size - tailOffset);
+    int64_t eocd = -1;
+    for (uint64_t pos = tail.size - eocdSize + 1; pos-- > 0;) {
+        if (Read32(tail.data + pos) == kEndOfCentralDirSignature) {
+            eocd = static_cast<int64_t>(pos);
+            break;
+        }
+    }
+    if (eocd < 0) {
+        throw std::runtime_error("Zip end of central directory not found in " + path);
+    }
+
+    uint64_t entryCount = Read16(tail.data + eocd + 10);
+    uint64_t directorySize = Read32(tail.data + eocd + 12);
+    uint64_t directoryOffset = Read32(tail.data + eocd + 16);
+
+    // Zip64 archives keep the real values in a separate record pointed to by a locator
+    if (eocd >= 20 && Read32(tail.data + eocd - 20) == kZip64LocatorSignature) {
+        const uint64_t zip64Offset = Read64(tail.data + eocd - 20 + 8);
+        if (zip64Offset > size || size - zip64Offset < 56) {
+            throw std::runtime_error("Corrupt zip64 end of central directory in " + path);
+        }
+        const ByteView zip64 = source->Read(zip64Offset, 56);
+        if (Read32(zip64.data) != kZip64EndOfCentralDirSignature) {
+            throw std::runtime_error("Corrupt zip64 end of central directory in " + path);
+        }
+        entryCount = Read64(zip64.data + 32);
+        directorySize = Read64(zip64.data + 40);
+        directoryOffset = Read64(zip64.data + 48);
+    }
+    if (directoryOffset > size || size - directoryOffset < directorySize) {
+        throw std::runtime_error("Corrupt zip central directory in " + path);
+    }
+    const ByteView directory = source->Read(directoryOffset, directorySize);
+
+    // Walk the central directory
+    std::set<std::string> folders;
+    std::unordered_map<std::string, size_t> looseNames;  // Loose file name -> folder depth
+    const char* p = directory.data;
+    const char* end = p + directory.size;
+    for (uint64_t i = 0; i < entryCount; ++i) {
+        if (end - p < 46 || Read32(p) != kCentralHeaderSignature) {
+            throw std::runtime_error("Corrupt zip central directory entry in " + path);
+        }
+        Entry entry;
+        const uint16_t flags = Read16(p + 8);
+        entry.method = Read16(p + 10);
+        entry.crc = Read32(p + 16);
+        entry.compressedSize = Read32(p + 20);
+        entry.uncompressedSize = Read32(p + 24);
+        const uint16_t nameLength = Read16(p + 28);
+        const uint16_t extraLength = Read16(p + 30);
+        const uint16_t commentLength = Read16(p + 32);
+        entry.localHeaderOffset = Read32(p + 42);
+        if (end - p < 46 + nameLength + extraLength + commentLength) {
+            throw std::runtime_error("Corrupt zip central directory entry in " + path);
+        }
+        const std::string name(p + 46, nameLength);
+        entry.headerGuess = 30u + nameLength + extraLength;
+
+        // Zip64 extra field holds the values whose 32 bit fields are saturated, in this order
+        const char* extra = p + 46 + nameLength;
+        const char* extraEnd = extra + extraLength;
+        while (extraEnd - extra >= 4) {
+            const uint16_t id = Read16(extra);
+            const uint16_t length = Read16(extra + 2);
+            const char* field = extra + 4;
+            if (id == kZip64ExtraField) {
+                const char* fieldEnd = field + length;
+                if (entry.uncompressedSize == 0xFFFFFFFF && fieldEnd - field >= 8) { entry.uncompressedSize = Read64(field); field += 8; }
+                if (entry.compressedSize == 0xFFFFFFFF && fieldEnd - field >= 8) { entry.compressedSize = Read64(field); field += 8; }
+                if (entry.localHeaderOffset == 0xFFFFFFFF && fieldEnd - field >= 8) { entry.localHeaderOffset = Read64(field); }
+            }
+            extra += 4 + length;
+        }
+        p += 46 + nameLength + extraLength + commentLength;
+
+        // Skip folders, macOS resource forks and encrypted entries
+        if (name.empty() || name.back() == '/' || name.rfind("__MACOSX", 0) == 0) continue;
+        if (flags & 0x1) {
+            LOG_WARN("[ZipArchive] Skipping encrypted entry ", name);
+            continue;
+        }
+        const std::string key = EntryKey(name);
+        if (key.rfind("subsequence_", 0) != 0) {
+            // Keep the shallowest copy of loose files such as the manifest
+            const std::string fileName = name.substr(name.find_last_of('/') + 1);
+            auto loose = looseNames.find(fileName);
+            const size_t depth = std::count(name.begin(), name.end(), '/');
+            if (loose == looseNames.end() || depth < loose->second) {
+                looseNames[fileName] = depth;
+                looseEntries[fileName] = entry;
+            }
+            continue;
+        }
+        folders.insert(key.substr(0, key.find('/')));
+        entries[key] = entry;
+    }
+    subSequenceCount = static_cast<int>(folders.size());
+    LOG_INFO("[ZipArchive] ✅ Opened ", path, " with ", subSequenceCount, " subsequences");
+}
+
+bool ZipArchive::IsZip(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4] = {};
+    if (!in.read(magic, sizeof(magic))) return false;
+    return Read32(magic) == kLocalHeaderSignature;
+}
+
+const ZipArchive::Entry* ZipArchive::Find(const std::string& folder, const std::string& name) const {
+    auto it = entries.find(folder + "/" + name);
+    return it == entries.end() ? nullptr : &it->second;
+}
+
+bool ZipArchive::Contains(const std::string& folder, const std::string& name) const {
+    return Find(folder, name) != nullptr;
+}
+
+uint64_t ZipArchive::GetEntryBytes(const std::string& folder, const std::string& name) const {
+    const Entry* entry = Find(folder, name);
+    return entry ? entry->compressedSize : 0;
+}
+
+std::vector<ByteRange> ZipArchive::GetFileRanges(const std::string& folder) const {
+    std::vector<ByteRange> ranges;
+    const std::string prefix = folder + "/";
+    for (const auto& [key, entry] : entries) {
+        if (key.compare(0, prefix.size(), prefix) == 0) {
+            ranges.push_back({source, entry.localHeaderOffset, entry.headerGuess + entry.compressedSize});
+        }
+    }
+    return ranges;
+}
+
+bool ZipArchive::Contains(const std::string& name) const {
+    return looseEntries.count(name) != 0;
+}
+
+ByteView ZipArchive::Read(const std::string& name) const {
+    auto it = looseEntries.find(name);
+    if (it == looseEntries.end()) {
+        throw std::runtime_error("Zip entry not found: " + name);
+    }
+    return ReadEntry(it->second, name);
+}
+
+ByteView ZipArchive::Read(const std::string& folder, const std::string& name) const {
+    const Entry* entry = Find(folder, name);
+    const std::string entryName = folder + "/" + name;
+    if (!entry) {
+        throw std::runtime_error("Zip entry not found: " + entryName);
+    }
+    return ReadEntry(*entry, entryName);
+}
+
+ByteView ZipArchive::ReadEntry(const Entry& entry, const std::string& entryName) const {
+    // The local header repeats the name and may carry a different extra field length. Read it together with the
+    // payload assuming it matches the central directory, and only go back for the payload when it does not.
+    const uint64_t size = source->Size();
+    if (entry.localHeaderOffset > size || size - entry.localHeaderOffset < 30) {
+        throw std::runtime_error("Corrupt zip local header for " + entryName);
+    }
+    const uint64_t guess = std::min(size - entry.localHeaderOffset, entry.headerGuess + entry.compressedSize);
+    ByteView block = source->Read(entry.localHeaderOffset, guess);
+    if (Read32(block.data) != kLocalHeaderSignature) {
+        throw std::runtime_error("Corrupt zip local header for " + entryName);
+    }
+    const uint64_t headerBytes = 30u + Read16(block.data + 26) + Read16(block.data + 28);
+    const uint64_t payloadOffset = entry.localHeaderOffset + headerBytes;
+    if (payloadOffset > size || size - payloadOffset < entry.compressedSize) {
+        throw std::runtime_error("Truncated zip entry " + entryName);
+    }
+    if (headerBytes + entry.compressedSize > block.size) {
+        block = source->Read(payloadOffset, entry.compressedSize);
+    } else {
+        block.data += headerBytes;
+    }
+    const char* payload = block.data;
+
+    ByteView view;
+    if (entry.method == kMethodStored) {
+        // Stored entries are viewed straight out of what the source read (the mapping for local files)
+        view.backing = block.backing;
+        view.data = payload;
+        view.size = static_cast<size_t>(entry.uncompressedSize);
+    } else if (entry.method == kMethodDeflated) {
+        auto buffer = std::make_shared<std::vector<char>>(static_cast<size_t>(entry.uncompressedSize));
+        if (!Inflate(payload, entry.compressedSize, buffer->data(), buffer->size(), true)) {
+            throw std::runtime_error("Failed to inflate zip entry " + entryName);
+        }
+        view.data = buffer->data();
+        view.size = buffer->size();
+        view.backing = std::move(buffer);
+    } else {
+        throw std::runtime_error("Unsupported zip compression method " + std::to_string(entry.method) +
+                                 " for " + entryName);
+    }
+
+    if (Crc32(view.data, view.size) != entry.crc) {
+        throw std::runtime_error("Zip CRC mismatch for " + entryName);
+    }
+    return view;
+}
+
+} // namespace TVMIO
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ByteSource.h"
+#include "MappedFile.h"
+
+namespace TVMIO {
+
+/**
+ * @brief ZipArchive: Read-only access to the entries of a .zip without extracting it. Only the central directory
+ *        is read on open. Entries are read through a ByteSource and inflated on demand into memory (stored entries
+ *        of a mapped file are viewed in place), so loading one subsequence only touches that subsequence's bytes,
+ *        also when the zip is streamed over HTTP. Supports stored and deflated entries and zip64 archives.
+ */
+class ZipArchive : public SequenceSource {
+public:
+    /**
+     * @brief ZipArchive: Map a local zip file, or open a zip URL, and parse its central directory.
+     * @param path: The file path or http:// URL of the .zip.
+     * @throws RunTimeError: If the file is not a readable zip.
+     */
+    explicit ZipArchive(const std::string& path);
+
+    /**
+     * @brief ZipArchive: Parse the central directory of a zip read through a byte source.
+     * @param source: The source holding the .zip bytes.
+     * @throws RunTimeError: If the source is not a readable zip.
+     */
+    explicit ZipArchive(std::shared_ptr<ByteSource> source);
+
+    /**
+     * @brief IsZip: Check whether a path points to a zip file (by its magic bytes).
+     * @param path: The path to check.
+     * @return A boolean representing if the path is a zip.
+     */
+    static bool IsZip(const std::string& path);
+
+    /**
+     * @brief Contains: Check if the archive holds a subsequence file.
+     * @param folder: The subsequence folder name (e.g. "subsequence_001").
+     * @param file: The file name inside the folder.
+     */
+    bool Contains(const std::string& folder, const std::string& file) const override;
+
+    /**
+     * @brief Read: Read a subsequence file out of the archive. Entries are matched on their last two path
+     *        components, so it does not matter which parent folder the sequence was zipped under.
+     * @param folder: The subsequence folder name (e.g. "subsequence_001").
+     * @param file: The file name inside the folder.
+     * @throws RunTimeError: If the entry is missing, uses an unsupported method or fails its CRC check.
+     * @return The entry's bytes.
+     */
+    ByteView Read(const std::string& folder, const std::string& file) const override;
+
+    /**
+     * @brief Contains: Check if the archive holds a file outside of the subsequence folders (e.g. the manifest).
+     * @param file: The file name, matched regardless of the folder it was zipped under.
+     */
+    bool Contains(const std::string& file) const override;
+
+    /**
+     * @brief Read: Read a file that lives outside of the subsequence folders (e.g. the manifest).
+     * @param file: The file name, matched regardless of the folder it was zipped under.
+     * @throws RunTimeError: If the entry is missing, uses an unsupported method or fails its CRC check.
+     * @return The entry's bytes.
+     */
+    ByteView Read(const std::string& file) const override;
+
+    /**
+     * @brief GetSubSequenceCount: The number of distinct subsequence_XXX folders in the archive.
+     */
+    int GetSubSequenceCount() const override { return subSequenceCount; }
+
+    /**
+     * @brief GetEntryBytes: The compressed size of a subsequence file, or 0 if it is missing.
+     */
+    uint64_t GetEntryBytes(const std::string& folder, const std::string& file) const;
+
+    /**
+     * @brief GetFileRanges: The stored bytes (local header and payload) of every entry in a subsequence folder.
+     */
+    std::vector<ByteRange> GetFileRanges(const std::string& folder) const override;
+
+private:
+    struct Entry {
+        uint16_t method = 0;
+        uint32_t crc = 0;
+        uint64_t compressedSize = 0;
+        uint64_t uncompressedSize = 0;
+        uint64_t localHeaderOffset = 0;
+        uint32_t headerGuess = 0;  // Local header size assuming it repeats the central name and extra field
+    };
+
+    const Entry* Find(const std::string& folder, const std::string& file) const;
+    ByteView ReadEntry(const Entry& entry, const std::string& entryName) const;
+
+    std::shared_ptr<ByteSource> source;
+    std::unordered_map<std::string, Entry> entries;       // Keyed by "subsequence_XXX/file"
+    std::unordered_map<std::string, Entry> looseEntries;  // Files outside the subsequence folders, keyed by name
+    int subSequenceCount = 0;
+};
+
+} // namespace TVMIO
@@ -1,5 +1,6 @@
 // TVMLogger.cpp
 #include "TVMLogger.h"
+#include <atomic>
 #include <iostream>
 #include <mutex>
 #ifdef __ANDROID__
@@ -23,8 +24,9 @@ std::function<void(LogLevel, const std::string&)>& GetCurrentLogger() {
     return f;
 }
 
-bool& GetLoggingEnabled() {
-    static bool enabled = true;
+// Atomic so the check every log call starts with doesn't take the mutex (the render thread logs per frame)
+std::atomic<bool>& GetLoggingEnabled() {
+    static std::atomic<bool> enabled{true};
     return enabled;
 }
 } // anonymous namespace
@@ -42,30 +44,26 @@ void SetLogger(std::function<void(LogLevel, const std::string&)> callback) {
 }
 
 void EnableLogging(bool enabled) {
-    std::lock_guard<std::mutex> lock(GetLoggerMutex());
     GetLoggingEnabled() = enabled;
 }
 
 bool IsLoggingEnabled() {
-    std::lock_guard<std::mutex> lock(GetLoggerMutex());
     return GetLoggingEnabled();
 }
 
 void Log(LogLevel level, const std::string& msg) {
+    // Suppress non-error logs if disabled
+    if (!GetLoggingEnabled() && level != LogLevel::Error)
+        return;
+
     std::function<void(LogLevel, const std::string&)> loggerCopy;
-    bool loggingEnabled = false;
     UnityLogCallback unityCopy = nullptr;
     {
         std::lock_guard<std::mutex> lock(GetLoggerMutex());
         loggerCopy = GetCurrentLogger();
-        loggingEnabled = GetLoggingEnabled();
         unityCopy = unityCallback;
     }
 
-    // Suppress non-error logs if disabled
-    if (!loggingEnabled && level != LogLevel::Error)
-        return;
-
     // Avoid logging during stack unwinding (optional, C++17+)
 #if __cplusplus >= 201703L
     if (std::uncaught_exceptions() > 0) return;
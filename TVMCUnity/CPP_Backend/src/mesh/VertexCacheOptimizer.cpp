@@ -0,0 +1,174 @@
+#include "VertexCacheOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace SimpleMesh {
+
+namespace {
+
+// Forsyth's scoring: an LRU cache of 32 vertices, the last triangle's vertices score a little lower than the next
+// few (a strip would use them anyway), and vertices with few triangles left are boosted so none are stranded
+constexpr int kCacheSize = 32;
+constexpr float kLastTriangleScore = 0.75f;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+constexpr int kMaxScoredValence = 32;
+
+struct ScoreTable {
+    float cache[kCacheSize];
+    float valence[kMaxScoredValence + 1];
+
+    ScoreTable() {
+        for (int position = 0; position < kCacheSize; ++position) {
+            cache[position] = position < 3 ? kLastTriangleScore :
+                std::pow(1.0f - (position - 3) / static_cast<float>(kCacheSize - 3), kCacheDecayPower);
+        }
+        valence[0] = 0.0f;
+        for (int remaining = 1; remaining <= kMaxScoredValence; ++remaining) {
+            valence[remaining] = kValenceBoostScale * std::pow(static_cast<float>(remaining), -kValenceBoostPower);
+        }
+    }
+
+    float Score(int cachePosition, int remaining) const {
+        if (remaining == 0) return -1.0f;  // Nothing left to draw with it
+        const float boost = valence[std::min(remaining, kMaxScoredValence)];
+        return cachePosition >= 0 ? cache[cachePosition] + boost : boost;
+    }
+};
+
+} // namespace
+
+double ComputeAcmr(const std::vector<int>& indices, int cacheSize) {
+    if (indices.size() < 3 || cacheSize <= 0) return 0.0;
+    const int vertexCount = *std::max_element(indices.begin(), indices.end()) + 1;
+    // A vertex is in the FIFO while fewer than cacheSize misses happened since it was added
+    std::vector<uint32_t> addedAt(std::max(vertexCount, 0), 0);
+    uint32_t misses = 0;
+    for (int index : indices) {
+        if (index < 0) continue;
+        if (addedAt[index] == 0 || misses - addedAt[index] >= static_cast<uint32_t>(cacheSize)) {
+            addedAt[index] = ++misses;
+        }
+    }
+    return static_cast<double>(misses) / static_cast<double>(indices.size() / 3);
+}
+
+bool OptimizeVertexCache(const std::vector<int>& indices, int vertexCount, IndexOrder& result) {
+    if (indices.size() % 3 != 0 || vertexCount <= 0) return false;
+    for (int index : indices) {
+        if (index < 0 || index >= vertexCount) return false;
+    }
+    const int triangleCount = static_cast<int>(indices.size() / 3);
+    static const ScoreTable scores;
+
+    // The triangles not drawn yet of every vertex, the first remaining[v] entries from offsets[v]
+    std::vector<int> offsets(vertexCount + 1, 0);
+    for (int index : indices) ++offsets[index + 1];
+    for (int v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+    std::vector<int> remaining(vertexCount);
+    for (int v = 0; v < vertexCount; ++v) remaining[v] = offsets[v + 1] - offsets[v];
+    std::vector<int> adjacency(indices.size());
+    {
+        std::vector<int> next(offsets.begin(), offsets.end() - 1);
+        for (int t = 0; t < triangleCount; ++t) {
+            for (int k = 0; k < 3; ++k) adjacency[next[indices[t * 3 + k]]++] = t;
+        }
+    }
+
+    std::vector<float> vertexScore(vertexCount);
+    for (int v = 0; v < vertexCount; ++v) vertexScore[v] = scores.Score(-1, remaining[v]);
+    std::vector<float> triangleScore(triangleCount);
+    int best = 0;
+    for (int t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+        if (triangleScore[t] > triangleScore[best]) best = t;
+    }
+
+    // Rescore a vertex at its cache position (-1 when not cached) and the triangles it has left
+    auto rescore = [&](int v, int position) {
+        const float score = scores.Score(position, remaining[v]);
+        const float delta = score - vertexScore[v];
+        vertexScore[v] = score;
+        for (int i = offsets[v]; i < offsets[v] + remaining[v]; ++i) triangleScore[adjacency[i]] += delta;
+    };
+
+    std::vector<char> drawn(triangleCount, 0);
+    std::vector<int> triangleOrder;
+    triangleOrder.reserve(triangleCount);
+    std::vector<int> cache, nextCache;
+    cache.reserve(kCacheSize + 3);
+    nextCache.reserve(kCacheSize + 3);
+    int cursor = 0;
+    while (static_cast<int>(triangleOrder.size()) < triangleCount) {
+        if (best < 0) {
+            // Nothing in the cache has triangles left, go on with the first one not drawn yet
+            while (drawn[cursor]) ++cursor;
+            best = cursor;
+        }
+        drawn[best] = 1;
+        triangleOrder.push_back(best);
+        const int* triangle = &indices[best * 3];
+        for (int k = 0; k < 3; ++k) {
+            const int v = triangle[k];
+            int* first = &adjacency[offsets[v]];
+            int* last = first + remaining[v];
+            *std::find(first, last, best) = *(last - 1);
+            --remaining[v];
+        }
+
+        // The triangle's vertices move to the front, the rest keep their order and the last ones fall out
+        nextCache.clear();
+        for (int k = 0; k < 3; ++k) {
+            if (std::find(nextCache.begin(), nextCache.end(), triangle[k]) == nextCache.end()) {
+                nextCache.push_back(triangle[k]);
+            }
+        }
+        for (int v : cache) {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) nextCache.push_back(v);
+        }
+        for (size_t i = kCacheSize; i < nextCache.size(); ++i) rescore(nextCache[i], -1);
+        nextCache.resize(std::min<size_t>(nextCache.size(), kCacheSize));
+        cache.swap(nextCache);
+
+        for (size_t i = 0; i < cache.size(); ++i) rescore(cache[i], static_cast<int>(i));
+        best = -1;
+        float bestScore = -1.0f;
+        for (int v : cache) {
+            for (int i = offsets[v]; i < offsets[v] + remaining[v]; ++i) {
+                const int t = adjacency[i];
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+    }
+
+    // Number the vertices in the order they are first drawn
+    std::vector<int> newIndex(vertexCount, -1);
+    std::vector<int> vertexOrder;
+    vertexOrder.reserve(vertexCount);
+    std::vector<int> reordered(indices.size());
+    for (int n = 0; n < triangleCount; ++n) {
+        for (int k = 0; k < 3; ++k) {
+            const int v = indices[triangleOrder[n] * 3 + k];
+            if (newIndex[v] < 0) {
+                newIndex[v] = static_cast<int>(vertexOrder.size());
+                vertexOrder.push_back(v);
+            }
+            reordered[n * 3 + k] = newIndex[v];
+        }
+    }
+    for (int v = 0; v < vertexCount; ++v) {
+        if (newIndex[v] < 0) vertexOrder.push_back(v);
+    }
+
+    result.indices = std::move(reordered);
+    result.vertexOrder = std::move(vertexOrder);
+    result.triangleOrder = std::move(triangleOrder);
+    return true;
+}
+
+}  // namespace SimpleMesh
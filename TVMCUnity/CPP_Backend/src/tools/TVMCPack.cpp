@@ -0,0 +1,228 @@
+// TVMCPack.cpp
+//
+// Offline transcoder: packs a TVMC output directory (subsequence_XXX folders) into a single .tvmc container.
+//
+// Usage: tvmc_pack [--encoding f64|f32|f16|q16] [--deflate] [--fps <rate>] <sequence_directory> <output.tvmc>
+//
+// --encoding stores B and dHat as float32, half floats or per column int16 quantized values instead of float64,
+// --deflate additionally compresses them. Both trade a little precision/decode time for a smaller file.
+// --fps records the capture frame rate, it defaults to the one in the folder's sequence_manifest.txt if present.
+//
+// Per subsequence folder it reads:
+//   decoded_decimated_reference_mesh_subdivided.obj  (or decoded_decimated_reference_mesh.obj, subdivided here)
+//   delta_trajectories.bin                           (or delta_trajectories.npy straight from TVMC)
+//   B_matrix.bin / B_matrix.txt
+//   T_matrix.bin / T_matrix.txt
+
+#include "SequenceContainer.h"
+#include "SequenceManifest.h"
+#include "MatrixIO.h"
+#include "MappedFile.h"
+#include "SimpleMeshIO.h"
+#include "TVMLogger.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Minimal .npy reader for 2D float32/float64 arrays
+Eigen::MatrixXd LoadNpy(const std::string& path) {
+    TVMIO::MappedFile file(path);
+    const char* data = file.Data();
+    const size_t size = file.Size();
+    if (size < 10 || std::memcmp(data, "\x93NUMPY", 6) != 0) {
+        throw std::runtime_error("Not a .npy file: " + path);
+    }
+
+    // Version 1 uses a 16 bit header length, later versions 32 bit
+    const uint8_t major = static_cast<uint8_t>(data[6]);
+    size_t headerLength = 0, headerStart = 0;
+    if (major == 1) {
+        headerLength = static_cast<uint8_t>(data[8]) | (static_cast<uint8_t>(data[9]) << 8);
+        headerStart = 10;
+    } else {
+        uint32_t length = 0;
+        std::memcpy(&length, data + 8, sizeof(length));
+        headerLength = length;
+        headerStart = 12;
+    }
+    if (headerStart + headerLength > size) {
+        throw std::runtime_error("Truncated .npy header: " + path);
+    }
+    const std::string header(data + headerStart, headerLength);
+
+    auto valueOf = [&](const std::string& key) {
+        size_t pos = header.find("'" + key + "'");
+        if (pos == std::string::npos) throw std::runtime_error("Missing " + key + " in .npy header: " + path);
+        pos = header.find(':', pos);
+        return header.substr(pos + 1);
+    };
+    const std::string descr = valueOf("descr");
+    const bool isDouble = descr.find("<f8") != std::string::npos;
+    const bool isFloat = descr.find("<f4") != std::string::npos;
+    if (!isDouble && !isFloat) {
+        throw std::runtime_error("Unsupported .npy dtype (expected <f8 or <f4): " + path);
+    }
+    const std::string order = valueOf("fortran_order");
+    const bool fortranOrder = order.compare(order.find_first_not_of(' '), 4, "True") == 0;
+
+    std::string shape = valueOf("shape");
+    shape = shape.substr(shape.find('(') + 1, shape.find(')') - shape.find('(') - 1);
+    long rows = 0, cols = 1;
+    if (std::sscanf(shape.c_str(), "%ld , %ld", &rows, &cols) < 1 || rows <= 0 || cols <= 0) {
+        throw std::runtime_error("Unsupported .npy shape: " + path);
+    }
+
+    const size_t valueSize = isDouble ? sizeof(double) : sizeof(float);
+    const char* payload = data + headerStart + headerLength;
+    if (size - headerStart - headerLength < static_cast<size_t>(rows) * cols * valueSize) {
+        throw std::runtime_error("Truncated .npy payload: " + path);
+    }
+
+    Eigen::MatrixXd mat(rows, cols);
+    for (long r = 0; r < rows; ++r) {
+        for (long c = 0; c < cols; ++c) {
+            const size_t index = fortranOrder ? c * rows + r : r * cols + c;
+            if (isDouble) {
+                std::memcpy(&mat(r, c), payload + index * valueSize, sizeof(double));
+            } else {
+                float value;
+                std::memcpy(&value, payload + index * valueSize, sizeof(float));
+                mat(r, c) = value;
+            }
+        }
+    }
+    return mat;
+}
+
+TVMIO::SubSequenceData LoadSubSequenceFolder(const fs::path& folder) {
+    TVMIO::SubSequenceData sub;
+
+    // Reference mesh, subdividing the decimated mesh when subdivider.py was not run
+    const fs::path subdivided = folder / "decoded_decimated_reference_mesh_subdivided.obj";
+    const fs::path decimated = folder / "decoded_decimated_reference_mesh.obj";
+    if (fs::exists(subdivided)) {
+        if (!SimpleMeshIO::ReadOBJ(subdivided.string(), sub.referenceMesh)) {
+            throw std::runtime_error("Failed to read " + subdivided.string());
+        }
+    } else if (fs::exists(decimated)) {
+        if (!SimpleMeshIO::ReadOBJ(decimated.string(), sub.referenceMesh)) {
+            throw std::runtime_error("Failed to read " + decimated.string());
+        }
+        std::cout << "  Subdividing " << decimated.filename().string() << std::endl;
+        sub.referenceMesh.SubdivideMidpoint();
+    } else {
+        throw std::runtime_error("No reference mesh in " + folder.string());
+    }
+
+    // dHat, straight from TVMC's .npy when no .bin was made
+    const fs::path dHatBin = folder / "delta_trajectories.bin";
+    const fs::path dHatNpy = folder / "delta_trajectories.npy";
+    if (fs::exists(dHatBin)) {
+        sub.dHat = MatrixIO::LoadDeltaTrajectories(dHatBin.string()).Map();
+    } else if (fs::exists(dHatNpy)) {
+        sub.dHat = LoadNpy(dHatNpy.string());
+    } else {
+        throw std::runtime_error("No delta_trajectories in " + folder.string());
+    }
+
+    sub.bMatrix = MatrixIO::LoadMatrix(folder.string(), "B_matrix").Map();
+    sub.tMatrix = MatrixIO::LoadMatrix(folder.string(), "T_matrix").Map();
+
+    // Catch shape mistakes here rather than on device
+    const Eigen::Index vertexCount = static_cast<Eigen::Index>(sub.referenceMesh.vertices.size());
+    if (sub.dHat.rows() < vertexCount || sub.bMatrix.rows() != sub.dHat.cols() ||
+        sub.bMatrix.cols() % 3 != 0 || sub.tMatrix.rows() != 1 || sub.tMatrix.cols() != sub.bMatrix.cols()) {
+        throw std::runtime_error("Inconsistent matrix shapes in " + folder.string());
+    }
+    return sub;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    MatrixIO::EncodeOptions encoding;
+    float frameRate = -1.0f;
+    std::vector<std::string> positional;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--encoding" && i + 1 < argc) {
+                encoding.encoding = MatrixIO::ParseEncoding(argv[++i]);
+            } else if (arg == "--fps" && i + 1 < argc) {
+                frameRate = std::stof(argv[++i]);
+            } else if (arg == "--deflate") {
+                encoding.compression = MatrixIO::MatrixCompression::Deflate;
+            } else {
+                positional.push_back(arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "❌ " << e.what() << std::endl;
+        return 1;
+    }
+    if (positional.size() != 2) {
+        std::cerr << "Usage: " << argv[0] << " [--encoding f64|f32|f16|q16] [--deflate] [--fps <rate>] "
+                  << "<sequence_directory> <output.tvmc>" << std::endl;
+        return 1;
+    }
+    TVMLogger::EnableLogging(false);
+    const fs::path sequenceDirectory(positional[0]);
+    const std::string outputPath = positional[1];
+
+    const fs::path manifestPath = sequenceDirectory / TVMIO::SequenceManifest::kFileName;
+    if (frameRate < 0.0f) {
+        frameRate = 0.0f;
+        if (fs::exists(manifestPath)) {
+            try {
+                frameRate = TVMIO::SequenceManifest::Load(manifestPath.string()).GetFrameRate();
+            } catch (const std::exception& e) {
+                std::cerr << "⚠️  Ignoring " << manifestPath.string() << ": " << e.what() << std::endl;
+            }
+        }
+    }
+
+    // Collect subsequence_XXX folders in playback order
+    std::vector<fs::path> folders;
+    for (const auto& entry : fs::directory_iterator(sequenceDirectory)) {
+        if (entry.is_directory() && entry.path().filename().string().rfind("subsequence_", 0) == 0) {
+            folders.push_back(entry.path());
+        }
+    }
+    auto number = [](const fs::path& p) { return std::atoi(p.filename().string().c_str() + 12); };
+    std::sort(folders.begin(), folders.end(),
+              [&](const fs::path& a, const fs::path& b) { return number(a) < number(b); });
+    if (folders.empty()) {
+        std::cerr << "No subsequence_XXX folders found in " << sequenceDirectory.string() << std::endl;
+        return 1;
+    }
+
+    std::vector<TVMIO::SubSequenceData> subSequences;
+    subSequences.reserve(folders.size());
+    try {
+        for (const auto& folder : folders) {
+            std::cout << "Packing " << folder.filename().string() << std::endl;
+            subSequences.push_back(LoadSubSequenceFolder(folder));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "❌ " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (!TVMIO::SequenceContainer::Write(outputPath, subSequences, encoding, frameRate)) {
+        std::cerr << "❌ Failed to write " << outputPath << std::endl;
+        return 1;
+    }
+    std::cout << "✅ Wrote " << subSequences.size() << " subsequences to " << outputPath
+              << " (" << fs::file_size(outputPath) << " bytes)" << std::endl;
+    return 0;
+}
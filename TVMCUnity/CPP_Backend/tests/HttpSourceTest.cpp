@@ -0,0 +1,133 @@
+// Range, retry and chunked transfer coverage for HttpSource, run against tests/http_stand_in.py:
+//     python tests/http_stand_in.py -- http_source_test
+#include "ByteSource.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            ++g_failures;                                                       \
+        }                                                                       \
+    } while (0)
+
+bool Same(const TVMIO::ByteView& view, const std::vector<char>& data, size_t offset) {
+    return offset <= data.size() && view.size <= data.size() - offset &&
+           std::memcmp(view.data, data.data() + offset, view.size) == 0;
+}
+
+// Size, ranges at the start, middle and end, and the whole file, as served under one mode
+void CheckReads(const std::string& url, const std::vector<char>& data) {
+    TVMIO::HttpSource source(url);
+    CHECK(source.Size() == data.size());
+    const size_t ranges[][2] = {{0, 1}, {0, 4096}, {12345, 20000}, {data.size() - 777, 777}, {data.size() - 1, 1}};
+    for (const auto& range : ranges) {
+        const TVMIO::ByteView view = source.Read(range[0], range[1]);
+        CHECK(view.size == range[1] && Same(view, data, range[0]));
+    }
+    const TVMIO::ByteView all = source.ReadAll();
+    CHECK(all.size == data.size() && Same(all, data, 0));
+    bool threw = false;
+    try {
+        source.Read(data.size() - 10, 20);
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+} // namespace
+
+int main() {
+    const char* base = std::getenv("TVM_TEST_URL");
+    const char* root = std::getenv("TVM_TEST_ROOT");
+    if (!base || !root) {
+        std::printf("Run through http_stand_in.py, TVM_TEST_URL and TVM_TEST_ROOT are not set\n");
+        return 1;
+    }
+
+    std::vector<char> data(100003);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>((i * 2654435761u) >> 13);
+    std::ofstream(std::string(root) + "/data.bin", std::ios::binary).write(data.data(), data.size());
+    const std::string url(base);
+
+    TVMIO::HttpOptions options;
+    options.retryDelayMs = 1;
+    options.timeoutMs = 5000;
+    TVMIO::HttpSource::SetOptions(options);
+
+    CHECK(TVMIO::HttpSource::Exists(url + "plain/data.bin"));
+    CHECK(!TVMIO::HttpSource::Exists(url + "plain/missing.bin"));
+
+    for (const char* mode : {"plain", "norange", "chunked"}) {
+        const int before = g_failures;
+        CheckReads(url + mode + "/data.bin", data);
+        std::printf("%-8s %s\n", mode, g_failures == before ? "ok" : "FAILED");
+    }
+
+    // Each request fails twice (a 503 and a truncated body) and is answered by the third attempt
+    {
+        const TVMIO::HttpStats before = TVMIO::HttpSource::GetStats();
+        TVMIO::HttpSource source(url + "flaky/data.bin");
+        const TVMIO::ByteView view = source.Read(5000, 30000);
+        CHECK(view.size == 30000 && Same(view, data, 5000));
+        const TVMIO::HttpStats after = TVMIO::HttpSource::GetStats();
+        CHECK(after.retries - before.retries == 2);
+        CHECK(after.failures == before.failures);
+        std::printf("flaky    %lld retries\n", static_cast<long long>(after.retries - before.retries));
+    }
+
+    // With fewer retries than failures the error comes through
+    {
+        options.maxRetries = 1;
+        TVMIO::HttpSource::SetOptions(options);
+        const TVMIO::HttpStats before = TVMIO::HttpSource::GetStats();
+        bool threw = false;
+        try {
+            TVMIO::HttpSource(url + "flaky/data.bin").Read(100, 200);
+        } catch (const std::exception&) {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK(TVMIO::HttpSource::GetStats().failures - before.failures == 1);
+        options.maxRetries = 3;
+        TVMIO::HttpSource::SetOptions(options);
+    }
+
+    // A chunk shorter than its size line is rejected instead of shifting the body
+    {
+        bool threw = false;
+        try {
+            TVMIO::HttpSource(url + "badchunk/data.bin").Read(0, 4096);
+        } catch (const std::exception& e) {
+            threw = std::strstr(e.what(), "chunked") != nullptr;
+        }
+        CHECK(threw);
+    }
+
+    // Range responses that are not the range asked for are rejected before their body is taken in
+    const char* const rejections[][2] = {{"shifted", "Content-Range"}, {"oversized", "larger than"}};
+    for (const auto& rejection : rejections) {
+        bool threw = false;
+        try {
+            TVMIO::HttpSource(url + rejection[0] + "/data.bin").Read(1000, 4096);
+        } catch (const std::exception& e) {
+            threw = std::strstr(e.what(), rejection[1]) != nullptr;
+        }
+        CHECK(threw);
+        std::printf("%-8s %s\n", rejection[0], threw ? "rejected" : "FAILED");
+    }
+
+    std::printf("%s\n", g_failures == 0 ? "All HttpSource tests passed" : "HttpSource tests FAILED");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+// Render thread latency under load: the render thread ticks, fetches a frame every 200 us and advances at the end of
+// each subsequence, while two other threads loop LoadSubSequence and DecodeSubSequence over the whole sequence. The
+// p50/p99/max of FetchFrame and AdvanceSubSequence are reported and the test fails when either p99 exceeds the bound.
+//     playback_stress_test [seconds = 3] [p99 bound in us = 500]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The C API the Unity scripts call (TVMDecoder_Extern.cpp)
+extern "C" {
+bool InitializePlaybackManager(const char* path, int memLoad, int decodeLoad, bool enableLogging);
+void DestroyPlaybackManager();
+int Tick();
+bool AdvanceSubSequence();
+void LoadSubSequence(int subSequence);
+void DecodeSubSequence(int subSequence);
+int getSubSequenceCount();
+void FetchFrame(int frameIndex, float* outVertices);
+int GetCurrentDecoderTotalFrames();
+int GetCurrentDecoderVertexCount();
+}
+
+namespace {
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+constexpr int kSubSequences = 6;
+constexpr int kFrames = 10;
+constexpr int kGrid = 24;     // kGrid x kGrid vertices per reference mesh
+constexpr int kAnchors = 40;
+constexpr int kBasis = 4;
+
+// A small encoded sequence: a wavy grid per subsequence, random B/T matrices and anchor trajectories
+void WriteSequence(const fs::path& root) {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    for (int s = 1; s <= kSubSequences; ++s) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "subsequence_%03d", s);
+        const fs::path folder = root / name;
+        fs::create_directories(folder);
+
+        std::vector<double> vertices;
+        std::ofstream obj(folder / "decoded_decimated_reference_mesh_subdivided.obj");
+        for (int j = 0; j < kGrid; ++j) {
+            for (int i = 0; i < kGrid; ++i) {
+                const double x = i / (kGrid - 1.0), y = j / (kGrid - 1.0), z = 0.05 * std::sin(i * 0.3 + s);
+                vertices.insert(vertices.end(), {x, y, z});
+                obj << "v " << x << ' ' << y << ' ' << z << '\n';
+            }
+        }
+        for (int j = 0; j + 1 < kGrid; ++j) {
+            for (int i = 0; i + 1 < kGrid; ++i) {
+                const int a = j * kGrid + i + 1, b = a + 1, c = a + kGrid, d = c + 1;
+                obj << "f " << a << ' ' << b << ' ' << d << "\nf " << a << ' ' << d << ' ' << c << '\n';
+            }
+        }
+
+        // Legacy binary layout: int32 rows and cols, then row-major values. Zero for the vertices, the anchors follow
+        const int vertexCount = kGrid * kGrid;
+        double coefficients[kBasis][3];
+        for (auto& row : coefficients) {
+            for (double& value : row) value = unit(random);
+        }
+        std::vector<double> deltas(static_cast<size_t>(vertexCount) * kBasis, 0.0);
+        for (int a = 0; a < kAnchors; ++a) {
+            const int v = static_cast<int>(std::lround(a * (vertexCount - 1.0) / (kAnchors - 1.0)));
+            for (int k = 0; k < kBasis; ++k) {
+                deltas.push_back(coefficients[k][0] * vertices[v * 3] + coefficients[k][1] * vertices[v * 3 + 1] +
+                                 coefficients[k][2]);
+            }
+        }
+        const int32_t shape[2] = {vertexCount + kAnchors, kBasis};
+        std::ofstream bin(folder / "delta_trajectories.bin", std::ios::binary);
+        bin.write(reinterpret_cast<const char*>(shape), sizeof(shape));
+        bin.write(reinterpret_cast<const char*>(deltas.data()), deltas.size() * sizeof(double));
+
+        std::ofstream bMatrix(folder / "B_matrix.txt");
+        bMatrix.precision(17);
+        for (int k = 0; k < kBasis; ++k) {
+            for (int c = 0; c < 3 * kFrames; ++c) bMatrix << (c ? " " : "") << 0.1 * unit(random);
+            bMatrix << '\n';
+        }
+        std::ofstream tMatrix(folder / "T_matrix.txt");
+        tMatrix.precision(17);
+        for (int c = 0; c < 3 * kFrames; ++c) tMatrix << (c ? " " : "") << unit(random);
+        tMatrix << '\n';
+    }
+}
+
+double Micros(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// Prints the percentiles, returns the p99
+double Report(const char* name, std::vector<double>& samples) {
+    if (samples.empty()) {
+        std::printf("%-8s no samples\n", name);
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    const double p99 = samples[samples.size() * 99 / 100];
+    std::printf("%-8s n=%zu p50 %.1f us p99 %.1f us max %.1f us\n", name, samples.size(), samples[samples.size() / 2],
+                p99, samples.back());
+    return p99;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int seconds = argc > 1 ? std::atoi(argv[1]) : 3;
+    const double boundUs = argc > 2 ? std::atof(argv[2]) : 500.0;
+
+    const fs::path root = fs::temp_directory_path() / ("tvm_stress_" + std::to_string(std::random_device()()));
+    WriteSequence(root);
+    if (!InitializePlaybackManager(root.string().c_str(), 3, 2, false)) {
+        std::printf("Failed to open the generated sequence in %s\n", root.string().c_str());
+        fs::remove_all(root);
+        return 1;
+    }
+    const int count = getSubSequenceCount();
+
+    // Manual loads and decodes race the window's own jobs and the render thread, from both ends of the sequence.
+    // Each decodes what it just loaded, a decode of a subsequence that is not loaded only logs an error
+    std::atomic<bool> stop{false};
+    std::thread forward([&] {
+        for (int s = 1; !stop; s = s % count + 1) {
+            LoadSubSequence(s);
+            DecodeSubSequence(s);
+        }
+    });
+    std::thread backward([&] {
+        for (int s = count; !stop; s = s > 1 ? s - 1 : count) {
+            LoadSubSequence(s);
+            DecodeSubSequence(s);
+        }
+    });
+
+    std::vector<double> fetchUs, advanceUs;
+    std::vector<float> vertices;
+    int frame = 0, advanced = 0, badFrames = 0;
+    for (const auto end = Clock::now() + std::chrono::seconds(seconds); Clock::now() < end;) {
+        Tick();
+        vertices.assign(static_cast<size_t>(GetCurrentDecoderVertexCount()) * 3, NAN);
+        const auto fetchStart = Clock::now();
+        FetchFrame(frame, vertices.data());
+        fetchUs.push_back(Micros(fetchStart));
+        badFrames += std::any_of(vertices.begin(), vertices.end(), [](float v) { return !std::isfinite(v); });
+
+        if (++frame >= GetCurrentDecoderTotalFrames()) {
+            const auto advanceStart = Clock::now();
+            const bool moved = AdvanceSubSequence();
+            advanceUs.push_back(Micros(advanceStart));
+            if (moved) {
+                frame = 0;
+                ++advanced;
+            } else {
+                --frame;  // Not decoded yet, hold the last frame
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    stop = true;
+    forward.join();
+    backward.join();
+    DestroyPlaybackManager();
+    fs::remove_all(root);
+
+    std::printf("advanced %d subsequences, %d bad frames, p99 bound %.0f us\n", advanced, badFrames, boundUs);
+    const double fetchP99 = Report("fetch", fetchUs);
+    const double advanceP99 = Report("advance", advanceUs);
+    const bool passed = advanced > 0 && badFrames == 0 && fetchP99 <= boundUs && advanceP99 <= boundUs;
+    std::printf("%s\n", passed ? "Playback stress test passed" : "Playback stress test FAILED");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+"""
+HTTP stand-in for the streaming tests: serves a temporary folder on a free local port, runs a test command against
+it and exits with the command's exit code.
+
+    python http_stand_in.py -- <test executable> [args...]
+
+The test gets the server URL in TVM_TEST_URL and the served folder in TVM_TEST_ROOT, and writes its files there.
+The first path component picks how a file is served:
+
+    /plain/<file>      Range requests answered with 206
+    /norange/<file>    Range headers ignored, the whole file with 200
+    /chunked/<file>    Transfer-Encoding: chunked, no Content-Length
+    /flaky/<file>      Every distinct request fails twice (503, then a body cut short) before it is answered
+    /badchunk/<file>   A chunked body whose last chunk is shorter than its size line
+    /shifted/<file>    Range responses whose Content-Range and bytes start one byte after the range asked for
+    /oversized/<file>  Range responses that send the whole file after the range's Content-Range
+"""
+import http.server
+import os
+import subprocess
+import sys
+import tempfile
+import threading
+
+CHUNK_SIZE = 1000
+
+
+class StandInHandler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    attempts = {}
+    attempts_lock = threading.Lock()
+
+    def log_message(self, *args):
+        pass
+
+    def _split(self):
+        parts = self.path.lstrip("/").split("/", 1)
+        if len(parts) != 2:
+            return None, None
+        path = os.path.join(self.server.root, parts[1])
+        return parts[0], path if os.path.isfile(path) else None
+
+    def _empty(self, status):
+        self.send_response(status)
+        self.send_header("Content-Length", "0")
+        self.end_headers()
+
+    def _range(self, data):
+        header = self.headers.get("Range")
+        if not header:
+            return None
+        first, last = header.split("=")[1].split("-")
+        return int(first), min(int(last), len(data) - 1)
+
+    def do_HEAD(self):
+        mode, path = self._split()
+        if path is None:
+            return self._empty(404)
+        self.send_response(200)
+        if mode not in ("chunked", "badchunk"):
+            self.send_header("Content-Length", str(os.path.getsize(path)))
+        self.end_headers()
+
+    def do_GET(self):
+        mode, path = self._split()
+        if path is None:
+            return self._empty(404)
+        with open(path, "rb") as f:
+            data = f.read()
+
+        if mode == "flaky":
+            key = (self.path, self.headers.get("Range"))
+            with self.attempts_lock:
+                attempt = self.attempts.get(key, 0)
+                self.attempts[key] = attempt + 1
+            if attempt == 0:
+                return self._empty(503)
+
+        span = self._range(data) if mode != "norange" else None
+        if span is not None and mode == "shifted":
+            span = (span[0] + 1, min(span[1] + 1, len(data) - 1))
+        body = data if span is None else data[span[0]:span[1] + 1]
+        if span is not None and mode == "oversized":
+            body = data
+        if span is not None and span[0] >= len(data):
+            return self._empty(416)
+        self.send_response(200 if span is None else 206)
+        if span is not None:
+            self.send_header("Content-Range", "bytes %d-%d/%d" % (span[0], span[1], len(data)))
+
+        if mode in ("chunked", "badchunk"):
+            self.send_header("Transfer-Encoding", "chunked")
+            self.end_headers()
+            for start in range(0, len(body), CHUNK_SIZE):
+                chunk = body[start:start + CHUNK_SIZE]
+                size = len(chunk) + (1 if mode == "badchunk" and start + CHUNK_SIZE >= len(body) else 0)
+                self.wfile.write(b"%x\r\n" % size + chunk + b"\r\n")
+            self.wfile.write(b"0\r\n\r\n")
+            return
+
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        if mode == "flaky" and attempt == 1:
+            self.wfile.write(body[:len(body) // 2])
+            self.wfile.flush()
+            self.close_connection = True
+            return
+        self.wfile.write(body)
+
+
+def main():
+    if "--" not in sys.argv:
+        sys.exit("usage: http_stand_in.py -- <command> [args...]")
+    command = sys.argv[sys.argv.index("--") + 1:]
+    with tempfile.TemporaryDirectory() as root:
+        server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), StandInHandler)
+        server.daemon_threads = True
+        server.root = root
+        threading.Thread(target=server.serve_forever, daemon=True).start()
+        env = dict(os.environ, TVM_TEST_URL="http://127.0.0.1:%d/" % server.server_address[1], TVM_TEST_ROOT=root)
+        code = subprocess.call(command, env=env)
+        server.shutdown()
+    sys.exit(code)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,72 @@
+import argparse
+import os
+import re
+
+# SequenceSource::kCompleteFileName, live playback only reads subsequence folders that hold it
+COMPLETE_NAME = "segment.complete"
+REQUIRED = ["decoded_decimated_reference_mesh_subdivided.obj"]
+MATRICES = ["delta_trajectories", "B_matrix", "T_matrix"]
+
+
+def is_ready(folder):
+    """Every file the plugin reads is present, in one of the formats it accepts."""
+    if not all(os.path.isfile(os.path.join(folder, name)) for name in REQUIRED):
+        return False
+    for stem in MATRICES:
+        if not any(os.path.isfile(os.path.join(folder, stem + ext)) for ext in (".bin", ".npy", ".txt")):
+            return False
+    return True
+
+
+def mark(folder):
+    # Written under another name and renamed, so the plugin never sees the marker before the folder is flushed
+    marker = os.path.join(folder, COMPLETE_NAME)
+    temporary = marker + ".tmp"
+    with open(temporary, "w") as f:
+        f.flush()
+        os.fsync(f.fileno())
+    os.replace(temporary, marker)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Mark subsequence folders of a live sequence as complete, run it after all of a folder's files are written"
+    )
+    parser.add_argument(
+        "folders", nargs="*",
+        help="The subsequence_XXX folders to mark"
+    )
+    parser.add_argument(
+        "--master_dir", type=str,
+        help="Mark every subsequence_XXX folder of a sequence directory that has all of its files, in order, "
+             "stopping at the first one that does not"
+    )
+    args = parser.parse_args()
+
+    folders = list(args.folders)
+    if args.master_dir:
+        # The plugin expects complete folders to be a prefix of the sequence
+        names = [d for d in os.listdir(args.master_dir)
+                 if re.fullmatch(r"subsequence_\d+", d) and os.path.isdir(os.path.join(args.master_dir, d))]
+        names.sort(key=lambda d: int(d.split("_")[1]))
+        for name in names:
+            folder = os.path.join(args.master_dir, name)
+            if not is_ready(folder):
+                break
+            folders.append(folder)
+    if not folders:
+        print("❌ No subsequence folders to mark")
+        return
+
+    marked = 0
+    for folder in folders:
+        if not is_ready(folder):
+            print(f"❌ {folder} is missing files, not marked")
+            continue
+        mark(folder)
+        marked += 1
+    print(f"✅ Marked {marked} subsequences complete")
+
+
+if __name__ == "__main__":
+    main()
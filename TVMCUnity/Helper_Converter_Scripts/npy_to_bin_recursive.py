@@ -2,8 +2,50 @@ import numpy as np
 import os
 import argparse
 import struct
+import zlib
 
-def convert_npy_to_bin(npy_path, bin_path):
+# TVMM version 2 encodings, see MatrixIO::MatrixEncoding
+ENCODINGS = {"f64": (0, np.float64), "f32": (1, np.float32), "f16": (2, np.float16), "q16": (3, np.int16)}
+
+def write_matrix_bin(f, data, legacy=False, encoding="f64", deflate=False):
+    data = np.ascontiguousarray(data, dtype=np.float64)
+    rows, cols = data.shape
+    if legacy:
+        # Legacy layout: int32 rows, int32 cols, row-major float64 values
+        f.write(struct.pack('ii', rows, cols))
+        data.tofile(f)
+        return
+
+    # Aligned layout: 64 byte "TVMM" header followed by column-major values,
+    # each column padded to a multiple of 64 bytes so it can be memory mapped and used in place
+    code, dtype = ENCODINGS[encoding]
+    per_line = 64 // np.dtype(dtype).itemsize
+    stride = (rows + per_line - 1) // per_line * per_line
+    padded = np.zeros((cols, stride), dtype=dtype)
+    table = b''
+    if encoding == "q16":
+        # Per column quantization: value = offset + scale * q
+        lo, hi = data.min(axis=0), data.max(axis=0)
+        offset, scale = 0.5 * (hi + lo), 0.5 * (hi - lo) / 32767.0
+        safe = np.where(scale > 0, scale, 1.0)
+        q = np.where(scale > 0, np.round((data - offset) / safe), 0)
+        padded[:, :rows] = np.clip(q, -32767, 32767).T
+        table = np.stack([offset, scale], axis=1).astype('<f8').tobytes()
+        table += b'\0' * (-len(table) % 64)
+    else:
+        padded[:, :rows] = data.T
+    payload = table + padded.astype(padded.dtype.newbyteorder('<')).tobytes()
+
+    if encoding == "f64" and not deflate:
+        f.write(struct.pack('<4sIQQQQQ16x', b'TVMM', 1, rows, cols, stride, 64, len(payload)))
+        f.write(payload)
+        return
+    stored = zlib.compress(payload, 6) if deflate else payload
+    f.write(struct.pack('<4sIQQQQQHHIQ', b'TVMM', 2, rows, cols, stride, 64, len(payload),
+                        code, 1 if deflate else 0, 0, len(stored)))
+    f.write(stored)
+
+def convert_npy_to_bin(npy_path, bin_path, legacy=False, encoding="f64", deflate=False):
     if os.path.exists(bin_path):
         print(f"⚠️  Warning: {bin_path} already exists. Skipping...")
         return
@@ -11,21 +53,25 @@ def convert_npy_to_bin(npy_path, bin_path):
     # Load the .npy file
     data = np.load(npy_path)
 
-    # Convert to float64
-    data_f64 = data.astype(np.float64)
-
     # Write to binary file with header
     with open(bin_path, 'wb') as f:
-        # Write dimensions as header (2 int32 values)
-        rows, cols = data_f64.shape
-        header = struct.pack('ii', rows, cols)
-        f.write(header)
-
-        # Write the actual data
-        data_f64.tofile(f)
+        write_matrix_bin(f, data, legacy, encoding, deflate)
 
     print(f"✅ Converted: {npy_path} → {bin_path}")
 
+def convert_txt_to_bin(txt_path, bin_path, legacy=False, encoding="f64", deflate=False):
+    if os.path.exists(bin_path):
+        print(f"⚠️  Warning: {bin_path} already exists. Skipping...")
+        return
+
+    # Load the text matrix, keeping single row files 2D
+    data = np.loadtxt(txt_path, dtype=np.float64, ndmin=2)
+
+    with open(bin_path, 'wb') as f:
+        write_matrix_bin(f, data, legacy, encoding, deflate)
+
+    print(f"✅ Converted: {txt_path} → {bin_path}")
+
 def main():
     parser = argparse.ArgumentParser(
         description="Recursively convert delta_trajectories.npy to delta_trajectories.bin"
@@ -34,13 +80,38 @@ def main():
         "--master_dir", type=str, required=True,
         help="Path to the master directory containing subdirectories"
     )
+    parser.add_argument(
+        "--matrices", action="store_true",
+        help="Also convert B_matrix.txt and T_matrix.txt to binary .bin files (faster to load)"
+    )
+    parser.add_argument(
+        "--legacy", action="store_true",
+        help="Write the old row-major layout instead of the aligned memory mappable layout"
+    )
+    parser.add_argument(
+        "--encoding", choices=sorted(ENCODINGS), default="f64",
+        help="Value encoding for delta_trajectories and B_matrix: f64 (default), f32, f16 or per column int16 (q16)"
+    )
+    parser.add_argument(
+        "--deflate", action="store_true",
+        help="Deflate compress the matrix payloads"
+    )
     args = parser.parse_args()
+    if args.legacy and (args.encoding != "f64" or args.deflate):
+        parser.error("--legacy only supports raw float64")
 
     for root, dirs, files in os.walk(args.master_dir):
         if "delta_trajectories.npy" in files:
             npy_path = os.path.join(root, "delta_trajectories.npy")
             bin_path = os.path.join(root, "delta_trajectories.bin")
-            convert_npy_to_bin(npy_path, bin_path)
+            convert_npy_to_bin(npy_path, bin_path, args.legacy, args.encoding, args.deflate)
+        if args.matrices:
+            for stem in ("B_matrix", "T_matrix"):
+                if f"{stem}.txt" in files:
+                    # T holds the per frame translations and is tiny, keep it exact
+                    encoding = "f64" if stem == "T_matrix" else args.encoding
+                    convert_txt_to_bin(os.path.join(root, f"{stem}.txt"), os.path.join(root, f"{stem}.bin"),
+                                       args.legacy, encoding, args.deflate)
 
 if __name__ == "__main__":
     main()
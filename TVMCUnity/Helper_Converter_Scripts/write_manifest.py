@@ -0,0 +1,101 @@
+import argparse
+import os
+import re
+import struct
+
+import numpy as np
+
+MANIFEST_NAME = "sequence_manifest.txt"
+MESH_NAME = "decoded_decimated_reference_mesh_subdivided.obj"
+
+
+def count_obj(path):
+    # The plugin reads one triangle per face line
+    vertices = triangles = 0
+    with open(path, "r") as f:
+        for line in f:
+            if line.startswith("v "):
+                vertices += 1
+            elif line.startswith("f ") and len(line.split()) >= 4:
+                triangles += 1
+    return vertices, triangles
+
+
+def matrix_shape(folder, stem):
+    """Shape of <stem>.bin (TVMM or legacy layout), <stem>.npy or <stem>.txt, and the path that was read."""
+    bin_path = os.path.join(folder, f"{stem}.bin")
+    if os.path.exists(bin_path):
+        with open(bin_path, "rb") as f:
+            header = f.read(24)
+        if header[:4] == b"TVMM":
+            rows, cols = struct.unpack("<QQ", header[8:24])
+        else:
+            rows, cols = struct.unpack("<ii", header[:8])
+        return (rows, cols), bin_path
+
+    npy_path = os.path.join(folder, f"{stem}.npy")
+    if os.path.exists(npy_path):
+        return np.load(npy_path, mmap_mode="r").shape, npy_path
+
+    txt_path = os.path.join(folder, f"{stem}.txt")
+    if os.path.exists(txt_path):
+        rows, cols = 0, 0
+        with open(txt_path, "r") as f:
+            for line in f:
+                if line.strip():
+                    cols = cols or len(line.split())
+                    rows += 1
+        return (rows, cols), txt_path
+
+    raise FileNotFoundError(f"No {stem}.bin/.npy/.txt in {folder}")
+
+
+def describe_subsequence(root, folder):
+    path = os.path.join(root, folder)
+    mesh_path = os.path.join(path, MESH_NAME)
+    vertices, triangles = count_obj(mesh_path)
+    (_, basis), dhat_path = matrix_shape(path, "delta_trajectories")
+    (_, b_cols), b_path = matrix_shape(path, "B_matrix")
+    _, t_path = matrix_shape(path, "T_matrix")
+    sizes = [os.path.getsize(p) for p in (mesh_path, dhat_path, b_path, t_path)]
+    return [folder, vertices, triangles, b_cols // 3, basis] + sizes
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Write sequence_manifest.txt so the plugin knows the sequence layout before loading any data"
+    )
+    parser.add_argument(
+        "--master_dir", type=str, required=True,
+        help="Path to the sequence directory containing the subsequence_XXX folders"
+    )
+    parser.add_argument(
+        "--fps", type=float, default=30.0,
+        help="Capture frame rate recorded in the manifest (default: 30)"
+    )
+    args = parser.parse_args()
+
+    # Playback order is the numeric subsequence order
+    folders = [d for d in os.listdir(args.master_dir)
+               if re.fullmatch(r"subsequence_\d+", d) and os.path.isdir(os.path.join(args.master_dir, d))]
+    folders.sort(key=lambda d: int(d.split("_")[1]))
+    if not folders:
+        print(f"❌ No subsequence_XXX folders found in {args.master_dir}")
+        return
+
+    manifest_path = os.path.join(args.master_dir, MANIFEST_NAME)
+    with open(manifest_path, "w") as f:
+        f.write("# TVM sequence manifest\n")
+        f.write("version 1\n")
+        f.write(f"fps {args.fps:g}\n")
+        f.write("# subsequence <path> <vertices> <triangles> <frames> <K> "
+                "<mesh bytes> <dHat bytes> <B bytes> <T bytes>\n")
+        for folder in folders:
+            row = describe_subsequence(args.master_dir, folder)
+            f.write("subsequence " + " ".join(str(v) for v in row) + "\n")
+
+    print(f"✅ Wrote {manifest_path} ({len(folders)} subsequences)")
+
+
+if __name__ == "__main__":
+    main()
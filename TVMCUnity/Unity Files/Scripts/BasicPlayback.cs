@@ -10,6 +10,8 @@ public class TestCall : MonoBehaviour
     [SerializeField] private string sequenceDirectory = ""; // Path to directory containing subsequences
     [SerializeField] private int preLoadWindow = 3;
     [SerializeField] private int decodeWindow = 3;
+    [SerializeField] private float adaptiveMargin = 2f; // 0 keeps the windows above fixed
+    [SerializeField] private bool optimizeIndexOrder = true; // Reorder triangles and vertices for the GPU's vertex caches
     [SerializeField] private Material sequenceMat;
     [SerializeField] private bool enableLogging = false;
     private bool playbackManagerReady = false;
@@ -19,12 +21,13 @@ public class TestCall : MonoBehaviour
     private int[] triangleIndices;
     private int currentFrame = 0;
     private Vector3[] vertexArray;
-    public float playbackFPS = 30f;
-    private float playbackTimer = 0f;
+    private float[] frameData;
+    public float playbackFPS = 30f; // 0 plays at the sequence's own rate
+    public float playbackRate = 1f; // Negative plays backwards
+    public bool loop = true;
+    private float appliedRate = 1f;
     private string workingDir;
     private int currentSubsequenceIndex = 1;
-    private int nextToLoad;
-    private int nextToDecode;
 
     
     void Start()
@@ -36,188 +39,93 @@ IEnumerator InitializeSequences()
     string destPath = Path.Combine(Application.persistentDataPath, sequenceDirectory);
     Debug.Log($"[Unity] Looking for sequences at: {destPath}");
 
-    // Check if already exists with valid content
-    if (Directory.Exists(destPath) && Directory.GetDirectories(destPath).Length > 0)
+    // A packed .tvmc container or the sequence .zip are read by the plugin in place, no extraction needed.
+    // Prefer the container, then the zip, then an already extracted folder.
+    // An http:// URL is streamed by the plugin as it plays.
+    string resolvedPath = sequenceDirectory.StartsWith("http://", StringComparison.OrdinalIgnoreCase) ? sequenceDirectory : null;
+    foreach (string fileName in new[] { $"{sequenceDirectory}.tvmc", $"{sequenceDirectory}.zip" })
     {
-        Debug.Log($"[Unity] Sequences already exist at {destPath}, using existing files");
-    }
-    else
-    {
-        Debug.Log($"[Unity] Setting up sequences...");
-        bool success = false;
+        if (resolvedPath != null) break;
+        string sourcePath = Path.Combine(Application.streamingAssetsPath, fileName);
 #if UNITY_ANDROID && !UNITY_EDITOR
-        // Android/Quest implementation
-        string sourcePath = Path.Combine(Application.streamingAssetsPath, $"{sequenceDirectory}.zip");
-        
-        Debug.Log($"[Unity] Loading zip from APK: {sourcePath}");
-        
-        using (UnityWebRequest www = UnityWebRequest.Get(sourcePath))
+        // StreamingAssets live inside the APK on Android, copy the file out once so it can be mapped
+        string localPath = Path.Combine(Application.persistentDataPath, fileName);
+        if (!File.Exists(localPath))
         {
-            yield return www.SendWebRequest();
-            
-            if (www.result == UnityWebRequest.Result.Success)
+            using (UnityWebRequest www = UnityWebRequest.Get(sourcePath))
             {
-                Debug.Log($"[Unity] Zip loaded, extracting...");
-                string tempZip = Path.Combine(Application.persistentDataPath, "temp.zip");
-                File.WriteAllBytes(tempZip, www.downloadHandler.data);
-                
-                try
+                www.downloadHandler = new DownloadHandlerFile(localPath) { removeFileOnAbort = true };
+                yield return www.SendWebRequest();
+                if (www.result != UnityWebRequest.Result.Success)
                 {
-                    System.IO.Compression.ZipFile.ExtractToDirectory(tempZip, Application.persistentDataPath);
-                    File.Delete(tempZip);
-                    
-                    // Check if extraction created the expected folder
-                    if (Directory.Exists(destPath))
-                    {
-                        success = true;
-                        Debug.Log($"[Unity] Successfully extracted to {destPath}");
-                    }
-                    else
-                    {
-                        // Maybe the zip contains "Sequences" but we're looking for "DanceSequence"
-                        string altPath = Path.Combine(Application.persistentDataPath, "Sequences");
-                        if (Directory.Exists(altPath))
-                        {
-                            Directory.Move(altPath, destPath);
-                            success = true;
-                            Debug.Log($"[Unity] Moved Sequences to {destPath}");
-                        }
-                    }
-                }
-                catch (Exception e)
-                {
-                    Debug.LogError($"[Unity] Extraction failed: {e.Message}");
+                    Debug.Log($"[Unity] No {fileName} found in APK");
                 }
             }
-            else
-            {
-                Debug.LogError($"[Unity] Failed to load zip from APK: {www.error}");
-            }
         }
-
 #else
-        string sourcePath = Path.Combine(Application.streamingAssetsPath, $"{sequenceDirectory}.zip");
-        string tempExtractPath = Path.Combine(Application.persistentDataPath, "temp_extract_" + System.Guid.NewGuid().ToString());
-        string tempZip = Path.Combine(Application.persistentDataPath, "temp.zip");
-
-        try
-        {
-            // Clean up destination if it exists
-            if (Directory.Exists(destPath))
-            {
-                Directory.Delete(destPath, true);
-            }
-
-            Debug.Log($"[Unity] Copying zip...");
-            File.Copy(sourcePath, tempZip, true);
-            
-            // Extract to temp location
-            Debug.Log($"[Unity] Extracting to temp location...");
-            Directory.CreateDirectory(tempExtractPath);
-            System.IO.Compression.ZipFile.ExtractToDirectory(tempZip, tempExtractPath);
-            
-            File.Delete(tempZip);
-            
-            // Debug: Show what was extracted
-            Debug.Log($"[Unity] Extracted contents:");
-            foreach (var item in Directory.GetFileSystemEntries(tempExtractPath))
-            {
-                Debug.Log($"  - {Path.GetFileName(item)} ({(Directory.Exists(item) ? "DIR" : "FILE")})");
-            }
-            
-            // Find the actual sequences folder
-            string extractedSequencePath = null;
-            
-            // Check if subsequence_001 exists directly in temp (sequences are loose)
-            if (Directory.Exists(Path.Combine(tempExtractPath, "subsequence_001")))
-            {
-                Debug.Log("[Unity] Found loose subsequences in temp folder");
-                extractedSequencePath = tempExtractPath;
-            }
-            // Check if there's a "Sequences" folder
-            else if (Directory.Exists(Path.Combine(tempExtractPath, "Sequences")))
-            {
-                Debug.Log("[Unity] Found Sequences folder");
-                extractedSequencePath = Path.Combine(tempExtractPath, "Sequences");
-            }
-            // Check if there's a folder matching sequenceDirectory  
-            else if (Directory.Exists(Path.Combine(tempExtractPath, sequenceDirectory)))
-            {
-                Debug.Log($"[Unity] Found {sequenceDirectory} folder");
-                extractedSequencePath = Path.Combine(tempExtractPath, sequenceDirectory);
-            }
-            // Just use the first non-Mac folder we find
-            else
-            {
-                var dirs = Directory.GetDirectories(tempExtractPath);
-                foreach (var dir in dirs)
-                {
-                    if (!dir.Contains("__MACOSX"))
-                    {
-                        Debug.Log($"[Unity] Using first valid folder: {Path.GetFileName(dir)}");
-                        extractedSequencePath = dir;
-                        break;
-                    }
-                }
-            }
-            
-            if (extractedSequencePath != null && Directory.Exists(extractedSequencePath))
-            {
-                Debug.Log($"[Unity] Moving from {extractedSequencePath} to {destPath}");
-                Directory.Move(extractedSequencePath, destPath);
-                success = true;
-            }
-            else
-            {
-                Debug.LogError("[Unity] Could not find valid sequences in extraction");
-            }
-            
-            // Clean up temp directory
-            if (Directory.Exists(tempExtractPath))
-            {
-                Directory.Delete(tempExtractPath, true);
-            }
-        }
-        catch (Exception e)
-        {
-            Debug.LogError($"[Unity] Failed: {e.Message}");
-            success = false;
-        }
+        string localPath = sourcePath;
 #endif
-
-          if (!success)
+        if (File.Exists(localPath))
         {
-            Debug.LogError("[Unity] Failed to set up sequences");
-            yield break;
+            resolvedPath = localPath;
+            break;
         }
+    }
 
-        yield return new WaitForSeconds(0.1f);
+    if (resolvedPath != null)
+    {
+        Debug.Log($"[Unity] Using sequence {resolvedPath}");
+        destPath = resolvedPath;
+    }
+    else if (Directory.Exists(destPath) && Directory.GetDirectories(destPath).Length > 0)
+    {
+        Debug.Log($"[Unity] Sequences already exist at {destPath}, using existing files");
+    }
+    else
+    {
+        Debug.LogError("[Unity] Failed to set up sequences");
+        yield break;
     }
 
     Debug.Log($"[Unity] Initializing PlaybackManager with path: {destPath}");
 
-        if (TVMPlaybackPlugin.InitializePlaybackManager(destPath, preLoadWindow, decodeWindow, enableLogging))
+        TVMPlaybackPlugin.SetOptimizeIndexOrder(optimizeIndexOrder);
+        // Returns right away, the plugin decodes subsequence 1 first and fills the rest of the window behind it
+        if (TVMPlaybackPlugin.InitializePlaybackManagerAsync(destPath, preLoadWindow, decodeWindow, enableLogging))
         {
+            while (TVMPlaybackPlugin.GetInitState() == 0)
+            {
+                TVMPlaybackPlugin.Tick();
+                yield return null;
+            }
+            if (TVMPlaybackPlugin.GetInitState() < 0)
+            {
+                Debug.LogError($"[Unity] Failed to decode sequence at: {destPath}");
+                yield break;
+            }
             SetupMesh();
-            Debug.Log($"[Unity] ✅ Playing sequence 1");
-            nextToLoad = preLoadWindow + 1;
-            nextToDecode = decodeWindow + 1; 
+            Debug.Log($"[Unity] ✅ Playing sequence 1, first frame after {TVMPlaybackPlugin.GetTimeToFirstFrameMs():F0} ms");
+            if (TVMPlaybackPlugin.GetCurrentDecoderAcmr(out float acmrBefore, out float acmrAfter))
+                Debug.Log($"[Unity] Vertex cache miss ratio {acmrBefore:F2} as encoded, {acmrAfter:F2} as drawn");
 
 #if UNITY_ANDROID && !UNITY_EDITOR
-            // On Quest, wait until we have enough buffer before starting playback
+            // On Quest, wait until the whole decode window is buffered before starting playback
             Debug.Log("[Unity] Waiting for buffer to fill on Quest...");
-            
-            // We need at least 2 seconds of buffer (subsequence 1 is ~0.33s at 30fps)
-            // So wait until we're confident subsequence 2 is loaded
-            // Since we can't check directly, use empirical timing
-            yield return new WaitForSeconds(8.0f);  // Adjust based on your Quest loading times
-            playbackManagerReady = true; 
+            while (TVMPlaybackPlugin.GetInitState() == 1)
+            {
+                TVMPlaybackPlugin.Tick();
+                yield return null;
+            }
             Debug.Log("[Unity] Starting playback with buffer");
-#else
-            // PC is fast enough, minimal wait
-            playbackManagerReady = true; 
-            yield return new WaitForSeconds(0.1f);
 #endif
+            // The plugin's clock owns the timing from here, its worker moves the window ahead of the playhead
+            TVMPlaybackPlugin.SetPlaybackFrameRate(playbackFPS);
+            TVMPlaybackPlugin.SetPlaybackRate(playbackRate);
+            TVMPlaybackPlugin.SetLooping(loop);
+            TVMPlaybackPlugin.SetAdaptiveWindow(adaptiveMargin, 0);
+            appliedRate = playbackRate;
+            TVMPlaybackPlugin.Play();
+            playbackManagerReady = true;
         }
         else
         {
@@ -226,96 +134,71 @@ IEnumerator InitializeSequences()
 }
 
 
-    void LoadAsync(int i)
-    {
-        System.Threading.Tasks.Task.Run(() =>
-        {
-            TVMPlaybackPlugin.LoadSubSequence(i);  // Use captured value
-        });
-    }
-
-        void DecodeAsync(int i)
-    {
-        System.Threading.Tasks.Task.Run(() =>
-        {
-            TVMPlaybackPlugin.DecodeSubSequence(i);  // Use captured value
-        });
-    }
-
     void Update()
     {
         if (!playbackManagerReady || totalFrames <= 0)
             return;
 
-        playbackTimer += Time.deltaTime;
-        if (playbackTimer >= 1f / playbackFPS)
+        // The plugin prefetches in the direction of playback and skips subsequences a fast rate outruns
+        if (playbackRate != appliedRate)
         {
-            playbackTimer -= 1f / playbackFPS;
-            currentFrame++;
+            TVMPlaybackPlugin.SetPlaybackRate(playbackRate);
+            appliedRate = playbackRate;
+        }
 
-            // Check if we need to advance subsequence
-            if (currentFrame >= totalFrames)
-            {
-                if (!TVMPlaybackPlugin.AdvanceSubSequence())
-                {
-                    Debug.Log($"[Unity] Waiting...");
-                    return;
-                }
-                currentFrame = 0;
-                SetupMesh();
-                if (currentSubsequenceIndex < TVMPlaybackPlugin.getSubSequenceCount())
-                {
-                    currentSubsequenceIndex++;
-                }
-                else
-                {
-                    currentSubsequenceIndex = 1;
-                }
-                totalFrames = TVMPlaybackPlugin.GetCurrentDecoderTotalFrames();
-                // Load and decode the next subsequences
-                Debug.Log($"[Unity] ✅Playing sequence {currentSubsequenceIndex}");
-                LoadAsync(nextToLoad);
-                if (nextToLoad < TVMPlaybackPlugin.getSubSequenceCount())
-                {
-                    nextToLoad++;
-                }
-                else
-                {
-                    nextToLoad = 1;
-                }
-                DecodeAsync(nextToDecode);
-                if (nextToDecode < TVMPlaybackPlugin.getSubSequenceCount())
-                {
-                    nextToDecode++;
-                }
-                else
-                {
-                    nextToDecode = 1;
-                }
-            }
-            else
-            {
-                UpdateMeshFromDecoder(currentFrame);
-            }
+        // The clock and the window run on the plugin's workers, this only looks up the decoded frame to show
+        TVMPlaybackPlugin.GetFrameForTime(TVMPlaybackPlugin.GetPlaybackTime(), out int subsequence, out int frame);
+        if (subsequence == 0)
+            return;
+        if (subsequence != currentSubsequenceIndex)
+        {
+            currentSubsequenceIndex = subsequence;
+            SetupMesh();
+            currentFrame = 0;
+            Debug.Log($"[Unity] ✅Playing sequence {currentSubsequenceIndex}");
+        }
+        if (frame != currentFrame)
+        {
+            currentFrame = frame;
+            UpdateMeshFromDecoder(currentFrame);
         }
     }
 
+    /// <summary>
+    /// Jump to a frame of the whole sequence, e.g. from a timeline. The clock holds until its subsequence is decoded.
+    /// </summary>
+    public void SeekToFrame(long globalFrame)
+    {
+        float frameRate = playbackFPS > 0f ? playbackFPS : TVMPlaybackPlugin.GetSequenceFrameRate();
+        TVMPlaybackPlugin.SetPlaybackTime(globalFrame / (double)(frameRate > 0f ? frameRate : 30f));
+    }
+
     void SetupMesh()
     {
         totalFrames = TVMPlaybackPlugin.GetCurrentDecoderTotalFrames();
-        vertexCount = TVMPlaybackPlugin.GetCurrentDecoderVertexCount();
+        int newVertexCount = TVMPlaybackPlugin.GetCurrentDecoderVertexCount();
+        // Subsequences often keep the triangle list of the one before, then the mesh only needs the new vertices
+        bool rebuild = meshFilter == null || meshFilter.sharedMesh == null || newVertexCount != vertexCount ||
+                       TVMPlaybackPlugin.TopologyChanged();
+        vertexCount = newVertexCount;
         //Setup the mesh frame 0.
-        float[] baseVerts = new float[vertexCount * 3];
-        TVMPlaybackPlugin.FetchFrame(0, baseVerts);
-        vertexArray = new Vector3[vertexCount];
-        for (int i = 0; i < vertexCount; i++)
+        if (!CopyFrame(0))
+            return;
+
+        if (!rebuild)
         {
-            int idx = i * 3;
-            vertexArray[i] = new Vector3(baseVerts[idx], baseVerts[idx + 1], baseVerts[idx + 2]);
+            Mesh current = meshFilter.sharedMesh;
+            current.vertices = vertexArray;
+            current.RecalculateNormals();
+            current.RecalculateBounds();
+            Debug.Log($"[Unity] Mesh for sequence {currentSubsequenceIndex} reused: topology {TVMPlaybackPlugin.GetCurrentTopologyId()} unchanged, {totalFrames} frames");
+            return;
         }
+
         //Set new values and components for new mesh.
         int triangleCount = TVMPlaybackPlugin.GetCurrentDecoderTriangleIndexCount();
-        triangleIndices = new int[triangleCount];
+        if (triangleIndices == null || triangleIndices.Length != triangleCount)
+            triangleIndices = new int[triangleCount];
         TVMPlaybackPlugin.GetCurrentDecoderTriangleIndices(triangleIndices, triangleCount);
 
         if (meshFilter == null)
@@ -346,15 +229,20 @@ IEnumerator InitializeSequences()
         Debug.Log($"[Unity] Mesh for sequence {currentSubsequenceIndex} setup: {vertexCount} vertices, {triangleCount / 3} triangles, {totalFrames} frames");
     }
 
-    void UpdateMeshFromDecoder(int frame)
+    // Fetch a frame of the current subsequence into vertexArray, both buffers are kept while the vertex count holds
+    bool CopyFrame(int frame)
     {
-        float[] frameData = new float[vertexCount * 3];
+        if (frameData == null || frameData.Length != vertexCount * 3)
+        {
+            frameData = new float[vertexCount * 3];
+            vertexArray = new Vector3[vertexCount];
+        }
         TVMPlaybackPlugin.FetchFrame(frame, frameData);
 
         if (frameData.Length < 3 || float.IsNaN(frameData[0]))
         {
             Debug.LogError("[Unity] Invalid frame data.");
-            return;
+            return false;
         }
 
         for (int i = 0; i < vertexCount; i++)
@@ -362,6 +250,13 @@ IEnumerator InitializeSequences()
             int idx = i * 3;
             vertexArray[i] = new Vector3(frameData[idx], frameData[idx + 1], frameData[idx + 2]);
         }
+        return true;
+    }
+
+    void UpdateMeshFromDecoder(int frame)
+    {
+        if (!CopyFrame(frame))
+            return;
         Mesh mesh = meshFilter.sharedMesh;
         mesh.vertices = vertexArray;
         mesh.RecalculateNormals();
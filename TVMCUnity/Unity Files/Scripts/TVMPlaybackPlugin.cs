@@ -33,6 +33,12 @@ public static class TVMPlaybackPlugin
     [return: MarshalAs(UnmanagedType.I1)]
     public static extern bool AdvanceSubSequence();
 
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void RequestWindow(int subSequence);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int Tick();
+
     [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
     public static extern void LoadSubSequence(int subSequence);
     
@@ -63,4 +69,354 @@ public static class TVMPlaybackPlugin
     [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
     [return: MarshalAs(UnmanagedType.I1)]
     public static extern bool IsPlaybackManagerLoaded();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetMatrixLoadLimits(long maxRows, long maxCols);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool HasSequenceManifest();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetSequenceTotalFrames();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern float GetSequenceFrameRate();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetMaxVertexCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetSubSequenceFrameCount(int subSequence);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetSubSequenceVertexCount(int subSequence);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetSubSequenceTriangleCount(int subSequence);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetSubSequenceByteSize(int subSequence);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetHttpStreamingOptions(int maxConcurrentRequests, int maxRetries, int timeoutMs);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetHttpBytesReceived();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetHttpRetryCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetReadaheadLimit(long maxBytes);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetReadaheadBytesInFlight();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern float GetAverageLoadTimeMs();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern float GetAverageDecodeTimeMs();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetJobWorkerCount(int workers);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetJobQueueDepth();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetRunningJobCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetCancelledJobCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern float GetStageOccupancy(int stage);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetStageQueueDepth(int stage);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetMemoryBudget(long maxBytes);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetMemoryUsage();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetDecodedMemoryUsage();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern float GetCacheHitRate();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool SetSolveCacheDirectory(string directory, long maxBytes);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetSolveCacheHitCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetSolveCacheMissCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetSolveCacheBytes();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int Seek(long globalFrame);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool IsSeekPending();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetCurrentSubSequence();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetSubSequenceStartFrame(int subSequence);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetPlaybackRate(float rate);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern float GetPlaybackRate();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetWindowStep();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetStallCount(float rate);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetTotalStallCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CreatePlaybackInstance(string path, int preLoadWindow, int decodeWindow, bool enableLogging);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void DestroyPlaybackInstance(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetPlaybackInstanceCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int InstanceTick(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool InstanceAdvanceSubSequence(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InstanceRequestWindow(int handle, int subSequence);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int InstanceSeek(int handle, long globalFrame);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool InstanceIsSeekPending(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InstanceSetPlaybackRate(int handle, float rate);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int InstanceGetCurrentSubSequence(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int InstanceGetSubSequenceCount(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InstanceFetchFrame(int handle, int frameIndex, float[] outVertices);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int InstanceGetTotalFrames(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int InstanceGetVertexCount(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int InstanceGetTriangleIndexCount(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InstanceGetTriangleIndices(int handle, int[] outIndices, int maxCount);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InstanceGetReferenceVertices(int handle, float[] outVertices);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long InstanceGetMemoryUsage(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetSharedDecoderCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetSharedDecodeHitCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void Play();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void Pause();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool IsPlaying();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetLooping([MarshalAs(UnmanagedType.I1)] bool loop);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetPlaybackTime(double seconds);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern double GetPlaybackTime();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool IsBuffering();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetPlaybackFrameRate(float frameRate);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool GetFrameForTime(double seconds, out int subSequence, out int frame);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InstancePlay(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InstancePause(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InstanceSetLooping(int handle, [MarshalAs(UnmanagedType.I1)] bool loop);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InstanceSetPlaybackTime(int handle, double seconds);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern double InstanceGetPlaybackTime(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool InstanceGetFrameForTime(int handle, double seconds, out int subSequence, out int frame);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool InitializePlaybackManagerAsync(string path, int preLoadWindow, int decodeWindow, bool enableLogging);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetInitState();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern float GetTimeToFirstFrameMs();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CreatePlaybackInstanceAsync(string path, int preLoadWindow, int decodeWindow, bool enableLogging);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int InstanceGetInitState(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern float InstanceGetTimeToFirstFrameMs(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetAdaptiveWindow(float targetMargin, long maxBytes);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetPreloadWindowSize();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetDecodeWindowSize();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern float GetWindowMargin();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InstanceSetAdaptiveWindow(int handle, float targetMargin, long maxBytes);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int InstanceGetPreloadWindowSize(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int InstanceGetDecodeWindowSize(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern float InstanceGetWindowMargin(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool InitializeLivePlaybackManager(string path, int preLoadWindow, int decodeWindow, float latencySeconds, [MarshalAs(UnmanagedType.I1)] bool enableLogging);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CreateLivePlaybackInstance(string path, int preLoadWindow, int decodeWindow, float latencySeconds, [MarshalAs(UnmanagedType.I1)] bool enableLogging);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool IsLivePlayback();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetLiveLatency(float latencySeconds);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern double GetLiveLatency();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetLiveSkipCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetLivePollInterval(int milliseconds);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InstanceSetLiveLatency(int handle, float latencySeconds);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern double InstanceGetLiveLatency(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetCurrentTopologyId();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool TopologyChanged();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern IntPtr GetCurrentDecoderTriangleIndicesPointer();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void MarkTopologyUploaded();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int GetSharedTopologyCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long GetSharedTopologyHitCount();
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern long InstanceGetTopologyId(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool InstanceTopologyChanged(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern IntPtr InstanceGetTriangleIndicesPointer(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InstanceMarkTopologyUploaded(int handle);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void SetOptimizeIndexOrder([MarshalAs(UnmanagedType.I1)] bool enabled);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool GetIndexOrderAcmr(out float before, out float after);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool GetCurrentDecoderAcmr(out float before, out float after);
+
+    [DllImport(LIB_NAME, CallingConvention = CallingConvention.Cdecl)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    public static extern bool InstanceGetAcmr(int handle, out float before, out float after);
 }
\ No newline at end of file